@@ -323,6 +323,7 @@ set (bscript_sources    # sorted !
   objstrm.cpp
   operator.h
   options.h
+  sortedhashmap.h
   str.cpp 
   str.h
   symcont.cpp
@@ -592,6 +592,8 @@ public:
 
   int value() const { return lval_; }
   int increment() { return ++lval_; }
+  void add( int value ) { lval_ += value; }
+  void setvalue( int value ) { lval_ = value; }
 
 public:  // Class Machinery
   virtual BObjectImp* copy() const override;
@@ -714,6 +716,7 @@ public:
   virtual size_t sizeEstimate() const override;
 
   double value() const { return dval_; }
+  void setvalue( double value ) { dval_ = value; }
   void copyvalue( const Double& dbl ) { dval_ = dbl.dval_; }
   double increment() { return ++dval_; }
 
@@ -25,6 +25,33 @@ namespace Pol
 {
 namespace Bscript
 {
+bool BStructKeyTraits::hash( const Clib::Atom& key, size_t& hash )
+{
+  hash = key.hash();
+  return true;
+}
+
+bool BStructKeyTraits::hash( const Clib::AtomProbe& key, size_t& hash )
+{
+  hash = key.hash();
+  return true;
+}
+
+bool BStructKeyTraits::equal( const Clib::Atom& a, const Clib::Atom& b )
+{
+  return a == b;
+}
+
+bool BStructKeyTraits::equal( const Clib::Atom& a, const Clib::AtomProbe& b )
+{
+  return b.matches( a );
+}
+
+bool BStructKeyTraits::less( const Clib::Atom& a, const Clib::Atom& b )
+{
+  return a.folded() < b.folded();
+}
+
 BStruct::BStruct() : BObjectImp( OTStruct ), contents_() {}
 
 BStruct::BStruct( BObjectType type ) : BObjectImp( type ), contents_() {}
@@ -33,7 +60,7 @@ BStruct::BStruct( const BStruct& other, BObjectType type ) : BObjectImp( type ),
 {
   for ( const auto& elem : other.contents_ )
   {
-    const std::string& key = elem.first;
+    const Clib::Atom& key = elem.first;
     const BObjectRef& bvalref = elem.second;
 
     contents_[key] = BObjectRef( new BObject( bvalref->impref().copy() ) );
@@ -51,7 +78,7 @@ BStruct::BStruct( std::istream& is, unsigned size, BObjectType type )
     {
       String* str = static_cast<String*>( keyimp );
 
-      contents_[str->value()].set( new BObject( valimp ) );
+      contents_[Clib::Atom( str->value() )].set( new BObject( valimp ) );
 
       BObject cleaner( str );
     }
@@ -126,14 +153,14 @@ private:
   BObject m_StructObj;
   BStruct* m_pStruct;
   BObjectRef m_IterVal;
-  std::string key;
+  Clib::Atom key;
   bool m_First;
 };
 BStructIterator::BStructIterator( BStruct* pStruct, BObject* pIterVal )
     : m_StructObj( pStruct ),
       m_pStruct( pStruct ),
       m_IterVal( pIterVal ),
-      key( "" ),
+      key(),
       m_First( true )
 {
 }
@@ -148,22 +175,19 @@ BObject* BStructIterator::step()
 
     m_First = false;
     key = ( *itr ).first;
-    m_IterVal->setimp( new String( key ) );
+    m_IterVal->setimp( new String( key.name() ) );
 
     BObjectRef& oref = ( *itr ).second;
     return oref.get();
   }
   else
   {
-    auto itr = m_pStruct->contents_.find( key );
-    if ( itr == m_pStruct->contents_.end() )
-      return nullptr;
-    ++itr;
+    auto itr = m_pStruct->contents_.next_after( key );
     if ( itr == m_pStruct->contents_.end() )
       return nullptr;
 
     key = ( *itr ).first;
-    m_IterVal->setimp( new String( key ) );
+    m_IterVal->setimp( new String( key.name() ) );
 
     BObjectRef& oref = ( *itr ).second;
     return oref.get();
@@ -177,13 +201,10 @@ ContIterator* BStruct::createIterator( BObject* pIterVal )
 
 size_t BStruct::sizeEstimate() const
 {
-  size_t size = sizeof( BStruct );
+  size_t size = sizeof( BStruct ) - sizeof( Contents ) + contents_.sizeEstimate();
+  // the names are shared with all other atoms of them
   for ( const auto& elem : contents_ )
-  {
-    const std::string& bkey = elem.first;
-    const BObjectRef& bvalref = elem.second;
-    size += bkey.capacity() + bvalref.sizeEstimate() + ( sizeof( void* ) * 3 + 1 ) / 2;
-  }
+    size += elem.second.sizeEstimate();
   return size;
 }
 
@@ -195,14 +216,17 @@ size_t BStruct::mapcount() const
 
 BObjectRef BStruct::set_member( const char* membername, BObjectImp* value, bool copy )
 {
-  std::string key( membername );
+  return set_member( Clib::Atom( membername ), value, copy );
+}
+
+BObjectRef BStruct::set_member( const Clib::Atom& key, BObjectImp* value, bool copy )
+{
   BObjectImp* target = copy ? value->copy() : value;
-  auto itr = contents_.find( key );
-  if ( itr != contents_.end() )
+  BObjectRef* oref = contents_.get( key );
+  if ( oref != nullptr )
   {
-    BObjectRef& oref = ( *itr ).second;
-    oref->setimp( target );
-    return oref;
+    ( *oref )->setimp( target );
+    return *oref;
   }
   else
   {
@@ -215,12 +239,10 @@ BObjectRef BStruct::set_member( const char* membername, BObjectImp* value, bool
 // used programmatically
 const BObjectImp* BStruct::FindMember( const char* name )
 {
-  std::string key( name );
-
-  auto itr = contents_.find( key );
-  if ( itr != contents_.end() )
+  const BObjectRef* oref = contents_.get( Clib::AtomProbe( name ) );
+  if ( oref != nullptr )
   {
-    return ( *itr ).second->impptr();
+    return ( *oref )->impptr();
   }
   else
   {
@@ -230,12 +252,18 @@ const BObjectImp* BStruct::FindMember( const char* name )
 
 BObjectRef BStruct::get_member( const char* membername )
 {
-  std::string key( membername );
+  const BObjectRef* oref = contents_.get( Clib::AtomProbe( membername ) );
+  if ( oref != nullptr )
+    return *oref;
+  return BObjectRef( UninitObject::create() );
+}
 
-  auto itr = contents_.find( key );
-  if ( itr != contents_.end() )
+BObjectRef BStruct::get_member( const Clib::Atom& key )
+{
+  const BObjectRef* oref = contents_.get( key );
+  if ( oref != nullptr )
   {
-    return ( *itr ).second;
+    return *oref;
   }
   else
   {
@@ -249,11 +277,10 @@ BObjectRef BStruct::OperSubscript( const BObject& obj )
   {
     const String* keystr = static_cast<const String*>( obj.impptr() );
 
-    auto itr = contents_.find( keystr->value() );
-    if ( itr != contents_.end() )
+    const BObjectRef* oref = contents_.get( Clib::AtomProbe( keystr->value() ) );
+    if ( oref != nullptr )
     {
-      BObjectRef& oref = ( *itr ).second;
-      return oref;
+      return *oref;
     }
     else
     {
@@ -278,16 +305,15 @@ BObjectImp* BStruct::array_assign( BObjectImp* idx, BObjectImp* target, bool cop
 
     String* keystr = static_cast<String*>( idx );
 
-    auto itr = contents_.find( keystr->value() );
-    if ( itr != contents_.end() )
+    BObjectRef* oref = contents_.get( Clib::AtomProbe( keystr->value() ) );
+    if ( oref != nullptr )
     {
-      BObjectRef& oref = ( *itr ).second;
-      oref->setimp( new_target );
+      ( *oref )->setimp( new_target );
       return new_target;
     }
     else
     {
-      contents_[keystr->value()].set( new BObject( new_target ) );
+      contents_[Clib::Atom( keystr->value() )].set( new BObject( new_target ) );
       return new_target;
     }
   }
@@ -304,14 +330,12 @@ BObjectImp* BStruct::array_assign( BObjectImp* idx, BObjectImp* target, bool cop
 
 void BStruct::addMember( const char* name, BObjectRef val )
 {
-  std::string key( name );
-  contents_[key] = val;
+  contents_[Clib::Atom( name )] = val;
 }
 
 void BStruct::addMember( const char* name, BObjectImp* imp )
 {
-  std::string key( name );
-  contents_[key] = BObjectRef( imp );
+  contents_[Clib::Atom( name )] = BObjectRef( imp );
 }
 
 BObjectImp* BStruct::call_method_id( const int id, Executor& ex, bool /*forcebuiltin*/ )
@@ -332,7 +356,7 @@ BObjectImp* BStruct::call_method_id( const int id, Executor& ex, bool /*forcebui
       if ( !keyobj->isa( OTString ) )
         return new BError( "Struct keys must be strings" );
       String* strkey = static_cast<String*>( keyobj->impptr() );
-      int nremove = static_cast<int>( contents_.erase( strkey->value() ) );
+      int nremove = static_cast<int>( contents_.erase( Clib::AtomProbe( strkey->value() ) ) );
       return new BLong( nremove );
     }
     else
@@ -347,7 +371,8 @@ BObjectImp* BStruct::call_method_id( const int id, Executor& ex, bool /*forcebui
       if ( !keyobj->isa( OTString ) )
         return new BError( "Struct keys must be strings" );
       String* strkey = static_cast<String*>( keyobj->impptr() );
-      contents_[strkey->value()] = BObjectRef( new BObject( valobj->impptr()->copy() ) );
+      contents_[Clib::Atom( strkey->value() )] =
+          BObjectRef( new BObject( valobj->impptr()->copy() ) );
       return new BLong( static_cast<int>( contents_.size() ) );
     }
     else
@@ -361,7 +386,7 @@ BObjectImp* BStruct::call_method_id( const int id, Executor& ex, bool /*forcebui
       if ( !keyobj->isa( OTString ) )
         return new BError( "Struct keys must be strings" );
       String* strkey = static_cast<String*>( keyobj->impptr() );
-      int count = static_cast<int>( contents_.count( strkey->value() ) );
+      int count = static_cast<int>( contents_.count( Clib::AtomProbe( strkey->value() ) ) );
       return new BLong( count );
     }
     else
@@ -375,7 +400,7 @@ BObjectImp* BStruct::call_method_id( const int id, Executor& ex, bool /*forcebui
       std::unique_ptr<ObjArray> arr( new ObjArray );
       for ( const auto& content : contents_ )
       {
-        arr->addElement( new String( content.first ) );
+        arr->addElement( new String( content.first.name() ) );
       }
       return arr.release();
     }
@@ -401,7 +426,7 @@ void BStruct::packonto( std::ostream& os ) const
   os << packtype() << contents_.size() << ":";
   for ( const auto& content : contents_ )
   {
-    const std::string& key = content.first;
+    const std::string& key = content.first.name();
     const BObjectRef& bvalref = content.second;
 
     String::packonto( os, key );
@@ -417,7 +442,7 @@ std::string BStruct::getStringRep() const
 
   for ( const auto& content : contents_ )
   {
-    const std::string& key = content.first;
+    const std::string& key = content.first.name();
     const BObjectRef& bvalref = content.second;
 
     if ( any )
@@ -436,7 +461,11 @@ std::string BStruct::getStringRep() const
 
 BObjectRef BStruct::operDotPlus( const char* name )
 {
-  std::string key( name );
+  return operDotPlus( Clib::Atom( name ) );
+}
+
+BObjectRef BStruct::operDotPlus( const Clib::Atom& key )
+{
   if ( contents_.count( key ) == 0 )
   {
     auto pnewobj = new BObject( new UninitObject );
@@ -451,15 +480,13 @@ BObjectRef BStruct::operDotPlus( const char* name )
 
 BObjectRef BStruct::operDotMinus( const char* name )
 {
-  std::string key( name );
-  contents_.erase( key );
+  contents_.erase( Clib::AtomProbe( name ) );
   return BObjectRef( new BLong( 1 ) );
 }
 
 BObjectRef BStruct::operDotQMark( const char* name )
 {
-  std::string key( name );
-  int count = static_cast<int>( contents_.count( key ) );
+  int count = static_cast<int>( contents_.count( Clib::AtomProbe( name ) ) );
   return BObjectRef( new BLong( count ) );
 }
 
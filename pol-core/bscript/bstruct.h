@@ -14,11 +14,11 @@
 #endif
 
 #include <iosfwd>
-#include <map>
 #include <string>
 
-#include "../clib/maputil.h"
+#include "../clib/atom.h"
 #include "../clib/rawtypes.h"
+#include "sortedhashmap.h"
 
 namespace Pol
 {
@@ -33,6 +33,16 @@ namespace Pol
 {
 namespace Bscript
 {
+// member names are case insensitive atoms, names from strings are looked up with AtomProbe
+struct BStructKeyTraits
+{
+  static bool hash( const Clib::Atom& key, size_t& hash );
+  static bool hash( const Clib::AtomProbe& key, size_t& hash );
+  static bool equal( const Clib::Atom& a, const Clib::Atom& b );
+  static bool equal( const Clib::Atom& a, const Clib::AtomProbe& b );
+  static bool less( const Clib::Atom& a, const Clib::Atom& b );
+};
+
 class BStruct : public BObjectImp
 {
 public:
@@ -45,9 +55,14 @@ public:
 
   const BObjectImp* FindMember( const char* name );
 
+  // member access with the atoms of a program (EScriptProgram::member_atoms)
+  BObjectRef get_member( const Clib::Atom& member );
+  BObjectRef set_member( const Clib::Atom& member, BObjectImp* value, bool copy );
+  BObjectRef operDotPlus( const Clib::Atom& member );
+
   size_t mapcount() const;
 
-  typedef std::map<std::string, BObjectRef, Clib::ci_cmp_pred> Contents;
+  typedef SortedHashMap<Clib::Atom, BObjectRef, BStructKeyTraits> Contents;
   const Contents& contents() const;
 
 protected:
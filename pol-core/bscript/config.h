@@ -13,6 +13,8 @@ namespace Bscript
 struct EScriptConfig
 {
   unsigned int max_call_depth;
+  // execute common instruction sequences as one superinstruction, see Executor::predecode()
+  bool threaded_code;
 };
 
 extern EScriptConfig escript_config;
@@ -9,6 +9,7 @@
 
 #include "dict.h"
 
+#include <functional>
 #include <stddef.h>
 
 #include "../clib/stlutil.h"
@@ -22,6 +23,38 @@ namespace Pol
 {
 namespace Bscript
 {
+bool BDictionaryKeyTraits::hash( const BObject& key, size_t& hash )
+{
+  const BObjectImp* imp = key.impptr();
+  if ( imp->isa( BObjectImp::OTString ) )
+  {
+    hash = std::hash<std::string>()( static_cast<const String*>( imp )->value() );
+    return true;
+  }
+  // integer and real keys compare by value, so both hash the value as double
+  double value;
+  if ( imp->isa( BObjectImp::OTLong ) )
+    value = static_cast<const BLong*>( imp )->value();
+  else if ( imp->isa( BObjectImp::OTDouble ) )
+    value = static_cast<const Double*>( imp )->value();
+  else
+    return false;
+  if ( value == 0.0 )
+    value = 0.0;  // -0.0
+  hash = std::hash<double>()( value );
+  return true;
+}
+
+bool BDictionaryKeyTraits::equal( const BObject& a, const BObject& b )
+{
+  return !( a < b ) && !( b < a );
+}
+
+bool BDictionaryKeyTraits::less( const BObject& a, const BObject& b )
+{
+  return a < b;
+}
+
 BDictionary::BDictionary() : BObjectImp( OTDictionary ), contents_() {}
 
 BDictionary::BDictionary( BObjectType type ) : BObjectImp( type ), contents_() {}
@@ -101,10 +134,7 @@ BObject* BDictionaryIterator::step()
   }
   else
   {
-    auto itr = m_pDict->contents_.find( m_Key );
-    if ( itr == m_pDict->contents_.end() )
-      return nullptr;
-    ++itr;
+    auto itr = m_pDict->contents_.next_after( m_Key );
     if ( itr == m_pDict->contents_.end() )
       return nullptr;
 
@@ -129,12 +159,12 @@ BObjectImp* BDictionary::copy() const
 
 size_t BDictionary::sizeEstimate() const
 {
-  size_t size = sizeof( BDictionary );
+  size_t size = sizeof( BDictionary ) - sizeof( Contents ) + contents_.sizeEstimate();
   for ( const auto& elem : contents_ )
   {
     const BObject& bkeyobj = elem.first;
     const BObjectRef& bvalref = elem.second;
-    size += bkeyobj.sizeEstimate() + bvalref.sizeEstimate() + ( sizeof( void* ) * 3 + 1 ) / 2;
+    size += bkeyobj.sizeEstimate() + bvalref.sizeEstimate();
   }
   return size;
 }
@@ -149,12 +179,11 @@ BObjectRef BDictionary::set_member( const char* membername, BObjectImp* value, b
   BObject key( new String( membername ) );
   BObjectImp* target = copy ? value->copy() : value;
 
-  auto itr = contents_.find( key );
-  if ( itr != contents_.end() )
+  BObjectRef* oref = contents_.get( key );
+  if ( oref != nullptr )
   {
-    BObjectRef& oref = ( *itr ).second;
-    oref->setimp( target );
-    return oref;
+    ( *oref )->setimp( target );
+    return *oref;
   }
   else
   {
@@ -168,10 +197,10 @@ BObjectRef BDictionary::get_member( const char* membername )
 {
   BObject key( new String( membername ) );
 
-  auto itr = contents_.find( key );
-  if ( itr != contents_.end() )
+  const BObjectRef* oref = contents_.get( key );
+  if ( oref != nullptr )
   {
-    return ( *itr ).second;
+    return *oref;
   }
   else
   {
@@ -185,11 +214,10 @@ BObjectRef BDictionary::OperSubscript( const BObject& obj )
   if ( obj->isa( OTString ) || obj->isa( OTLong ) || obj->isa( OTDouble ) ||
        obj->isa( OTApplicObj ) )
   {
-    auto itr = contents_.find( obj );
-    if ( itr != contents_.end() )
+    const BObjectRef* oref = contents_.get( obj );
+    if ( oref != nullptr )
     {
-      BObjectRef& oref = ( *itr ).second;
-      return oref;
+      return *oref;
     }
     else
     {
@@ -210,11 +238,10 @@ BObjectImp* BDictionary::array_assign( BObjectImp* idx, BObjectImp* target, bool
     BObjectImp* new_target = copy ? target->copy() : target;
 
     BObject obj( idx );
-    auto itr = contents_.find( obj );
-    if ( itr != contents_.end() )
+    BObjectRef* oref = contents_.get( obj );
+    if ( oref != nullptr )
     {
-      BObjectRef& oref = ( *itr ).second;
-      oref->setimp( new_target );
+      ( *oref )->setimp( new_target );
       return new_target;
     }
     else
@@ -13,10 +13,10 @@
 #endif
 
 #include <iosfwd>
-#include <map>
 #include <string>
 
 #include "../clib/rawtypes.h"
+#include "sortedhashmap.h"
 
 namespace Pol
 {
@@ -31,6 +31,16 @@ namespace Pol
 {
 namespace Bscript
 {
+// Same key order and equality as BObject::operator<, integer and real keys with the same value
+// are the same key. String and number keys are hashed, all other key types are compared one by
+// one.
+struct BDictionaryKeyTraits
+{
+  static bool hash( const BObject& key, size_t& hash );
+  static bool equal( const BObject& a, const BObject& b );
+  static bool less( const BObject& a, const BObject& b );
+};
+
 class BDictionary final : public BObjectImp
 {
 public:
@@ -43,7 +53,7 @@ public:
   void addMember( BObjectImp* key, BObjectImp* val );
   size_t mapcount() const;
 
-  typedef std::map<BObject, BObjectRef> Contents;
+  typedef SortedHashMap<BObject, BObjectRef, BDictionaryKeyTraits> Contents;
   const Contents& contents() const;
 
 protected:
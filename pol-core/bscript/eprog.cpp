@@ -34,8 +34,13 @@ EScriptProgram::EScriptProgram()
       version( 0 ),
       invocations( 0 ),
       instr_cycles( 0 ),
+      detached_invocations( 0 ),
+      detached_instr_cycles( 0 ),
       pkg( nullptr ),
       instr(),
+      member_atoms(),
+      threaded(),
+      predecoded( false ),
       debug_loaded( false ),
       savecurblock( 0 ),
       curblock( 0 ),
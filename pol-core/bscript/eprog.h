@@ -13,6 +13,7 @@
 #include <string>
 #include <vector>
 
+#include "../clib/atom.h"
 #include "../clib/boostutils.h"
 #include "../clib/rawtypes.h"
 #include "../clib/refptr.h"
@@ -41,6 +42,40 @@ public:
   mutable unsigned int cycles;
 };
 
+// Superinstruction, replaces a common sequence of span instructions starting at the same PC.
+// The operands are decoded once, func runs the whole sequence and falls back to the single
+// instructions if the operands aren't integers.
+struct ThreadedInstruction
+{
+  enum Operand : u8
+  {
+    LOCAL,
+    GLOBAL,
+    CONSTANT
+  };
+  enum Compare : u8
+  {
+    EQ,
+    NE,
+    LT,
+    LE,
+    GT,
+    GE
+  };
+
+  ExecThreadedFunc func;  // nullptr: no superinstruction starts here
+  unsigned span;
+  unsigned left;    // variable index
+  int right;        // variable index or constant
+  unsigned target;  // jump target or variable index to assign
+  Operand left_kind;
+  Operand right_kind;
+  Operand target_kind;
+  Compare compare;
+  bool subtract;  // arithmetic: - instead of +
+  bool jump_if;   // compare: jump if the result equals jump_if
+};
+
 struct EPDbgInstr
 {
   unsigned int blockidx;
@@ -136,8 +171,16 @@ public:
   unsigned short version;
   unsigned int invocations;
   u64 instr_cycles;  // FIXME need an enable-profiling flag
+  // share of the counters above which ran on the worker threads of the detached scripts
+  unsigned int detached_invocations;
+  u64 detached_instr_cycles;
   Plib::Package const* pkg;
   std::vector<Instruction> instr;
+  // member names of the instructions which access members by name, token.lval is the index
+  std::vector<Clib::Atom> member_atoms;
+  // superinstructions per PC, built by the first Executor::setProgram() (empty if disabled)
+  std::vector<ThreadedInstruction> threaded;
+  bool predecoded;
 
   // debug data:
   bool debug_loaded;
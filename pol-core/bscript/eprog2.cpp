@@ -598,6 +598,9 @@ size_t EScriptProgram::sizeEstimate() const
 
 
   size += 3 * sizeof( Instruction* ) + instr.capacity() * sizeof( Instruction );
+  size += 3 * sizeof( Clib::Atom* ) + member_atoms.capacity() * sizeof( Clib::Atom );
+  size += 3 * sizeof( ThreadedInstruction* ) +
+          threaded.capacity() * sizeof( ThreadedInstruction );
 
   size += 3 * sizeof( EPDbgBlock* ) + blocks.capacity() * sizeof( EPDbgBlock );
   size += 3 * sizeof( EPDbgFunction* ) + dbg_functions.capacity() * sizeof( EPDbgFunction );
@@ -153,6 +153,19 @@ int EScriptProgram::create_instructions()
 
     // executor only:
     ins.func = Executor::GetInstrFunc( ins.token );
+    switch ( ins.token.id )
+    {
+    case INS_GET_MEMBER:
+    case INS_SET_MEMBER:
+    case INS_SET_MEMBER_CONSUME:
+    case INS_ADDMEMBER2:
+    case INS_ADDMEMBER_ASSIGN:
+      ins.token.lval = static_cast<int>( member_atoms.size() );
+      member_atoms.emplace_back( ins.token.tokval() );
+      break;
+    default:
+      break;
+    }
   }
   return 0;
 }
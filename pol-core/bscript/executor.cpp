@@ -39,6 +39,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <exception>
+#include <functional>
 #include <numeric>
 
 #ifdef ESCRIPT_PROFILE
@@ -85,6 +86,7 @@ Executor::Executor()
       prog_ok_( false ),
       viewmode_( false ),
       runs_to_completion_( false ),
+      detached_( false ),
       debugging_( false ),
       debug_state_( DEBUG_STATE_NONE ),
       breakpoints_(),
@@ -797,6 +799,9 @@ bool Executor::setProgram( EScriptProgram* i_prog )
     Globals2.back().set( new BObject( UninitObject::create() ) );
   }
 
+  if ( !prog_->predecoded )
+    predecode( *prog_ );
+
   prog_ok_ = true;
   seterror( false );
   ++prog_->invocations;
@@ -1155,7 +1160,12 @@ void Executor::ins_nextfor( const Instruction& ins )
     dbl->increment();
   }
 
-  if ( *end >= *itr )
+  if ( itr->isa( BObjectImp::OTLong ) && end->isa( BObjectImp::OTLong ) )
+  {
+    if ( static_cast<BLong*>( end )->value() >= static_cast<BLong*>( itr )->value() )
+      PC = ins.token.lval;
+  }
+  else if ( *end >= *itr )
   {
     PC = ins.token.lval;
   }
@@ -1384,6 +1394,20 @@ void Executor::ins_consume( const Instruction& /*ins*/ )
   ValueStack.pop_back();
 }
 
+const Clib::Atom& Executor::member_atom( const Instruction& ins ) const
+{
+  return prog_->member_atoms[ins.token.lval];
+}
+
+// struct members are looked up by the atom of the program
+BObjectRef Executor::set_member( BObjectImp& left, const Instruction& ins, BObjectImp* value,
+                                 bool copy )
+{
+  if ( left.isa( BObjectImp::OTStruct ) )
+    return static_cast<BStruct&>( left ).set_member( member_atom( ins ), value, copy );
+  return left.set_member( ins.token.tokval(), value, copy );
+}
+
 void Executor::ins_set_member( const Instruction& ins )
 {
   BObjectRef rightref = ValueStack.back();
@@ -1394,8 +1418,8 @@ void Executor::ins_set_member( const Instruction& ins )
   BObject& left = *leftref;
 
   BObjectImp& rightimpref = right.impref();
-  left.impref().set_member( ins.token.tokval(), &rightimpref,
-                            !( right.count() == 1 && rightimpref.count() == 1 ) );
+  set_member( left.impref(), ins, &rightimpref,
+              !( right.count() == 1 && rightimpref.count() == 1 ) );
 }
 
 void Executor::ins_set_member_id( const Instruction& ins )
@@ -1422,8 +1446,8 @@ void Executor::ins_set_member_consume( const Instruction& ins )
   BObject& left = *leftref;
 
   BObjectImp& rightimpref = right.impref();
-  left.impref().set_member( ins.token.tokval(), &rightimpref,
-                            !( right.count() == 1 && rightimpref.count() == 1 ) );
+  set_member( left.impref(), ins, &rightimpref,
+              !( right.count() == 1 && rightimpref.count() == 1 ) );
   ValueStack.pop_back();
 }
 
@@ -1567,7 +1591,10 @@ void Executor::ins_get_member( const Instruction& ins )
   std::string name( strm.str() );
   unsigned long profile_start = GetTimeUs();
 #endif
-  leftref = left->get_member( ins.token.tokval() );
+  if ( left->isa( BObjectImp::OTStruct ) )
+    leftref = static_cast<BStruct*>( left.impptr() )->get_member( member_atom( ins ) );
+  else
+    leftref = left->get_member( ins.token.tokval() );
 #ifdef ESCRIPT_PROFILE
   profile_escript( name, profile_start );
 #endif
@@ -1739,6 +1766,91 @@ void Executor::ins_array_assign_consume( const Instruction& /*ins*/ )
   ValueStack.pop_back();
 }
 
+// An operand which is referenced only by the value stack (a constant or an intermediate result)
+// takes the result of an arithmetic or compare instruction, instead of a new object.
+static bool is_temporary( const BObjectRef& ref, BObjectImp::BObjectType type )
+{
+  return ref->count() == 1 && ref->impptr()->count() == 1 && ref->impptr()->isa( type );
+}
+
+static void store_result( BObjectRef& leftref, BObjectRef& rightref, int value )
+{
+  if ( is_temporary( leftref, BObjectImp::OTLong ) )
+  {
+    static_cast<BLong*>( leftref->impptr() )->setvalue( value );
+  }
+  else if ( is_temporary( rightref, BObjectImp::OTLong ) )
+  {
+    static_cast<BLong*>( rightref->impptr() )->setvalue( value );
+    leftref = rightref;
+  }
+  else
+    leftref.set( new BObject( new BLong( value ) ) );
+}
+
+static void store_result( BObjectRef& leftref, BObjectRef& rightref, double value )
+{
+  if ( is_temporary( leftref, BObjectImp::OTDouble ) )
+  {
+    static_cast<Double*>( leftref->impptr() )->setvalue( value );
+  }
+  else if ( is_temporary( rightref, BObjectImp::OTDouble ) )
+  {
+    static_cast<Double*>( rightref->impptr() )->setvalue( value );
+    leftref = rightref;
+  }
+  else
+    leftref.set( new BObject( new Double( value ) ) );
+}
+
+// Integer and double operands, same results as BLong/Double::selfPlusObj() & co.
+// Returns false for all other types.
+template <class Op>
+static bool numeric_operation( BObjectRef& leftref, BObjectRef& rightref, Op op )
+{
+  const BObjectImp* left = leftref->impptr();
+  const BObjectImp* right = rightref->impptr();
+  if ( left->isa( BObjectImp::OTLong ) )
+  {
+    int lval = static_cast<const BLong*>( left )->value();
+    if ( right->isa( BObjectImp::OTLong ) )
+      store_result( leftref, rightref, op( lval, static_cast<const BLong*>( right )->value() ) );
+    else if ( right->isa( BObjectImp::OTDouble ) )
+      store_result( leftref, rightref, op( static_cast<double>( lval ),
+                                           static_cast<const Double*>( right )->value() ) );
+    else
+      return false;
+    return true;
+  }
+  if ( left->isa( BObjectImp::OTDouble ) )
+  {
+    double lval = static_cast<const Double*>( left )->value();
+    if ( right->isa( BObjectImp::OTLong ) )
+      store_result( leftref, rightref,
+                    op( lval, double( static_cast<const BLong*>( right )->value() ) ) );
+    else if ( right->isa( BObjectImp::OTDouble ) )
+      store_result( leftref, rightref, op( lval, static_cast<const Double*>( right )->value() ) );
+    else
+      return false;
+    return true;
+  }
+  return false;
+}
+
+// Integer operands only: Double compares with a tolerance, BLong doesn't
+template <class Cmp>
+static bool integer_compare( const BObjectRef& leftref, const BObjectRef& rightref, Cmp cmp,
+                             int& result )
+{
+  const BObjectImp* left = leftref->impptr();
+  const BObjectImp* right = rightref->impptr();
+  if ( !left->isa( BObjectImp::OTLong ) || !right->isa( BObjectImp::OTLong ) )
+    return false;
+  result = cmp( static_cast<const BLong*>( left )->value(),
+                static_cast<const BLong*>( right )->value() );
+  return true;
+}
+
 // TOK_ADD:
 void Executor::ins_add( const Instruction& /*ins*/ )
 {
@@ -1751,6 +1863,9 @@ void Executor::ins_add( const Instruction& /*ins*/ )
   ValueStack.pop_back();
   BObjectRef& leftref = ValueStack.back();
 
+  if ( numeric_operation( leftref, rightref, std::plus<>() ) )
+    return;
+
   BObject& right = *rightref;
   BObject& left = *leftref;
 
@@ -1769,6 +1884,9 @@ void Executor::ins_subtract( const Instruction& /*ins*/ )
   ValueStack.pop_back();
   BObjectRef& leftref = ValueStack.back();
 
+  if ( numeric_operation( leftref, rightref, std::minus<>() ) )
+    return;
+
   BObject& right = *rightref;
   BObject& left = *leftref;
 
@@ -1787,6 +1905,9 @@ void Executor::ins_mult( const Instruction& /*ins*/ )
   ValueStack.pop_back();
   BObjectRef& leftref = ValueStack.back();
 
+  if ( numeric_operation( leftref, rightref, std::multiplies<>() ) )
+    return;
+
   BObject& right = *rightref;
   BObject& left = *leftref;
 
@@ -1958,11 +2079,10 @@ void Executor::ins_notequal( const Instruction& /*ins*/ )
   ValueStack.pop_back();
   BObjectRef& leftref = ValueStack.back();
 
-  BObject& right = *rightref;
-  BObject& left = *leftref;
-
-  int _true = ( left != right );
-  leftref.set( new BObject( new BLong( _true ) ) );
+  int _true;
+  if ( !integer_compare( leftref, rightref, std::not_equal_to<>(), _true ) )
+    _true = ( *leftref != *rightref );
+  store_result( leftref, rightref, _true );
 }
 
 void Executor::ins_equal( const Instruction& /*ins*/ )
@@ -1976,11 +2096,10 @@ void Executor::ins_equal( const Instruction& /*ins*/ )
   ValueStack.pop_back();
   BObjectRef& leftref = ValueStack.back();
 
-  BObject& right = *rightref;
-  BObject& left = *leftref;
-
-  int _true = ( left == right );
-  leftref.set( new BObject( new BLong( _true ) ) );
+  int _true;
+  if ( !integer_compare( leftref, rightref, std::equal_to<>(), _true ) )
+    _true = ( *leftref == *rightref );
+  store_result( leftref, rightref, _true );
 }
 
 void Executor::ins_lessthan( const Instruction& /*ins*/ )
@@ -1994,11 +2113,10 @@ void Executor::ins_lessthan( const Instruction& /*ins*/ )
   ValueStack.pop_back();
   BObjectRef& leftref = ValueStack.back();
 
-  BObject& right = *rightref;
-  BObject& left = *leftref;
-
-  int _true = ( left < right );
-  leftref.set( new BObject( new BLong( _true ) ) );
+  int _true;
+  if ( !integer_compare( leftref, rightref, std::less<>(), _true ) )
+    _true = ( *leftref < *rightref );
+  store_result( leftref, rightref, _true );
 }
 
 void Executor::ins_lessequal( const Instruction& /*ins*/ )
@@ -2012,10 +2130,10 @@ void Executor::ins_lessequal( const Instruction& /*ins*/ )
   ValueStack.pop_back();
   BObjectRef& leftref = ValueStack.back();
 
-  BObject& right = *rightref;
-  BObject& left = *leftref;
-  int _true = ( left <= right );
-  leftref.set( new BObject( new BLong( _true ) ) );
+  int _true;
+  if ( !integer_compare( leftref, rightref, std::less_equal<>(), _true ) )
+    _true = ( *leftref <= *rightref );
+  store_result( leftref, rightref, _true );
 }
 void Executor::ins_greaterthan( const Instruction& /*ins*/ )
 {
@@ -2028,11 +2146,10 @@ void Executor::ins_greaterthan( const Instruction& /*ins*/ )
   ValueStack.pop_back();
   BObjectRef& leftref = ValueStack.back();
 
-  BObject& right = *rightref;
-  BObject& left = *leftref;
-
-  int _true = ( left > right );
-  leftref.set( new BObject( new BLong( _true ) ) );
+  int _true;
+  if ( !integer_compare( leftref, rightref, std::greater<>(), _true ) )
+    _true = ( *leftref > *rightref );
+  store_result( leftref, rightref, _true );
 }
 void Executor::ins_greaterequal( const Instruction& /*ins*/ )
 {
@@ -2045,11 +2162,10 @@ void Executor::ins_greaterequal( const Instruction& /*ins*/ )
   ValueStack.pop_back();
   BObjectRef& leftref = ValueStack.back();
 
-  BObject& right = *rightref;
-  BObject& left = *leftref;
-
-  int _true = ( left >= right );
-  leftref.set( new BObject( new BLong( _true ) ) );
+  int _true;
+  if ( !integer_compare( leftref, rightref, std::greater_equal<>(), _true ) )
+    _true = ( *leftref >= *rightref );
+  store_result( leftref, rightref, _true );
 }
 
 // case TOK_ARRAY_SUBSCRIPT:
@@ -2147,13 +2263,20 @@ void Executor::ins_checkmember( const Instruction& /*ins*/ )
   leftref = checkmember( left, right );
 }
 
+BObjectRef Executor::add_member( BObjectImp& obj, const Instruction& ins )
+{
+  if ( obj.isa( BObjectImp::OTStruct ) )
+    return static_cast<BStruct&>( obj ).operDotPlus( member_atom( ins ) );
+  return obj.operDotPlus( ins.token.tokval() );
+}
+
 void Executor::ins_addmember2( const Instruction& ins )
 {
   BObjectRef obref = ValueStack.back();
 
   BObject& ob = *obref;
 
-  ob.impref().operDotPlus( ins.token.tokval() );
+  add_member( ob.impref(), ins );
 }
 
 void Executor::ins_addmember_assign( const Instruction& ins )
@@ -2167,7 +2290,7 @@ void Executor::ins_addmember_assign( const Instruction& ins )
   BObjectRef obref = ValueStack.back();
   BObject& ob = *obref;
 
-  BObjectRef memref = ob.impref().operDotPlus( ins.token.tokval() );
+  BObjectRef memref = add_member( ob.impref(), ins );
   BObject& mem = *memref;
 
   if ( valob.count() == 1 && valimp->count() == 1 )
@@ -2980,6 +3103,199 @@ ExecInstrFunc Executor::GetInstrFunc( const Token& token )
   }
 }
 
+static bool decode_compare( ExecInstrFunc func, ThreadedInstruction::Compare& compare )
+{
+  if ( func == &Executor::ins_equal )
+    compare = ThreadedInstruction::EQ;
+  else if ( func == &Executor::ins_notequal )
+    compare = ThreadedInstruction::NE;
+  else if ( func == &Executor::ins_lessthan )
+    compare = ThreadedInstruction::LT;
+  else if ( func == &Executor::ins_lessequal )
+    compare = ThreadedInstruction::LE;
+  else if ( func == &Executor::ins_greaterthan )
+    compare = ThreadedInstruction::GT;
+  else if ( func == &Executor::ins_greaterequal )
+    compare = ThreadedInstruction::GE;
+  else
+    return false;
+  return true;
+}
+
+static bool decode_variable( const Instruction& ins, ThreadedInstruction::Operand& kind )
+{
+  if ( ins.func == &Executor::ins_localvar )
+    kind = ThreadedInstruction::LOCAL;
+  else if ( ins.func == &Executor::ins_globalvar )
+    kind = ThreadedInstruction::GLOBAL;
+  else
+    return false;
+  return true;
+}
+
+// Builds the superinstructions of a program, for the most common sequences of loops and counters
+// (var: local or global variable):
+//   var, var|long, compare, jmpiffalse|jmpiftrue     ( while i < max )
+//   var, var|long, +|-, assign var                    ( i := i + 1 )
+//   var, var|long, +=|-=, consume                     ( i += 1; )
+// The single instructions stay as they are, a jump into the middle of a sequence executes the
+// rest of it instruction by instruction. Without any match prog.threaded stays empty.
+void Executor::predecode( EScriptProgram& prog )
+{
+  prog.predecoded = true;
+  prog.threaded.clear();
+  if ( !escript_config.threaded_code )
+    return;
+
+  const std::vector<Instruction>& instr = prog.instr;
+  std::vector<ThreadedInstruction> threaded( instr.size() );
+  bool found = false;
+  for ( size_t i = 0; i + 3 < instr.size(); ++i )
+  {
+    const Instruction& first = instr[i];
+    const Instruction& second = instr[i + 1];
+    const ExecInstrFunc op = instr[i + 2].func;
+    const Instruction& last = instr[i + 3];
+
+    ThreadedInstruction thr = ThreadedInstruction();
+    if ( !decode_variable( first, thr.left_kind ) )
+      continue;
+    if ( second.func == &Executor::ins_long )
+      thr.right_kind = ThreadedInstruction::CONSTANT;
+    else if ( !decode_variable( second, thr.right_kind ) )
+      continue;
+    thr.span = 4;
+    thr.left = static_cast<unsigned>( first.token.lval );
+    thr.right = second.token.lval;
+    thr.target = static_cast<unsigned>( last.token.lval );
+
+    if ( last.func == &Executor::ins_jmpiffalse || last.func == &Executor::ins_jmpiftrue )
+    {
+      if ( !decode_compare( op, thr.compare ) )
+        continue;
+      thr.func = &Executor::thr_compare_jump;
+      thr.jump_if = ( last.func == &Executor::ins_jmpiftrue );
+    }
+    else if ( last.func == &Executor::ins_assign_localvar ||
+              last.func == &Executor::ins_assign_globalvar )
+    {
+      if ( op != &Executor::ins_add && op != &Executor::ins_subtract )
+        continue;
+      thr.func = &Executor::thr_arith_assign;
+      thr.target_kind = ( last.func == &Executor::ins_assign_globalvar )
+                            ? ThreadedInstruction::GLOBAL
+                            : ThreadedInstruction::LOCAL;
+      thr.subtract = ( op == &Executor::ins_subtract );
+    }
+    else if ( last.func == &Executor::ins_consume )
+    {
+      if ( op != &Executor::ins_plusequal && op != &Executor::ins_minusequal )
+        continue;
+      thr.func = &Executor::thr_arith_equal;
+      thr.subtract = ( op == &Executor::ins_minusequal );
+    }
+    else
+      continue;
+    threaded[i] = thr;
+    found = true;
+  }
+  if ( found )
+    prog.threaded.swap( threaded );
+}
+
+BObjectRef& Executor::thr_variable( ThreadedInstruction::Operand kind, unsigned idx )
+{
+  return kind == ThreadedInstruction::GLOBAL ? Globals2[idx] : ( *Locals2 )[idx];
+}
+
+// The operands of the superinstructions are integers in nearly all cases, for everything else
+// the single instructions get executed. PC is already behind the sequence.
+bool Executor::thr_operands( const ThreadedInstruction& thr, int& lval, int& rval )
+{
+  BObjectImp* left = thr_variable( thr.left_kind, thr.left )->impptr();
+  if ( !left->isa( BObjectImp::OTLong ) )
+    return false;
+  lval = static_cast<BLong*>( left )->value();
+  if ( thr.right_kind == ThreadedInstruction::CONSTANT )
+  {
+    rval = thr.right;
+    return true;
+  }
+  BObjectImp* right = thr_variable( thr.right_kind, thr.right )->impptr();
+  if ( !right->isa( BObjectImp::OTLong ) )
+    return false;
+  rval = static_cast<BLong*>( right )->value();
+  return true;
+}
+
+void Executor::thr_reference( const ThreadedInstruction& thr )
+{
+  PC -= thr.span;
+  for ( unsigned i = 0; i < thr.span && run_ok_; ++i )
+  {
+    const Instruction& ins = prog_->instr[PC];
+    ++PC;
+    ( this->*( ins.func ) )( ins );
+  }
+}
+
+void Executor::thr_compare_jump( const ThreadedInstruction& thr )
+{
+  int lval, rval;
+  if ( !thr_operands( thr, lval, rval ) )
+    return thr_reference( thr );
+
+  bool result;
+  switch ( thr.compare )
+  {
+  case ThreadedInstruction::EQ:
+    result = lval == rval;
+    break;
+  case ThreadedInstruction::NE:
+    result = lval != rval;
+    break;
+  case ThreadedInstruction::LT:
+    result = lval < rval;
+    break;
+  case ThreadedInstruction::LE:
+    result = lval <= rval;
+    break;
+  case ThreadedInstruction::GT:
+    result = lval > rval;
+    break;
+  default:
+    result = lval >= rval;
+    break;
+  }
+  if ( result == thr.jump_if )
+    PC = thr.target;
+}
+
+void Executor::thr_arith_assign( const ThreadedInstruction& thr )
+{
+  int lval, rval;
+  if ( !thr_operands( thr, lval, rval ) )
+    return thr_reference( thr );
+
+  int result = thr.subtract ? lval - rval : lval + rval;
+  BObject& var = *thr_variable( thr.target_kind, thr.target );
+  if ( var.isa( BObjectImp::OTLong ) && var.impptr()->count() == 1 )
+    static_cast<BLong*>( var.impptr() )->setvalue( result );
+  else
+    var.setimp( new BLong( result ) );
+}
+
+void Executor::thr_arith_equal( const ThreadedInstruction& thr )
+{
+  int lval, rval;
+  if ( !thr_operands( thr, lval, rval ) )
+    return thr_reference( thr );
+
+  // same as BLong += BLong, the value changes in place
+  BLong& left = static_cast<BLong&>( thr_variable( thr.left_kind, thr.left )->impref() );
+  left.add( thr.subtract ? -rval : rval );
+}
+
 void Executor::execInstr()
 {
   unsigned onPC = PC;
@@ -3067,9 +3383,32 @@ void Executor::execInstr()
       bp_skip_ = ~0u;
     }
 
-    ++ins.cycles;
-    ++prog_->instr_cycles;
-    ++escript_instr_cycles;
+    if ( !prog_->threaded.empty() && !debugging_ && debug_level < INSTRUCTIONS )
+    {
+      const ThreadedInstruction& thr = prog_->threaded[PC];
+      if ( thr.func != nullptr )
+      {
+        if ( !detached_ )
+        {
+          for ( unsigned i = 0; i < thr.span; ++i )
+            ++prog_->instr[PC + i].cycles;
+          prog_->instr_cycles += thr.span;
+          escript_instr_cycles += thr.span;
+        }
+
+        PC += thr.span;
+
+        ( this->*( thr.func ) )( thr );
+        return;
+      }
+    }
+
+    if ( !detached_ )
+    {
+      ++ins.cycles;
+      ++prog_->instr_cycles;
+      ++escript_instr_cycles;
+    }
 
     ++PC;
 
@@ -3365,6 +3704,8 @@ bool Executor::builtinMethodForced( const char*& methodname )
 #ifdef ESCRIPT_PROFILE
 void Executor::profile_escript( std::string name, unsigned long profile_start )
 {
+  if ( detached_ )
+    return;  // EscriptProfileMap is shared
   unsigned long profile_end = GetTimeUs() - profile_start;
   escript_profile_map::iterator itr = EscriptProfileMap.find( name );
   if ( itr != EscriptProfileMap.end() )
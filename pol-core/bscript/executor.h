@@ -353,12 +353,30 @@ public:
 
   void ins_funcref( const Instruction& ins );
 
+  // superinstructions, see predecode()
+  static void predecode( EScriptProgram& prog );
+  void thr_compare_jump( const ThreadedInstruction& thr );
+  void thr_arith_assign( const ThreadedInstruction& thr );
+  void thr_arith_equal( const ThreadedInstruction& thr );
+  void thr_reference( const ThreadedInstruction& thr );
+  BObjectRef& thr_variable( ThreadedInstruction::Operand kind, unsigned idx );
+  bool thr_operands( const ThreadedInstruction& thr, int& lval, int& rval );
+
+  // member access by name, with the atoms of EScriptProgram::member_atoms for structs
+  const Clib::Atom& member_atom( const Instruction& ins ) const;
+  BObjectRef set_member( BObjectImp& left, const Instruction& ins, BObjectImp* value, bool copy );
+  BObjectRef add_member( BObjectImp& obj, const Instruction& ins );
+
   static int ins_casejmp_findlong( const Token& token, BLong* blong );
   static int ins_casejmp_findstring( const Token& token, String* bstringimp );
   static int ins_casejmp_finddefault( const Token& token );
 
   bool running_to_completion() const;
   void set_running_to_completion( bool to_completion );
+  // runs without the world lock: doesn't count into the cycles of the program and
+  // escript_instr_cycles, which other executors share
+  bool detached() const;
+  void set_detached( bool detached );
 
   bool runnable() const;
   void calcrunnable();
@@ -400,6 +418,7 @@ private:
   bool viewmode_;
 
   bool runs_to_completion_;
+  bool detached_;
 
   bool debugging_;
   enum DEBUG_STATE
@@ -494,6 +513,14 @@ inline void Executor::set_running_to_completion( bool to_completion )
 {
   runs_to_completion_ = to_completion;
 }
+inline bool Executor::detached() const
+{
+  return detached_;
+}
+inline void Executor::set_detached( bool detached )
+{
+  detached_ = detached;
+}
 }  // namespace Bscript
 }  // namespace Pol
 #endif
@@ -12,8 +12,10 @@ namespace Bscript
 {
 class Executor;
 class Instruction;
+struct ThreadedInstruction;
 
 typedef void ( Executor::*ExecInstrFunc )( const Instruction& );
+typedef void ( Executor::*ExecThreadedFunc )( const ThreadedInstruction& );
 }
 }
 #endif
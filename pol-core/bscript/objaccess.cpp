@@ -452,6 +452,14 @@ ObjMethod object_methods[] = {
     { MTH_CALL, "call", false },
     { MTH_SORTEDINSERT, "sorted_insert", false },
     { MTH_SETUTF8STRING, "setutf8string", false },
+    { MTH_FINDELEMENTS, "findelements", false },  // 155
+    { MTH_ELEMENTSINRANGE, "elementsinrange", false },
+    { MTH_ELEMENTSWITHPREFIX, "elementswithprefix", false },
+    { MTH_GETPROPS, "getprops", false },
+    { MTH_SETPROPS, "setprops", false },
+    { MTH_CREATEINDEX, "createindex", false },  // 160
+    { MTH_DELETEINDEX, "deleteindex", false },
+    { MTH_FINDBYINDEX, "findbyindex", false },
 };
 int n_objmethods = sizeof object_methods / sizeof object_methods[0];
 ObjMethod* getKnownObjMethod( const char* token )
@@ -181,6 +181,14 @@ enum MethodID
   MTH_CALL,
   MTH_SORTEDINSERT,
   MTH_SETUTF8STRING,
+  MTH_FINDELEMENTS,  // 155
+  MTH_ELEMENTSINRANGE,
+  MTH_ELEMENTSWITHPREFIX,
+  MTH_GETPROPS,
+  MTH_SETPROPS,
+  MTH_CREATEINDEX,  // 160
+  MTH_DELETEINDEX,
+  MTH_FINDBYINDEX,
 };
 
 
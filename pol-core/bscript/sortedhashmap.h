@@ -0,0 +1,330 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef BSCRIPT_SORTEDHASHMAP_H
+#define BSCRIPT_SORTEDHASHMAP_H
+
+#include <algorithm>
+#include <boost/container/small_vector.hpp>
+#include <stddef.h>
+#include <utility>
+#include <vector>
+
+#include "../clib/rawtypes.h"
+
+namespace Pol
+{
+namespace Bscript
+{
+// Map with hash lookups which iterates in key order, used for the members of structs and
+// dictionaries.
+// The entries are stored in insertion order in one array, the first few of them inline. Once
+// there are more than SMALL_SIZE entries, lookups go through an open addressed index of the
+// precomputed hashes, before that they compare the hashes one by one.
+// The key order is an array of entry indexes, entries inserted since the last iteration get
+// merged into it when iterating the next time. Erased entries stay as holes (skipped by the
+// iterators) until they are half of the array.
+//
+// Traits:
+//   static bool hash( const Key&, size_t& hash ); false if the key type can't be hashed, these
+//                                                 keys are compared with all other unhashed ones
+//   static bool equal( const Key&, const Key& );
+//   static bool less( const Key&, const Key& );
+// get/count/erase also take other types as key, if the traits have hash( const Other&, size_t& )
+// and equal( const Key&, const Other& ) for them.
+template <class Key, class Value, class Traits>
+class SortedHashMap
+{
+public:
+  typedef std::pair<Key, Value> value_type;
+  static const size_t SMALL_SIZE = 8;
+  static const size_t INLINE_SIZE = 4;
+
+private:
+  struct Entry
+  {
+    Entry( const Key& key, size_t keyhash, bool is_hashed )
+        : kv( key, Value() ), hash( keyhash ), hashed( is_hashed ), live( true )
+    {
+    }
+    value_type kv;
+    size_t hash;
+    bool hashed;
+    bool live;
+  };
+  static const size_t npos = ~static_cast<size_t>( 0 );
+
+  template <class MapT, class ValueT>
+  class iterator_base
+  {
+  public:
+    iterator_base() : map_( nullptr ), pos_( 0 ) {}
+    iterator_base( MapT* map, size_t pos ) : map_( map ), pos_( pos ) { skip(); }
+    ValueT& operator*() const { return map_->entries_[map_->order_[pos_]].kv; }
+    ValueT* operator->() const { return &map_->entries_[map_->order_[pos_]].kv; }
+    iterator_base& operator++()
+    {
+      ++pos_;
+      skip();
+      return *this;
+    }
+    bool operator==( const iterator_base& other ) const { return pos_ == other.pos_; }
+    bool operator!=( const iterator_base& other ) const { return pos_ != other.pos_; }
+
+  private:
+    void skip()
+    {
+      while ( pos_ < map_->order_.size() && !map_->entries_[map_->order_[pos_]].live )
+        ++pos_;
+    }
+    MapT* map_;
+    size_t pos_;
+  };
+
+public:
+  typedef iterator_base<SortedHashMap, value_type> iterator;
+  typedef iterator_base<const SortedHashMap, const value_type> const_iterator;
+
+  SortedHashMap() : entries_(), index_(), order_(), sorted_( 0 ), live_( 0 ) {}
+
+  size_t size() const { return live_; }
+  bool empty() const { return live_ == 0; }
+
+  iterator begin()
+  {
+    sort();
+    return iterator( this, 0 );
+  }
+  iterator end() { return iterator( this, order_.size() ); }
+  const_iterator begin() const
+  {
+    sort();
+    return const_iterator( this, 0 );
+  }
+  const_iterator end() const { return const_iterator( this, order_.size() ); }
+
+  // nullptr if there's no such key
+  template <class K>
+  Value* get( const K& key )
+  {
+    size_t idx = find_entry( key );
+    return idx != npos ? &entries_[idx].kv.second : nullptr;
+  }
+  template <class K>
+  const Value* get( const K& key ) const
+  {
+    size_t idx = find_entry( key );
+    return idx != npos ? &entries_[idx].kv.second : nullptr;
+  }
+  template <class K>
+  size_t count( const K& key ) const
+  {
+    return find_entry( key ) != npos ? 1 : 0;
+  }
+
+  // inserts a default constructed value if there's no such key
+  Value& operator[]( const Key& key )
+  {
+    size_t hash = 0;
+    bool hashed = Traits::hash( key, hash );
+    size_t idx = find_entry( key, hash, hashed );
+    if ( idx == npos )
+      idx = insert_entry( key, hash, hashed );
+    return entries_[idx].kv.second;
+  }
+
+  template <class K>
+  size_t erase( const K& key )
+  {
+    size_t idx = find_entry( key );
+    if ( idx == npos )
+      return 0;
+    Entry& entry = entries_[idx];
+    entry.live = false;
+    entry.kv.second = Value();
+    --live_;
+    size_t dead = entries_.size() - live_;
+    if ( dead > SMALL_SIZE && dead * 2 > entries_.size() )
+      compact();
+    return 1;
+  }
+
+  void clear()
+  {
+    entries_.clear();
+    index_.clear();
+    order_.clear();
+    sorted_ = 0;
+    live_ = 0;
+  }
+
+  // position after the given key in key order, end() if there's no such key
+  iterator next_after( const Key& key )
+  {
+    size_t idx = find_entry( key );
+    if ( idx == npos )
+      return end();
+    sort();
+    auto range = std::equal_range( order_.begin(), order_.end(), static_cast<u32>( idx ),
+                                   OrderLess( this ) );
+    auto itr = std::find( range.first, range.second, static_cast<u32>( idx ) );
+    return iterator( this, static_cast<size_t>( itr - order_.begin() ) + 1 );
+  }
+
+  size_t sizeEstimate() const
+  {
+    size_t size = sizeof( *this ) + index_.capacity() * sizeof( u32 ) +
+                  order_.capacity() * sizeof( u32 );
+    if ( entries_.capacity() > INLINE_SIZE )
+      size += entries_.capacity() * sizeof( Entry );
+    return size;
+  }
+
+private:
+  class OrderLess
+  {
+  public:
+    explicit OrderLess( const SortedHashMap* map ) : map_( map ) {}
+    bool operator()( u32 a, u32 b ) const
+    {
+      return Traits::less( map_->entries_[a].kv.first, map_->entries_[b].kv.first );
+    }
+
+  private:
+    const SortedHashMap* map_;
+  };
+
+  template <class K>
+  size_t find_entry( const K& key ) const
+  {
+    size_t hash = 0;
+    bool hashed = Traits::hash( key, hash );
+    return find_entry( key, hash, hashed );
+  }
+
+  template <class K>
+  size_t find_entry( const K& key, size_t hash, bool hashed ) const
+  {
+    if ( hashed && !index_.empty() )
+    {
+      size_t mask = index_.size() - 1;
+      for ( size_t slot = hash & mask;; slot = ( slot + 1 ) & mask )
+      {
+        u32 idx = index_[slot];
+        if ( idx == 0 )
+          return npos;
+        const Entry& entry = entries_[idx - 1];
+        if ( entry.live && entry.hash == hash && Traits::equal( entry.kv.first, key ) )
+          return idx - 1;
+      }
+    }
+    for ( size_t i = 0; i < entries_.size(); ++i )
+    {
+      const Entry& entry = entries_[i];
+      if ( entry.live && entry.hashed == hashed && ( !hashed || entry.hash == hash ) &&
+           Traits::equal( entry.kv.first, key ) )
+        return i;
+    }
+    return npos;
+  }
+
+  size_t insert_entry( const Key& key, size_t hash, bool hashed )
+  {
+    size_t idx = entries_.size();
+    entries_.emplace_back( key, hash, hashed );
+    ++live_;
+    if ( !index_.empty() && ( idx + 1 ) * 2 > index_.size() )
+      build_index();
+    else if ( !index_.empty() )
+      index_entry( idx );
+    else if ( entries_.size() > SMALL_SIZE )
+      build_index();
+    return idx;
+  }
+
+  void index_entry( size_t idx )
+  {
+    const Entry& entry = entries_[idx];
+    if ( !entry.hashed || !entry.live )
+      return;
+    size_t mask = index_.size() - 1;
+    size_t slot = entry.hash & mask;
+    while ( index_[slot] != 0 )
+      slot = ( slot + 1 ) & mask;
+    index_[slot] = static_cast<u32>( idx + 1 );
+  }
+
+  void build_index()
+  {
+    index_.clear();
+    if ( entries_.size() <= SMALL_SIZE )
+      return;
+    size_t size = 32;
+    while ( size < entries_.size() * 2 )
+      size *= 2;
+    index_.resize( size, 0 );
+    for ( size_t i = 0; i < entries_.size(); ++i )
+      index_entry( i );
+  }
+
+  // removes the erased entries, keeps insertion and key order
+  void compact()
+  {
+    std::vector<u32> remap( entries_.size(), 0 );
+    std::vector<Entry> live;
+    live.reserve( live_ );
+    size_t sorted = 0;
+    for ( size_t i = 0; i < entries_.size(); ++i )
+    {
+      if ( !entries_[i].live )
+        continue;
+      if ( i < sorted_ )
+        ++sorted;
+      remap[i] = static_cast<u32>( live.size() );
+      live.push_back( std::move( entries_[i] ) );
+    }
+    std::vector<u32> order;
+    order.reserve( live_ );
+    for ( u32 idx : order_ )
+    {
+      if ( entries_[idx].live )
+        order.push_back( remap[idx] );
+    }
+    entries_.clear();
+    for ( Entry& entry : live )
+      entries_.push_back( std::move( entry ) );
+    order_.swap( order );
+    sorted_ = sorted;
+    build_index();
+  }
+
+  // merges the entries inserted since the last call into the key order
+  void sort() const
+  {
+    if ( sorted_ == entries_.size() )
+      return;
+    size_t mid = order_.size();
+    for ( size_t i = sorted_; i < entries_.size(); ++i )
+    {
+      if ( entries_[i].live )
+        order_.push_back( static_cast<u32>( i ) );
+    }
+    OrderLess less( this );
+    std::sort( order_.begin() + mid, order_.end(), less );
+    std::inplace_merge( order_.begin(), order_.begin() + mid, order_.end(), less );
+    sorted_ = entries_.size();
+  }
+
+  typedef boost::container::small_vector<Entry, INLINE_SIZE> Entries;
+  Entries entries_;
+  std::vector<u32> index_;  // entry index + 1 per slot, 0 = empty
+  mutable std::vector<u32> order_;
+  mutable size_t sorted_;  // entries_[0, sorted_) are in order_
+  size_t live_;
+};
+}  // namespace Bscript
+}  // namespace Pol
+#endif
@@ -11,6 +11,7 @@ set (clib_sources
   Program/ProgramMain.cpp
   Program/ProgramMain.h
   StdAfx.h
+  atom.h
   binaryfile.cpp 
   binaryfile.h
   bitutil.h
@@ -19,6 +20,8 @@ set (clib_sources
   cfgelem.h
   cfgfile.cpp 
   cfgfile.h
+  cfgsnapshot.cpp
+  cfgsnapshot.h
   cfgsect.cpp
   cfgsect.h
   clib.h
@@ -46,10 +49,13 @@ set (clib_sources
   kbhit.h
   logfacility.cpp
   logfacility.h
+  mappedfile.cpp
+  mappedfile.h
   maputil.h
   message_queue.h
   mlog.cpp 
   mlog.h
+  network/eventpoller.h
   network/sckutil.cpp 
   network/sckutil.h
   network/singlepoller.h
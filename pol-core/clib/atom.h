@@ -0,0 +1,96 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef CLIB_ATOM_H
+#define CLIB_ATOM_H
+
+#include <ctype.h>
+#include <functional>
+#include <stddef.h>
+#include <string.h>
+#include <string>
+
+#include "boostutils.h"
+
+namespace Pol
+{
+namespace Clib
+{
+// Interned case insensitive identifier, used for struct member and config property names.
+// All atoms of a name share one table entry, which also points to the interned lower case name,
+// so comparing two atoms is a pointer compare. The hash is computed from the name once per entry,
+// so AtomProbe can look up a name without interning it. The name keeps the spelling it was
+// created with. Entries are reference counted and freed with their last atom.
+class Atom
+{
+public:
+  Atom() : atom_() {}
+  explicit Atom( const std::string& name ) : atom_( name ) {}
+  explicit Atom( const char* name ) : atom_( std::string( name ) ) {}
+
+  const std::string& name() const { return atom_.get().name; }
+  const std::string& folded() const { return atom_.get().folded.get(); }
+  // equal for all atoms whose names only differ in case
+  const void* id() const { return &atom_.get().folded.get(); }
+  size_t hash() const { return atom_.get().hash; }
+
+  bool operator==( const Atom& other ) const { return id() == other.id(); }
+  bool operator!=( const Atom& other ) const { return id() != other.id(); }
+
+private:
+  boost_utils::atom_flyweight atom_;
+};
+
+// A name compared with atoms without going through the (locked) atom table, for lookups of
+// names which might not be a key at all. Only refers to the name, which has to outlive it.
+class AtomProbe
+{
+public:
+  AtomProbe( const char* name, size_t len )
+      : name_( name ), len_( len ), hash_( boost_utils::atom_name_hash( name, len ) )
+  {
+  }
+  explicit AtomProbe( const std::string& name ) : AtomProbe( name.c_str(), name.size() ) {}
+  explicit AtomProbe( const char* name ) : AtomProbe( name, strlen( name ) ) {}
+
+  size_t hash() const { return hash_; }
+  bool matches( const Atom& atom ) const
+  {
+    if ( atom.hash() != hash_ )
+      return false;
+    const std::string& folded = atom.folded();
+    if ( folded.size() != len_ )
+      return false;
+    for ( size_t i = 0; i < len_; ++i )
+    {
+      if ( folded[i] != static_cast<char>( tolower( static_cast<unsigned char>( name_[i] ) ) ) )
+        return false;
+    }
+    return true;
+  }
+
+private:
+  const char* name_;
+  size_t len_;
+  size_t hash_;
+};
+
+struct AtomHash
+{
+  size_t operator()( const Atom& atom ) const { return atom.hash(); }
+};
+
+// an arbitrary but fixed order of the atoms, not the order of the names
+struct AtomIdLess
+{
+  bool operator()( const Atom& a, const Atom& b ) const
+  {
+    return std::less<const void*>()( a.id(), b.id() );
+  }
+};
+}  // namespace Clib
+}  // namespace Pol
+#endif
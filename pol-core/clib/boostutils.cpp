@@ -1,9 +1,39 @@
 
 #include "boostutils.h"
+
+#include <ctype.h>
+
 namespace Pol
 {
 namespace boost_utils
 {
+static std::string fold_atom_name( const std::string& name )
+{
+  std::string folded( name );
+  for ( auto& c : folded )
+    c = static_cast<char>( tolower( static_cast<unsigned char>( c ) ) );
+  return folded;
+}
+
+size_t atom_name_hash( const char* name, size_t len )
+{
+  // FNV-1a
+  size_t hash = static_cast<size_t>( 2166136261u );
+  for ( size_t i = 0; i < len; ++i )
+  {
+    hash ^= static_cast<size_t>( tolower( static_cast<unsigned char>( name[i] ) ) );
+    hash *= static_cast<size_t>( 16777619u );
+  }
+  return hash;
+}
+
+atom_entry::atom_entry( const std::string& atom_name )
+    : name( atom_name ),
+      folded( fold_atom_name( atom_name ) ),
+      hash( atom_name_hash( atom_name.c_str(), atom_name.size() ) )
+{
+}
+
 flyweight_initializers::~flyweight_initializers()
 {
 #ifdef ENABLE_FLYWEIGHT_REPORT
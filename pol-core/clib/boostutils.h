@@ -28,6 +28,7 @@
 #include <vector>
 #endif
 #include <boost/flyweight.hpp>
+#include <boost/flyweight/key_value.hpp>
 
 namespace Pol
 {
@@ -178,6 +179,34 @@ struct function_name_tag
 typedef boost::flyweight<std::string, boost::flyweights::tag<function_name_tag>,
                          FLYWEIGHT_HASH_FACTORY>
     function_name_flystring;
+struct atom_folded_tag
+{
+};
+typedef boost::flyweight<std::string, boost::flyweights::tag<atom_folded_tag>,
+                         FLYWEIGHT_HASH_FACTORY>
+    atom_folded_flystring;
+
+// case insensitive hash of an atom name
+size_t atom_name_hash( const char* name, size_t len );
+
+// table entry of Clib::Atom, keyed by the name
+struct atom_entry
+{
+  explicit atom_entry( const std::string& atom_name );
+  std::string name;
+  atom_folded_flystring folded;  // lower case name
+  size_t hash;                   // atom_name_hash of the name
+};
+struct atom_entry_name
+{
+  const std::string& operator()( const atom_entry& entry ) const { return entry.name; }
+};
+struct atom_tag
+{
+};
+typedef boost::flyweight<boost::flyweights::key_value<std::string, atom_entry, atom_entry_name>,
+                         boost::flyweights::tag<atom_tag>>
+    atom_flyweight;
 
 /**
  * These types must be initialized before any static objects using them
@@ -193,6 +222,8 @@ struct flyweight_initializers
   script_name_flystring::initializer fwInit_script_name;
   npctemplate_name_flystring::initializer fwInit_npctemplate_name;
   function_name_flystring::initializer fwInit_func_name;
+  atom_folded_flystring::initializer fwInit_atom_folded;
+  atom_flyweight::initializer fwInit_atom;
 
   ~flyweight_initializers();
 };
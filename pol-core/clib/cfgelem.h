@@ -56,6 +56,7 @@ public:
   virtual ~ConfigElem();
   virtual size_t estimateSize() const override;
   friend class ConfigFile;
+  friend class ChunkedConfigReader;
 
   bool has_prop( const char* propname ) const;
 
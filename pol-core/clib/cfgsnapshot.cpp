@@ -0,0 +1,872 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "cfgsnapshot.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include "cfgelem.h"
+#include "clib.h"
+#include "clib_endian.h"
+#include "logfacility.h"
+#include "stlutil.h"
+#include "strutil.h"
+#include "threadhelp.h"
+#include <format/format.h>
+
+namespace Pol
+{
+namespace Clib
+{
+namespace
+{
+const char SNAPSHOT_MAGIC[8] = {'P', 'O', 'L', 'S', 'N', 'A', 'P', '\0'};
+const u32 SNAPSHOT_VERSION = 1;
+const size_t SNAPSHOT_HEADER_SIZE = 24;
+const u32 CPROP_FLAG = 0x80000000u;
+// chunk limits, big enough to keep the index small and small enough to keep all threads busy
+const size_t CHUNK_MAX_BYTES = 1024 * 1024;
+const u32 CHUNK_MAX_ELEMENTS = 4096;
+// text is split into ranges of about this size for parsing
+const size_t TEXT_RANGE_BYTES = 1024 * 1024;
+
+bool commentline( const std::string& str )
+{
+  return ( ( str[0] == '#' ) || ( str.compare( 0, 2, "//" ) == 0 ) );
+}
+
+bool needs_quotes( const std::string& value )
+{
+  if ( value.empty() )
+    return false;
+  return value[0] == '\"' || value.find( '\n' ) != std::string::npos ||
+         isspace( static_cast<unsigned char>( value.front() ) ) ||
+         isspace( static_cast<unsigned char>( value.back() ) );
+}
+
+// bounds checked reading of a mapped chunk
+class ChunkCursor
+{
+public:
+  ChunkCursor( const char* data, size_t size, size_t pos ) : _data( data ), _size( size ), _pos( pos )
+  {
+  }
+  u32 get_u32()
+  {
+    need( 4 );
+    u32 value;
+    std::memcpy( &value, _data + _pos, 4 );
+    _pos += 4;
+    return cfLEu32( value );
+  }
+  u64 get_u64()
+  {
+    u64 low = get_u32();
+    u64 high = get_u32();
+    return low | ( high << 32 );
+  }
+  std::pair<const char*, size_t> get_str()
+  {
+    u32 len = get_u32();
+    need( len );
+    const char* str = _data + _pos;
+    _pos += len;
+    return std::make_pair( str, static_cast<size_t>( len ) );
+  }
+  // a count read from the file, throws if that many entries of entry_size can't follow
+  u32 get_count( size_t entry_size )
+  {
+    u32 count = get_u32();
+    if ( count > ( _size - _pos ) / entry_size )
+      throw std::runtime_error( "Snapshot file is corrupt (invalid count)" );
+    return count;
+  }
+
+private:
+  void need( size_t len ) const
+  {
+    if ( _pos + len > _size || _pos + len < _pos )
+      throw std::runtime_error( "Snapshot file is corrupt (unexpected end of data)" );
+  }
+  const char* _data;
+  size_t _size;
+  size_t _pos;
+};
+
+// decodes count elements, Sink gets begin( type, rest ) and prop( name, value )
+template <class Sink>
+void decode_elements( ChunkCursor& cursor, u32 count, const std::vector<std::string>& strings,
+                      Sink& sink )
+{
+  auto lookup = [&]( u32 id ) -> const std::string& {
+    if ( id >= strings.size() )
+      throw std::runtime_error( "Snapshot file is corrupt (invalid string id)" );
+    return strings[id];
+  };
+  std::string value;
+  for ( u32 i = 0; i < count; ++i )
+  {
+    const std::string& type = lookup( cursor.get_u32() );
+    auto rest = cursor.get_str();
+    sink.begin( type, std::string( rest.first, rest.second ) );
+    u32 nprops = cursor.get_u32();
+    for ( u32 p = 0; p < nprops; ++p )
+    {
+      u32 name_id = cursor.get_u32();
+      if ( name_id & CPROP_FLAG )
+      {
+        const std::string& cpropname = lookup( cursor.get_u32() );
+        auto str = cursor.get_str();
+        value.reserve( cpropname.size() + 1 + str.second );
+        value.assign( cpropname );
+        value += ' ';
+        value.append( str.first, str.second );
+      }
+      else
+      {
+        auto str = cursor.get_str();
+        value.assign( str.first, str.second );
+      }
+      sink.prop( lookup( name_id & ~CPROP_FLAG ), std::move( value ) );
+      value.clear();
+    }
+  }
+}
+
+struct SnapshotElementSink
+{
+  const std::function<void( const SnapshotElement& )>& handler;
+  SnapshotElement elem;
+  bool started;
+
+  void begin( const std::string& type, std::string&& rest )
+  {
+    finish();
+    elem.type = type;
+    elem.rest = std::move( rest );
+    elem.properties.clear();
+    started = true;
+  }
+  void prop( const std::string& name, std::string&& value )
+  {
+    elem.properties.emplace_back( name, std::move( value ) );
+  }
+  void finish()
+  {
+    if ( started )
+      handler( elem );
+    started = false;
+  }
+};
+}  // namespace
+
+SnapshotWriter::SnapshotWriter( const std::string& filename )
+    : _file(),
+      _filename( filename ),
+      _chunk(),
+      _chunk_elements( 0 ),
+      _offset( 0 ),
+      _element_count( 0 ),
+      _chunks(),
+      _string_ids(),
+      _strings(),
+      _closed( false )
+{
+  _file.exceptions( std::ios_base::failbit | std::ios_base::badbit );
+  _file.open( filename.c_str(), std::ios::out | std::ios::trunc | std::ios::binary );
+  // the real header gets written by close(), an unfinished file has no valid magic
+  std::string header( SNAPSHOT_HEADER_SIZE, '\0' );
+  _file.write( header.data(), header.size() );
+  _offset = SNAPSHOT_HEADER_SIZE;
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+  if ( !_closed )
+  {
+    try
+    {
+      close();
+    }
+    catch ( std::exception& ex )
+    {
+      POLLOG_ERROR.Format( "Failed to finish snapshot {}: {}\n" ) << _filename << ex.what();
+    }
+  }
+}
+
+u32 SnapshotWriter::string_id( const std::string& str )
+{
+  auto itr = _string_ids.find( str );
+  if ( itr != _string_ids.end() )
+    return itr->second;
+  u32 id = static_cast<u32>( _strings.size() );
+  if ( id & CPROP_FLAG )
+    throw std::runtime_error( "Too many different names for a snapshot" );
+  itr = _string_ids.emplace( str, id ).first;
+  _strings.push_back( &itr->first );
+  return id;
+}
+
+void SnapshotWriter::put_u32( u32 value )
+{
+  value = ctLEu32( value );
+  _chunk.append( reinterpret_cast<const char*>( &value ), 4 );
+}
+
+void SnapshotWriter::put_str( const char* str, size_t len )
+{
+  put_u32( static_cast<u32>( len ) );
+  _chunk.append( str, len );
+}
+
+void SnapshotWriter::write( const SnapshotElement& elem )
+{
+  put_u32( string_id( elem.type ) );
+  put_str( elem.rest.data(), elem.rest.size() );
+  put_u32( static_cast<u32>( elem.properties.size() ) );
+  for ( const auto& prop : elem.properties )
+  {
+    const std::string& value = prop.second;
+    std::string::size_type space;
+    if ( stricmp( prop.first.c_str(), "CProp" ) == 0 &&
+         ( space = value.find( ' ' ) ) != std::string::npos && space > 0 )
+    {
+      put_u32( string_id( prop.first ) | CPROP_FLAG );
+      put_u32( string_id( value.substr( 0, space ) ) );
+      put_str( value.data() + space + 1, value.size() - space - 1 );
+    }
+    else
+    {
+      put_u32( string_id( prop.first ) );
+      put_str( value.data(), value.size() );
+    }
+  }
+  ++_element_count;
+  if ( ++_chunk_elements >= CHUNK_MAX_ELEMENTS || _chunk.size() >= CHUNK_MAX_BYTES )
+    flush_chunk();
+}
+
+void SnapshotWriter::flush_chunk()
+{
+  if ( !_chunk_elements )
+    return;
+  _chunks.emplace_back( _offset, _chunk_elements );
+  _file.write( _chunk.data(), _chunk.size() );
+  _offset += _chunk.size();
+  _chunk.clear();
+  _chunk_elements = 0;
+}
+
+void SnapshotWriter::close()
+{
+  if ( _closed )
+    return;
+  _closed = true;
+  flush_chunk();
+
+  u64 index_offset = _offset;
+  put_u32( static_cast<u32>( _strings.size() ) );
+  for ( const auto& str : _strings )
+    put_str( str->data(), str->size() );
+  put_u32( static_cast<u32>( _chunks.size() ) );
+  for ( const auto& chunk : _chunks )
+  {
+    put_u32( static_cast<u32>( chunk.first & 0xFFFFFFFFu ) );
+    put_u32( static_cast<u32>( chunk.first >> 32 ) );
+    put_u32( chunk.second );
+  }
+  _file.write( _chunk.data(), _chunk.size() );
+  _chunk.clear();
+
+  _chunk.append( SNAPSHOT_MAGIC, sizeof SNAPSHOT_MAGIC );
+  put_u32( SNAPSHOT_VERSION );
+  put_u32( 0 );
+  put_u32( static_cast<u32>( index_offset & 0xFFFFFFFFu ) );
+  put_u32( static_cast<u32>( index_offset >> 32 ) );
+  _file.seekp( 0 );
+  _file.write( _chunk.data(), _chunk.size() );
+  _chunk.clear();
+  _file.close();
+}
+
+size_t SnapshotWriter::element_count() const
+{
+  return _element_count;
+}
+
+
+struct ChunkedConfigReader::DecodedChunk
+{
+  // deque, ConfigElem can't be moved
+  std::deque<ConfigElem> elems;
+
+  void begin( const std::string& type, std::string&& rest )
+  {
+    elems.emplace_back();
+    elems.back().type_ = type;
+    elems.back().rest_ = std::move( rest );
+  }
+  void prop( const std::string& name, std::string&& value )
+  {
+    elems.back().properties.emplace( name, std::move( value ) );
+  }
+  void add( SnapshotElement& elem )
+  {
+    begin( elem.type, std::move( elem.rest ) );
+    for ( auto& prop : elem.properties )
+      elems.back().properties.emplace( std::move( prop.first ), std::move( prop.second ) );
+  }
+};
+
+ChunkedConfigReader::ChunkedConfigReader( const std::string& filename, const char* allowed_types,
+                                          threadhelp::TaskThreadPool* pool )
+    : _file( filename ),
+      _element_index( 0 ),
+      _pool( pool ),
+      _chunk_count( 0 ),
+      _next_chunk( 0 ),
+      _max_pending( std::max<size_t>( 2, pool != nullptr ? pool->size()
+                                                         : std::thread::hardware_concurrency() ) ),
+      _pending(),
+      _current(),
+      _current_pos( 0 ),
+      _decode_us( 0 ),
+      _wait_us( 0 ),
+      _allowed_types()
+{
+  if ( allowed_types != nullptr )
+  {
+    ISTRINGSTREAM is( allowed_types );
+    std::string tag;
+    while ( is >> tag )
+      _allowed_types.insert( tag );
+  }
+}
+
+ChunkedConfigReader::~ChunkedConfigReader()
+{
+  wait_pending();
+}
+
+void ChunkedConfigReader::start( size_t nchunks )
+{
+  _chunk_count = nchunks;
+  schedule_chunks();
+}
+
+void ChunkedConfigReader::wait_pending()
+{
+  for ( auto& pending : _pending )
+  {
+    if ( pending.valid() )
+      pending.wait();
+  }
+  _pending.clear();
+}
+
+void ChunkedConfigReader::schedule_chunks()
+{
+  while ( _pending.size() < _max_pending && _next_chunk < _chunk_count )
+  {
+    size_t idx = _next_chunk++;
+    auto decode = [this, idx]() {
+      auto start = std::chrono::steady_clock::now();
+      std::unique_ptr<DecodedChunk> chunk( new DecodedChunk );
+      decode_chunk( idx, *chunk );
+      _decode_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start )
+                        .count();
+      return chunk;
+    };
+    if ( _pool == nullptr )
+    {
+      _pending.push_back( std::async( std::launch::async, decode ) );
+      continue;
+    }
+    // the pool takes copyable functions only
+    auto promise = std::make_shared<std::promise<std::unique_ptr<DecodedChunk>>>();
+    _pending.push_back( promise->get_future() );
+    _pool->push( [promise, decode]() {
+      try
+      {
+        promise->set_value( decode() );
+      }
+      catch ( ... )
+      {
+        promise->set_exception( std::current_exception() );
+      }
+    } );
+  }
+}
+
+void ChunkedConfigReader::check_type( const std::string& type ) const
+{
+  if ( _allowed_types.empty() || _allowed_types.find( type ) != _allowed_types.end() )
+    return;
+  OSTRINGSTREAM os;
+  os << "Unexpected type '" << type << "'" << std::endl;
+  os << "\tValid types are:";
+  for ( const auto& allowed : _allowed_types )
+    os << " " << allowed.c_str();
+  throw std::runtime_error( OSTRINGSTREAM_STR( os ) );
+}
+
+bool ChunkedConfigReader::read( ConfigElem& elem )
+{
+  try
+  {
+    while ( !_current || _current_pos >= _current->elems.size() )
+    {
+      _current.reset();
+      schedule_chunks();
+      if ( _pending.empty() )
+        return false;
+      auto wait_start = std::chrono::steady_clock::now();
+      _current = _pending.front().get();
+      _pending.pop_front();
+      _wait_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - wait_start )
+                      .count();
+      _current_pos = 0;
+      schedule_chunks();
+    }
+    ConfigElem& src = _current->elems[_current_pos++];
+    ++_element_index;
+    check_type( src.type_ );
+    elem.type_.swap( src.type_ );
+    elem.rest_.swap( src.rest_ );
+    elem.properties.clear();
+    elem.properties.swap( src.properties );
+    elem._source = this;
+    return true;
+  }
+  catch ( std::exception& ex )
+  {
+    display_error( ex.what(), false );
+    throw std::runtime_error( "Configuration file error." );
+  }
+}
+
+const std::string& ChunkedConfigReader::filename() const
+{
+  return _file.filename();
+}
+
+size_t ChunkedConfigReader::chunk_count() const
+{
+  return _chunk_count;
+}
+
+u64 ChunkedConfigReader::decode_us() const
+{
+  return _decode_us;
+}
+
+u64 ChunkedConfigReader::wait_us() const
+{
+  return _wait_us;
+}
+
+
+SnapshotReader::SnapshotReader( const std::string& filename, const char* allowed_types,
+                                threadhelp::TaskThreadPool* pool )
+    : ChunkedConfigReader( filename, allowed_types, pool ), _strings(), _chunks()
+{
+  try
+  {
+    read_index();
+  }
+  catch ( std::exception& ex )
+  {
+    display_error( ex.what(), false );
+    throw;
+  }
+  start( _chunks.size() );
+}
+
+SnapshotReader::~SnapshotReader()
+{
+  // the decoding tasks use the string table
+  wait_pending();
+}
+
+bool SnapshotReader::is_snapshot( const std::string& filename )
+{
+  std::ifstream ifs( filename.c_str(), std::ios::in | std::ios::binary );
+  char magic[sizeof SNAPSHOT_MAGIC];
+  if ( !ifs.read( magic, sizeof magic ) )
+    return false;
+  return std::memcmp( magic, SNAPSHOT_MAGIC, sizeof magic ) == 0;
+}
+
+void SnapshotReader::read_index()
+{
+  if ( _file.size() < SNAPSHOT_HEADER_SIZE ||
+       std::memcmp( _file.data(), SNAPSHOT_MAGIC, sizeof SNAPSHOT_MAGIC ) != 0 )
+    throw std::runtime_error( "Not a snapshot file or the file is incomplete" );
+  ChunkCursor header( _file.data(), _file.size(), sizeof SNAPSHOT_MAGIC );
+  u32 version = header.get_u32();
+  if ( version != SNAPSHOT_VERSION )
+    throw std::runtime_error( "Unsupported snapshot version " + std::to_string( version ) );
+  header.get_u32();  // reserved
+  u64 index_offset = header.get_u64();
+  if ( index_offset > _file.size() )
+    throw std::runtime_error( "Snapshot file is corrupt (invalid index offset)" );
+
+  ChunkCursor index( _file.data(), _file.size(), static_cast<size_t>( index_offset ) );
+  u32 nstrings = index.get_count( 4 );
+  _strings.reserve( nstrings );
+  for ( u32 i = 0; i < nstrings; ++i )
+  {
+    auto str = index.get_str();
+    _strings.emplace_back( str.first, str.second );
+  }
+  u32 nchunks = index.get_count( 12 );
+  _chunks.reserve( nchunks );
+  for ( u32 i = 0; i < nchunks; ++i )
+  {
+    ChunkInfo info;
+    info.offset = index.get_u64();
+    info.elements = index.get_u32();
+    if ( info.offset >= index_offset )
+      throw std::runtime_error( "Snapshot file is corrupt (invalid chunk offset)" );
+    _chunks.push_back( info );
+  }
+}
+
+void SnapshotReader::decode_chunk( size_t idx, DecodedChunk& chunk ) const
+{
+  ChunkCursor cursor( _file.data(), _file.size(), static_cast<size_t>( _chunks[idx].offset ) );
+  decode_elements( cursor, _chunks[idx].elements, _strings, chunk );
+}
+
+void SnapshotReader::read_all( const std::function<void( const SnapshotElement& )>& handler )
+{
+  SnapshotElementSink sink{handler, SnapshotElement(), false};
+  for ( const auto& info : _chunks )
+  {
+    ChunkCursor cursor( _file.data(), _file.size(), static_cast<size_t>( info.offset ) );
+    decode_elements( cursor, info.elements, _strings, sink );
+  }
+  sink.finish();
+}
+
+void SnapshotReader::display_error( const std::string& msg, bool /*show_curline*/,
+                                    const ConfigElemBase* elem, bool error ) const
+{
+  fmt::Writer tmp;
+  tmp << ( error ? "Error" : "Warning" ) << " reading snapshot file " << _file.filename() << ":\n"
+      << "\t" << msg << "\n";
+  if ( elem != nullptr && strlen( elem->type() ) > 0 )
+    tmp << "\tElement: " << elem->type() << " " << elem->rest() << "\n";
+  if ( _element_index )
+    tmp << "\tElement number: " << _element_index << "\n";
+  ERROR_PRINT << tmp.str();
+}
+
+
+ParallelTextReader::ParallelTextReader( const std::string& filename, const char* allowed_types,
+                                        threadhelp::TaskThreadPool* pool )
+    : ChunkedConfigReader( filename, allowed_types, pool ), _ranges()
+{
+  split_ranges( 0, _file.size() );
+  start( _ranges.size() );
+}
+
+ParallelTextReader::ParallelTextReader( const std::string& filename, size_t begin, size_t end,
+                                        const char* allowed_types,
+                                        threadhelp::TaskThreadPool* pool )
+    : ChunkedConfigReader( filename, allowed_types, pool ), _ranges()
+{
+  if ( begin > end || end > _file.size() )
+    throw std::runtime_error( "Invalid range " + std::to_string( begin ) + "-" +
+                              std::to_string( end ) + " of " + filename );
+  split_ranges( begin, end );
+  start( _ranges.size() );
+}
+
+ParallelTextReader::~ParallelTextReader()
+{
+  // the parsing tasks use the ranges
+  wait_pending();
+}
+
+// A range ends after a line which closes an element, like ConfigFile any line with "}" as first
+// word does this.
+void ParallelTextReader::split_ranges( size_t first, size_t last )
+{
+  const char* data = _file.data();
+  size_t size = last;
+  size_t pos = first;
+  if ( first == 0 && size >= 3 && std::memcmp( data, "\xEF\xBB\xBF", 3 ) == 0 )  // utf8 bom
+    pos = 3;
+
+  auto closing_line = [&]( size_t line ) {
+    while ( line < size && ( data[line] == ' ' || data[line] == '\t' ) )
+      ++line;
+    return line < size && data[line] == '}' &&
+           ( line + 1 == size || isspace( static_cast<unsigned char>( data[line + 1] ) ) );
+  };
+  while ( pos < size )
+  {
+    size_t end = size;
+    const char* line = data + std::min( pos + TEXT_RANGE_BYTES, size );
+    while ( line < data + size )
+    {
+      const char* nl = static_cast<const char*>( std::memchr( line, '\n', data + size - line ) );
+      if ( nl == nullptr )
+        break;
+      if ( closing_line( static_cast<size_t>( nl + 1 - data ) ) )
+      {
+        const char* eol =
+            static_cast<const char*>( std::memchr( nl + 1, '\n', data + size - nl - 1 ) );
+        end = eol == nullptr ? size : static_cast<size_t>( eol + 1 - data );
+        break;
+      }
+      line = nl + 1;
+    }
+    _ranges.emplace_back( pos, end );
+    pos = end;
+  }
+}
+
+void ParallelTextReader::decode_chunk( size_t idx, DecodedChunk& chunk ) const
+{
+  const auto& range = _ranges[idx];
+  try
+  {
+    parse_config_text( _file.data() + range.first, range.second - range.first, true,
+                       [&chunk]( SnapshotElement& elem ) { chunk.add( elem ); } );
+  }
+  catch ( ConfigTextError& ex )
+  {
+    const char* data = _file.data();
+    size_t line = 1 + std::count( data, data + range.first + ex.offset(), '\n' );
+    throw std::runtime_error( std::string( ex.what() ) + "\n\tNear line " +
+                              std::to_string( line ) );
+  }
+}
+
+void ParallelTextReader::display_error( const std::string& msg, bool /*show_curline*/,
+                                        const ConfigElemBase* elem, bool error ) const
+{
+  fmt::Writer tmp;
+  tmp << ( error ? "Error" : "Warning" ) << " reading configuration file " << _file.filename()
+      << ":\n"
+      << "\t" << msg << "\n";
+  if ( elem != nullptr && strlen( elem->type() ) > 0 )
+    tmp << "\tElement: " << elem->type() << " " << elem->rest() << "\n";
+  if ( _element_index )
+    tmp << "\tElement number: " << _element_index << "\n";
+  ERROR_PRINT << tmp.str();
+}
+
+
+SnapshotStreamWriter::SnapshotStreamWriter() : StreamWriter(), _snapshot(), _pending() {}
+
+SnapshotStreamWriter::~SnapshotStreamWriter()
+{
+  if ( !_snapshot )
+    return;
+  try
+  {
+    flush_file();
+  }
+  catch ( std::exception& ex )
+  {
+    POLLOG_ERROR << "Failed to finish snapshot: " << ex.what() << "\n";
+  }
+}
+
+void SnapshotStreamWriter::init( const std::string& filepath )
+{
+  _snapshot.reset( new SnapshotWriter( filepath ) );
+}
+
+void SnapshotStreamWriter::convert( bool at_end )
+{
+  if ( _writer->size() )
+  {
+    _pending.append( _writer->data(), _writer->size() );
+    _writer->Clear();
+  }
+  size_t consumed = parse_config_text( _pending.data(), _pending.size(), at_end,
+                                       [&]( const SnapshotElement& elem )
+                                       { _snapshot->write( elem ); } );
+  _pending.erase( 0, consumed );
+}
+
+void SnapshotStreamWriter::flush()
+{
+  convert( false );
+}
+
+void SnapshotStreamWriter::flush_file()
+{
+  if ( !_snapshot )
+    return;
+  convert( true );
+  _snapshot->close();
+  _snapshot.reset();
+}
+
+
+ConfigTextError::ConfigTextError( const std::string& msg, size_t offset )
+    : std::runtime_error( msg ), _offset( offset )
+{
+}
+
+size_t ConfigTextError::offset() const
+{
+  return _offset;
+}
+
+size_t parse_config_text( const char* data, size_t size, bool at_end,
+                          const std::function<void( SnapshotElement& )>& handler )
+{
+  size_t pos = 0;
+  size_t line_start = 0;
+  size_t consumed = 0;
+  std::string line;
+  std::string propname, propvalue;
+  SnapshotElement elem;
+
+  // same line handling as ConfigFile::readline
+  auto next_line = [&]() -> bool
+  {
+    if ( pos >= size )
+      return false;
+    line_start = pos;
+    const char* start = data + pos;
+    const char* nl = static_cast<const char*>( std::memchr( start, '\n', size - pos ) );
+    if ( nl == nullptr )
+    {
+      if ( !at_end )
+        return false;
+      line.assign( start, size - pos );
+      pos = size;
+    }
+    else
+    {
+      line.assign( start, nl - start );
+      pos = nl - data + 1;
+    }
+    if ( !line.empty() && line.back() == '\r' )
+      line.pop_back();
+    sanitizeUnicodeWithIso( &line );
+    return true;
+  };
+
+  for ( ;; )
+  {
+    size_t elem_start = pos;
+    if ( !next_line() )
+      return at_end ? pos : consumed;
+    splitnamevalue( line, elem.type, elem.rest );
+    if ( elem.type.empty() || commentline( elem.type ) )
+    {
+      consumed = pos;
+      continue;
+    }
+
+    if ( !next_line() )
+    {
+      if ( at_end )
+        throw ConfigTextError( "File ends after element type -- expected a '{'", line_start );
+      return elem_start;
+    }
+    if ( line.empty() || line[0] != '{' )
+      throw ConfigTextError( "Expected '{' on a blank line after element type", line_start );
+
+    elem.properties.clear();
+    bool closed = false;
+    while ( next_line() )
+    {
+      splitnamevalue( line, propname, propvalue );
+      if ( propname.empty() || commentline( propname ) )
+        continue;
+      if ( propname == "}" )
+      {
+        closed = true;
+        break;
+      }
+      if ( propvalue[0] == '\"' )
+        decodequotedstring( propvalue );
+      elem.properties.emplace_back( propname, propvalue );
+    }
+    if ( !closed )
+    {
+      if ( at_end )
+        throw ConfigTextError( "Expected '}' on a blank line after element properties",
+                               line_start );
+      return elem_start;
+    }
+    handler( elem );
+    consumed = pos;
+  }
+}
+
+size_t convert_text_to_snapshot( const std::string& textfile, const std::string& snapshotfile )
+{
+  MappedFile text( textfile );
+  const char* data = text.data();
+  size_t size = text.size();
+  if ( size >= 3 && std::memcmp( data, "\xEF\xBB\xBF", 3 ) == 0 )  // utf8 bom
+  {
+    data += 3;
+    size -= 3;
+  }
+  SnapshotWriter writer( snapshotfile );
+  parse_config_text( data, size, true,
+                     [&]( const SnapshotElement& elem ) { writer.write( elem ); } );
+  writer.close();
+  return writer.element_count();
+}
+
+size_t convert_snapshot_to_text( const std::string& snapshotfile, const std::string& textfile )
+{
+  SnapshotReader reader( snapshotfile );
+  std::ofstream ofs;
+  ofs.exceptions( std::ios_base::failbit | std::ios_base::badbit );
+  ofs.open( textfile.c_str(), std::ios::out | std::ios::trunc );
+  size_t count = 0;
+  fmt::Writer tmp;
+  reader.read_all(
+      [&]( const SnapshotElement& elem )
+      {
+        tmp << elem.type;
+        if ( !elem.rest.empty() )
+          tmp << " " << elem.rest;
+        tmp << "\n{\n";
+        for ( const auto& prop : elem.properties )
+        {
+          tmp << "\t" << prop.first << "\t";
+          if ( needs_quotes( prop.second ) )
+            tmp << getencodedquotedstring( prop.second );
+          else
+            tmp << prop.second;
+          tmp << "\n";
+        }
+        tmp << "}\n\n";
+        if ( tmp.size() >= 64 * 1024 )
+        {
+          ofs.write( tmp.data(), tmp.size() );
+          tmp.Clear();
+        }
+        ++count;
+      } );
+  ofs.write( tmp.data(), tmp.size() );
+  ofs.close();
+  return count;
+}
+}  // namespace Clib
+}  // namespace Pol
@@ -0,0 +1,237 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef CLIB_CFGSNAPSHOT_H
+#define CLIB_CFGSNAPSHOT_H
+
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cfgfile.h"
+#include "mappedfile.h"
+#include "maputil.h"
+#include "rawtypes.h"
+#include "streamsaver.h"
+
+namespace Pol
+{
+namespace threadhelp
+{
+class TaskThreadPool;
+}
+namespace Clib
+{
+class ConfigElem;
+
+// Binary snapshot of config file data (used for the world save data files).
+// It contains the same elements as the text format, but length-prefixed and with all element
+// types, property names and cprop names stored once in a string table.
+//
+// Layout, all integers little endian:
+//   header  "POLSNAP\0", u32 version, u32 reserved, u64 offset of the index
+//   chunks  elements: u32 type id, str rest, u32 property count, properties:
+//             u32 name id [| CPROP_FLAG, followed by u32 cprop name id], str value
+//           (str: u32 length followed by the bytes, ids are string table indexes)
+//   index   u32 string count, str strings, u32 chunk count, chunks: u64 offset, u32 elements
+//
+// Chunks are independent of each other, the reader decodes them in parallel.
+struct SnapshotElement
+{
+  std::string type;
+  std::string rest;
+  std::vector<std::pair<std::string, std::string>> properties;
+};
+
+class SnapshotWriter
+{
+public:
+  explicit SnapshotWriter( const std::string& filename );
+  ~SnapshotWriter();
+  SnapshotWriter( const SnapshotWriter& ) = delete;
+  SnapshotWriter& operator=( const SnapshotWriter& ) = delete;
+
+  void write( const SnapshotElement& elem );
+  // writes the string table and the index, the file is incomplete without it
+  void close();
+
+  size_t element_count() const;
+
+private:
+  u32 string_id( const std::string& str );
+  void put_u32( u32 value );
+  void put_str( const char* str, size_t len );
+  void flush_chunk();
+
+  std::ofstream _file;
+  std::string _filename;
+  std::string _chunk;
+  u32 _chunk_elements;
+  u64 _offset;
+  size_t _element_count;
+  std::vector<std::pair<u64, u32>> _chunks;
+  std::unordered_map<std::string, u32> _string_ids;
+  std::vector<const std::string*> _strings;
+  bool _closed;
+};
+
+// Base of the readers which decode chunks of a file in background tasks (on the given pool or
+// with std::async), while the caller consumes the elements in file order like with
+// ConfigFile::read(). Only a few chunks are decoded ahead, so the memory usage stays bounded.
+class ChunkedConfigReader : public ConfigSource
+{
+public:
+  virtual ~ChunkedConfigReader();
+
+  bool read( ConfigElem& elem );  // true=got one, false=end of file
+
+  const std::string& filename() const;
+  size_t chunk_count() const;
+  // decoding time of all chunks so far, summed up over all background tasks
+  u64 decode_us() const;
+  // time read() had to wait for the background tasks
+  u64 wait_us() const;
+
+protected:
+  ChunkedConfigReader( const std::string& filename, const char* allowed_types,
+                       threadhelp::TaskThreadPool* pool );
+
+  struct DecodedChunk;
+  virtual void decode_chunk( size_t idx, DecodedChunk& chunk ) const = 0;
+  // the derived constructor has to call it once the chunks are known
+  void start( size_t nchunks );
+  // derived destructors have to call it before anything decode_chunk() uses is gone
+  void wait_pending();
+
+  MappedFile _file;
+  size_t _element_index;
+
+private:
+  void schedule_chunks();
+  void check_type( const std::string& type ) const;
+
+  threadhelp::TaskThreadPool* _pool;
+  size_t _chunk_count;
+  size_t _next_chunk;
+  size_t _max_pending;
+  std::deque<std::future<std::unique_ptr<DecodedChunk>>> _pending;
+  std::unique_ptr<DecodedChunk> _current;
+  size_t _current_pos;
+  std::atomic<u64> _decode_us;
+  u64 _wait_us;
+
+  typedef std::set<std::string, ci_cmp_pred> AllowedTypesCont;
+  AllowedTypesCont _allowed_types;
+};
+
+// Reads a snapshot with the same interface as ConfigFile
+class SnapshotReader final : public ChunkedConfigReader
+{
+public:
+  explicit SnapshotReader( const std::string& filename, const char* allowed_types = nullptr,
+                           threadhelp::TaskThreadPool* pool = nullptr );
+  virtual ~SnapshotReader();
+
+  // element by element in file order and with the original property order (used for converting)
+  void read_all( const std::function<void( const SnapshotElement& )>& handler );
+
+  static bool is_snapshot( const std::string& filename );
+
+protected:
+  virtual void decode_chunk( size_t idx, DecodedChunk& chunk ) const override;
+  virtual void display_error( const std::string& msg, bool show_curline = true,
+                              const ConfigElemBase* elem = nullptr,
+                              bool error = true ) const override;
+
+private:
+  struct ChunkInfo
+  {
+    u64 offset;
+    u32 elements;
+  };
+
+  void read_index();
+
+  std::vector<std::string> _strings;
+  std::vector<ChunkInfo> _chunks;
+};
+
+// Reads a text config file with the same result as ConfigFile, but the file gets split into
+// ranges of whole elements which are parsed in background tasks.
+class ParallelTextReader final : public ChunkedConfigReader
+{
+public:
+  explicit ParallelTextReader( const std::string& filename, const char* allowed_types = nullptr,
+                               threadhelp::TaskThreadPool* pool = nullptr );
+  // only the elements in [begin, end) of the file, e.g. a text record inside a binary file
+  ParallelTextReader( const std::string& filename, size_t begin, size_t end,
+                      const char* allowed_types = nullptr,
+                      threadhelp::TaskThreadPool* pool = nullptr );
+  virtual ~ParallelTextReader();
+
+protected:
+  virtual void decode_chunk( size_t idx, DecodedChunk& chunk ) const override;
+  virtual void display_error( const std::string& msg, bool show_curline = true,
+                              const ConfigElemBase* elem = nullptr,
+                              bool error = true ) const override;
+
+private:
+  void split_ranges( size_t first, size_t last );
+
+  // [begin, end) offsets of the ranges
+  std::vector<std::pair<size_t, size_t>> _ranges;
+};
+
+// StreamWriter which takes the usual text output of printOn() & co and stores it as snapshot.
+// Complete elements are converted on every flush, so only the last partial element is buffered.
+class SnapshotStreamWriter final : public StreamWriter
+{
+public:
+  SnapshotStreamWriter();
+  virtual ~SnapshotStreamWriter();
+  virtual void init( const std::string& filepath ) override;
+  virtual void flush() override;
+  virtual void flush_file() override;
+
+private:
+  void convert( bool at_end );
+
+  std::unique_ptr<SnapshotWriter> _snapshot;
+  std::string _pending;
+};
+
+// thrown by parse_config_text(), offset is the start of the line with the error
+class ConfigTextError : public std::runtime_error
+{
+public:
+  ConfigTextError( const std::string& msg, size_t offset );
+  size_t offset() const;
+
+private:
+  size_t _offset;
+};
+
+// Parses config file text and calls handler for every complete element, the handler may move
+// the content out. Returns the offset after the last complete element. If at_end is false a
+// trailing incomplete element is left for the next call, otherwise it's an error.
+size_t parse_config_text( const char* data, size_t size, bool at_end,
+                          const std::function<void( SnapshotElement& )>& handler );
+
+// offline conversion between both formats, returns the number of elements
+size_t convert_text_to_snapshot( const std::string& textfile, const std::string& snapshotfile );
+size_t convert_snapshot_to_text( const std::string& snapshotfile, const std::string& textfile );
+}  // namespace Clib
+}  // namespace Pol
+#endif
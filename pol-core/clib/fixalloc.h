@@ -19,6 +19,7 @@
 #include "pol_global_config.h"
 
 #include <assert.h>
+#include <atomic>
 #include <stddef.h>
 #include <stdlib.h>
 
@@ -29,6 +30,8 @@ namespace Pol
 {
 namespace Clib
 {
+// Every thread keeps its own freelist, buffers freed by another thread than the allocating one
+// simply move to the freelist of the freeing thread.
 template <size_t N, size_t B>
 class fixed_allocator
 {
@@ -49,13 +52,13 @@ public:
   void log_stuff( const std::string& detail );
 #endif
 
-  size_t memsize = 0;
+  std::atomic<size_t> memsize{ 0 };
 
 protected:
   void* refill( void );
 
 private:
-  Buffer* freelist_ = nullptr;
+  static thread_local Buffer* freelist_;
 #ifdef MEMORYLEAK
   int buffers;
   int requests;
@@ -63,11 +66,13 @@ private:
 #endif
 };
 
+template <size_t N, size_t B>
+thread_local typename fixed_allocator<N, B>::Buffer* fixed_allocator<N, B>::freelist_ = nullptr;
+
 #ifdef MEMORYLEAK
 template <size_t N, size_t B>
 fixed_allocator<N, B>::fixed_allocator()
 {
-  freelist_ = nullptr;
   buffers = 0;
   requests = 0;
   max_requests = 0;
@@ -0,0 +1,128 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "mappedfile.h"
+#include "Header_Windows.h"
+
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Pol
+{
+namespace Clib
+{
+MappedFile::MappedFile()
+    : _filename(),
+      _data( nullptr ),
+      _size( 0 ),
+#ifdef _WIN32
+      _file( INVALID_HANDLE_VALUE ),
+      _mapping( nullptr )
+#else
+      _fd( -1 )
+#endif
+{
+}
+
+MappedFile::MappedFile( const std::string& filename ) : MappedFile()
+{
+  open( filename );
+}
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+#ifdef _WIN32
+void MappedFile::open( const std::string& filename )
+{
+  close();
+  _file = CreateFileA( filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+  if ( _file == INVALID_HANDLE_VALUE )
+    throw std::runtime_error( "Unable to open " + filename );
+  LARGE_INTEGER size;
+  if ( !GetFileSizeEx( _file, &size ) )
+  {
+    close();
+    throw std::runtime_error( "Unable to get the size of " + filename );
+  }
+  _filename = filename;
+  _size = static_cast<size_t>( size.QuadPart );
+  if ( _size == 0 )
+    return;
+  _mapping = CreateFileMappingA( _file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+  if ( _mapping != nullptr )
+    _data = static_cast<const char*>( MapViewOfFile( _mapping, FILE_MAP_READ, 0, 0, 0 ) );
+  if ( _data == nullptr )
+  {
+    close();
+    throw std::runtime_error( "Unable to map " + filename );
+  }
+}
+
+void MappedFile::close()
+{
+  if ( _data != nullptr )
+    UnmapViewOfFile( _data );
+  if ( _mapping != nullptr )
+    CloseHandle( _mapping );
+  if ( _file != INVALID_HANDLE_VALUE )
+    CloseHandle( _file );
+  _data = nullptr;
+  _mapping = nullptr;
+  _file = INVALID_HANDLE_VALUE;
+  _size = 0;
+  _filename.clear();
+}
+#else
+void MappedFile::open( const std::string& filename )
+{
+  close();
+  _fd = ::open( filename.c_str(), O_RDONLY );
+  if ( _fd < 0 )
+    throw std::runtime_error( "Unable to open " + filename );
+  struct stat st;
+  if ( fstat( _fd, &st ) != 0 )
+  {
+    close();
+    throw std::runtime_error( "Unable to get the size of " + filename );
+  }
+  _filename = filename;
+  _size = static_cast<size_t>( st.st_size );
+  if ( _size == 0 )
+    return;
+  void* addr = mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0 );
+  if ( addr == MAP_FAILED )
+  {
+    close();
+    throw std::runtime_error( "Unable to map " + filename );
+  }
+  madvise( addr, _size, MADV_SEQUENTIAL );
+  _data = static_cast<const char*>( addr );
+}
+
+void MappedFile::close()
+{
+  if ( _data != nullptr )
+    munmap( const_cast<char*>( _data ), _size );
+  if ( _fd >= 0 )
+    ::close( _fd );
+  _data = nullptr;
+  _fd = -1;
+  _size = 0;
+  _filename.clear();
+}
+#endif
+}  // namespace Clib
+}  // namespace Pol
@@ -0,0 +1,66 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef CLIB_MAPPEDFILE_H
+#define CLIB_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace Pol
+{
+namespace Clib
+{
+// read-only memory mapping of a whole file
+class MappedFile
+{
+public:
+  MappedFile();
+  explicit MappedFile( const std::string& filename );
+  ~MappedFile();
+  MappedFile( const MappedFile& ) = delete;
+  MappedFile& operator=( const MappedFile& ) = delete;
+
+  // throws std::runtime_error if the file cannot be opened or mapped
+  void open( const std::string& filename );
+  void close();
+
+  bool is_open() const;
+  const char* data() const;
+  size_t size() const;
+  const std::string& filename() const;
+
+private:
+  std::string _filename;
+  const char* _data;
+  size_t _size;
+#ifdef _WIN32
+  void* _file;
+  void* _mapping;
+#else
+  int _fd;
+#endif
+};
+
+inline bool MappedFile::is_open() const
+{
+  return !_filename.empty();
+}
+inline const char* MappedFile::data() const
+{
+  return _data;
+}
+inline size_t MappedFile::size() const
+{
+  return _size;
+}
+inline const std::string& MappedFile::filename() const
+{
+  return _filename;
+}
+}  // namespace Clib
+}  // namespace Pol
+#endif
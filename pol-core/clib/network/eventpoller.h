@@ -0,0 +1,128 @@
+#pragma once
+#ifndef H_EVENTPOLLER
+#define H_EVENTPOLLER
+
+#include "sockets.h"
+
+// Only Linux (epoll) is supported for now. Users must check HAVE_EVENTPOLLER and fall back to
+// the SinglePoller (one thread per socket) otherwise.
+#ifdef __linux__
+#define HAVE_EVENTPOLLER 1
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <vector>
+
+#include "../passert.h"
+
+namespace Pol
+{
+namespace Clib
+{
+// Waits for events on many sockets at once. In contrast to SinglePoller every registered socket
+// carries a user pointer, which is handed back with each event. Level triggered, so a socket that
+// still has unread data will be reported again on the next wait_for_events().
+class EventPoller
+{
+public:
+  struct Event
+  {
+    void* data;
+    bool incoming;
+    bool writable;
+    bool error;
+  };
+
+  explicit EventPoller( int max_events = 256 )
+      : _epfd( epoll_create1( EPOLL_CLOEXEC ) ),
+        _wakefd( eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC ) ),
+        _raw( max_events ),
+        _events()
+  {
+    passert_always( _epfd != -1 );
+    passert_always( _wakefd != -1 );
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;  // marks the wakeup fd
+    epoll_ctl( _epfd, EPOLL_CTL_ADD, _wakefd, &ev );
+    _events.reserve( max_events );
+  }
+  ~EventPoller()
+  {
+    close( _wakefd );
+    close( _epfd );
+  }
+  EventPoller( const EventPoller& ) = delete;
+  EventPoller& operator=( const EventPoller& ) = delete;
+
+  bool add( SOCKET socket, void* data, bool notify_writable )
+  {
+    return ctl( EPOLL_CTL_ADD, socket, data, true, notify_writable );
+  }
+  bool modify( SOCKET socket, void* data, bool notify_incoming, bool notify_writable )
+  {
+    return ctl( EPOLL_CTL_MOD, socket, data, notify_incoming, notify_writable );
+  }
+  void remove( SOCKET socket )
+  {
+    if ( socket != INVALID_SOCKET )
+      epoll_ctl( _epfd, EPOLL_CTL_DEL, socket, nullptr );
+  }
+
+  // can be called from any thread to interrupt a running wait_for_events()
+  void wakeup()
+  {
+    eventfd_t one = 1;
+    eventfd_write( _wakefd, one );
+  }
+
+  // returns the number of socket events (wakeups are not counted), or -1 on error
+  int wait_for_events( int timeout_ms )
+  {
+    _events.clear();
+    int res = epoll_wait( _epfd, _raw.data(), static_cast<int>( _raw.size() ), timeout_ms );
+    if ( res < 0 )
+      return res;
+    for ( int i = 0; i < res; ++i )
+    {
+      const epoll_event& raw = _raw[i];
+      if ( raw.data.ptr == nullptr )
+      {
+        eventfd_t val;
+        eventfd_read( _wakefd, &val );
+        continue;
+      }
+      _events.push_back( Event{ raw.data.ptr, ( raw.events & EPOLLIN ) != 0,
+                                ( raw.events & EPOLLOUT ) != 0,
+                                ( raw.events & ( EPOLLHUP | EPOLLERR ) ) != 0 } );
+    }
+    return static_cast<int>( _events.size() );
+  }
+
+  const std::vector<Event>& events() const { return _events; }
+
+private:
+  bool ctl( int op, SOCKET socket, void* data, bool notify_incoming, bool notify_writable )
+  {
+    if ( socket == INVALID_SOCKET )
+      return false;
+    epoll_event ev{};
+    if ( notify_incoming )
+      ev.events |= EPOLLIN;
+    if ( notify_writable )
+      ev.events |= EPOLLOUT;
+    ev.data.ptr = data;
+    return epoll_ctl( _epfd, op, socket, &ev ) == 0;
+  }
+
+  int _epfd;
+  int _wakefd;
+  std::vector<epoll_event> _raw;
+  std::vector<Event> _events;
+};
+}  // namespace Clib
+}  // namespace Pol
+
+#endif  // __linux__
+#endif
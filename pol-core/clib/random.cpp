@@ -7,7 +7,9 @@
 
 
 #include <chrono>
+#include <functional>
 #include <random>
+#include <thread>
 
 #include "random.h"
 
@@ -17,8 +19,10 @@ namespace Clib
 {
 namespace
 {
-static std::mt19937 generator(
-    static_cast<unsigned>( std::chrono::system_clock::now().time_since_epoch().count() ) );
+// one generator per thread, detached scripts use the random functions on worker threads
+thread_local std::mt19937 generator(
+    static_cast<unsigned>( std::chrono::system_clock::now().time_since_epoch().count() ^
+                           std::hash<std::thread::id>()( std::this_thread::get_id() ) ) );
 }
 
 // returns [0,f]
@@ -21,6 +21,7 @@
 // stl includes
 #include <algorithm>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 // fast fixed size memory allocator, used for fast node memory management
@@ -35,6 +36,7 @@ namespace Pol
 namespace Plib
 {
 // The AStar search class. UserState is the users state space type
+// The search can be reused, the node memory is only allocated once.
 template <class UserState>
 class AStarSearch
 {
@@ -64,7 +66,9 @@ public:
     float h;  // heuristic estimate of distance to goal
     float f;  // sum of cumulative cost of predecessors and self and heuristic
 
-    Node() : parent( 0 ), child( 0 ), g( 0.0f ), h( 0.0f ), f( 0.0f ) {}
+    bool closed;  // on the closed list instead of the open list
+
+    Node() : parent( 0 ), child( 0 ), g( 0.0f ), h( 0.0f ), f( 0.0f ), closed( false ) {}
     UserState m_UserState;
   };
 
@@ -79,6 +83,23 @@ public:
     bool operator()( const Node* x, const Node* y ) const { return x->f > y->f; }
   };
 
+  // Open and closed nodes indexed by their state, replaces the linear list scans.
+  // UserState has to provide Hash() consistent with IsSameState()
+  class StateHash
+  {
+  public:
+    size_t operator()( const UserState* x ) const { return x->Hash(); }
+  };
+  class StateEqual
+  {
+  public:
+    bool operator()( const UserState* x, const UserState* y ) const
+    {
+      return x->IsSameState( *y );
+    }
+  };
+  typedef std::unordered_map<const UserState*, Node*, StateHash, StateEqual> NodeIndex;
+
 
 public:  // methods
   // constructor just initialises private data
@@ -89,18 +110,25 @@ public:  // methods
         m_Goal( nullptr ),
         m_CurrentSolutionNode( nullptr ),
         m_FixedSizeAllocator( MaxNodes ),
+        m_MaxNodes( MaxNodes ),
         m_AllocateNodeCount( 0 ),
         m_FreeNodeCount( 0 ),
         m_CancelRequest( false )
   {
+    m_NodeIndex.reserve( MaxNodes );
   }
 
+  // size of the node pool, which limits the size of a search
+  int GetMaxNodes() const { return m_MaxNodes; }
+
   // call at any time to cancel the search and free up all the memory
   void CancelSearch() { m_CancelRequest = true; }
   // Set Start and goal states
   void SetStartAndGoalStates( UserState& Start, UserState& Goal )
   {
     m_CancelRequest = false;
+    m_SolutionList.clear();
+    m_NodeIndex.clear();
 
     m_Start = AllocateNode();
     m_Goal = AllocateNode();
@@ -121,6 +149,7 @@ public:  // methods
     // Push the start node on the Open list
 
     m_OpenList.push_back( m_Start );  // heap now unsorted
+    m_NodeIndex.emplace( &m_Start->m_UserState, m_Start );
 
     // Sort back element into heap
     push_heap( m_OpenList.begin(), m_OpenList.end(), HeapCompare_f() );
@@ -131,16 +160,8 @@ public:  // methods
 
   bool InOpenList( UserState& theState )
   {
-    NodeVectorIterator openlist_result, openlist_end;
-    for ( openlist_result = m_OpenList.begin(), openlist_end = m_OpenList.end();
-          openlist_result != openlist_end; ++openlist_result )
-    {
-      if ( ( *openlist_result )->m_UserState.IsSameState( theState ) )
-      {
-        return true;
-      }
-    }
-    return false;
+    auto found = m_NodeIndex.find( &theState );
+    return found != m_NodeIndex.end() && !found->second->closed;
   }
 
   bool InClosedList( UserState& theState )
@@ -148,16 +169,8 @@ public:  // methods
     if ( theState.IsGoal( m_Goal->m_UserState ) )
       return true;
 
-    NodeVectorIterator closedlist_result, closedlist_end;
-    for ( closedlist_result = m_ClosedList.begin(), closedlist_end = m_ClosedList.end();
-          closedlist_result != closedlist_end; ++closedlist_result )
-    {
-      if ( ( *closedlist_result )->m_UserState.IsSameState( theState ) )
-      {
-        return true;
-      }
-    }
-    return false;
+    auto found = m_NodeIndex.find( &theState );
+    return found != m_NodeIndex.end() && found->second->closed;
   }
 
   bool AddToSolutionList( Node* theNode )
@@ -215,6 +228,7 @@ public:  // methods
       if ( n != m_Start )
       {
         // delete n;
+        m_NodeIndex.erase( &n->m_UserState );
         FreeNode( n );
 
         // set the child pointers in each node (except Goal which has no child)
@@ -249,6 +263,11 @@ public:  // methods
     }
     else  // not goal
     {
+      // push n onto Closed, it gets expanded now. No successor can replace it, since they all
+      // cost more than n
+      n->closed = true;
+      m_ClosedList.push_back( n );
+
       // We now need to generate the successors of this node
       // The user helps us to do this, and we keep the new nodes in
       // m_Successors ...
@@ -290,53 +309,14 @@ public:  // methods
         // If it is but the node that is already on them is better (lower g)
         // then we can forget about this successor
 
-        // First linear search of open list to find node
-
-        NodeVectorIterator openlist_result, openlist_end;
-
-        for ( openlist_result = m_OpenList.begin(), openlist_end = m_OpenList.end();
-              openlist_result != openlist_end; ++openlist_result )
-        {
-          if ( ( *openlist_result )->m_UserState.IsSameState( ( *successor )->m_UserState ) )
-          {
-            break;
-          }
-        }
-
-        if ( openlist_result != openlist_end )
-        {
-          // we found this state on open
-
-          if ( ( *openlist_result )->g <= newg )
-          {
-            FreeNode( ( *successor ) );
-
-            // the one on Open is cheaper than this one
-            continue;
-          }
-        }
+        auto indexed = m_NodeIndex.find( &( *successor )->m_UserState );
+        Node* existing = ( indexed != m_NodeIndex.end() ) ? indexed->second : nullptr;
 
-        NodeVectorIterator closedlist_result, closedlist_end;
-
-        for ( closedlist_result = m_ClosedList.begin(), closedlist_end = m_ClosedList.end();
-              closedlist_result != closedlist_end; ++closedlist_result )
+        if ( existing && existing->g <= newg )
         {
-          if ( ( *closedlist_result )->m_UserState.IsSameState( ( *successor )->m_UserState ) )
-          {
-            break;
-          }
-        }
-
-        if ( closedlist_result != closedlist_end )
-        {
-          // we found this state on closed
-
-          if ( ( *closedlist_result )->g <= newg )
-          {
-            // the one on Closed is cheaper than this one
-            FreeNode( ( *successor ) );
-            continue;
-          }
+          // the one on Open or Closed is cheaper than this one
+          FreeNode( ( *successor ) );
+          continue;
         }
 
         // This node is the best node so far with this particular state
@@ -347,32 +327,22 @@ public:  // methods
         ( *successor )->h = ( *successor )->m_UserState.GoalDistanceEstimate( m_Goal->m_UserState );
         ( *successor )->f = ( *successor )->g + ( *successor )->h;
 
-        // Remove successor from closed if it was on it
-
-        if ( closedlist_result != closedlist_end )
-        {
-          // remove it from Closed
-          FreeNode( ( *closedlist_result ) );
-          m_ClosedList.erase( closedlist_result );
-        }
-
-        // Update old version of this node
-        if ( openlist_result != openlist_end )
+        // Remove the old version of this node from closed or open
+        if ( existing )
         {
-          FreeNode( ( *openlist_result ) );
-          m_OpenList.erase( openlist_result );
-
-          // re-make the heap
-          make_heap( m_OpenList.begin(), m_OpenList.end(), HeapCompare_f() );
-
-          // make_heap rather than sort_heap is an essential bug fix
-          // thanks to Mike Ryynanen for pointing this out and then explaining
-          // it in detail. sort_heap called on an invalid heap does not work
-
-          //               sort_heap( m_OpenList.begin(), m_OpenList.end(), HeapCompare_f() );
+          m_NodeIndex.erase( indexed );
+          NodeVector& list = existing->closed ? m_ClosedList : m_OpenList;
+          list.erase( std::find( list.begin(), list.end(), existing ) );
+          if ( !existing->closed )
+          {
+            // re-make the heap
+            make_heap( m_OpenList.begin(), m_OpenList.end(), HeapCompare_f() );
 
-          //               assert( is_heap( m_OpenList.begin(), m_OpenList.end(),
-          // HeapCompare_f() ) );
+            // make_heap rather than sort_heap is an essential bug fix
+            // thanks to Mike Ryynanen for pointing this out and then explaining
+            // it in detail. sort_heap called on an invalid heap does not work
+          }
+          FreeNode( existing );
         }
 
         // heap now unsorted
@@ -380,12 +350,8 @@ public:  // methods
 
         // sort back element into heap
         push_heap( m_OpenList.begin(), m_OpenList.end(), HeapCompare_f() );
+        m_NodeIndex.emplace( &( *successor )->m_UserState, *successor );
       }
-
-      // push n onto Closed, as we have expanded it now
-
-      m_ClosedList.push_back( n );
-
     }  // end else (not goal so expand)
 
     return m_State;  // Succeeded bool is false at this point.
@@ -612,6 +578,7 @@ private:  // methods
     }
 
     m_ClosedList.clear();
+    m_NodeIndex.clear();
 
     FreeNode( m_Goal );  // goal is in no list
   }
@@ -652,6 +619,7 @@ private:  // methods
       }
     }
     m_ClosedList.clear();
+    m_NodeIndex.clear();
   }
 
   // Node memory management
@@ -691,6 +659,9 @@ private:  // data
   // Closed list is a vector.
   NodeVector m_ClosedList;
 
+  // Open and closed nodes by state
+  NodeIndex m_NodeIndex;
+
   NodeVector m_SolutionList;
 
   // Successors is a vector filled out by the user each type successors to a node
@@ -711,6 +682,7 @@ private:  // data
 
   // Memory
   Pol::Plib::FixedSizeAllocator<Node> m_FixedSizeAllocator;
+  int m_MaxNodes;
 
   // Debug : need to keep these two iterators around
   // for the user Dbg functions
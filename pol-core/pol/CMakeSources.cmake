@@ -23,6 +23,8 @@ set (pol_sources  # sorted !
   binaryfilescrobj.cpp
   binaryfilescrobj.h
   bowsalut.cpp
+  cfgcache.cpp
+  cfgcache.h
   cfgrepos.cpp
   cfgrepos.h
   checkpnt.cpp
@@ -107,6 +109,8 @@ set (pol_sources  # sorted !
   guildscrobj.cpp
   guildscrobj.h
   help.cpp
+  holdlist.cpp
+  holdlist.h
   irequest.cpp
   item/armor.cpp
   item/armor.h
@@ -237,6 +241,8 @@ set (pol_sources  # sorted !
   network/cgdata.h
   network/client.cpp
   network/client.h
+  network/clienteventloop.cpp
+  network/clienteventloop.h
   network/clientio.cpp
   network/clientio.h
   network/clientthread.cpp
@@ -253,6 +259,8 @@ set (pol_sources  # sorted !
   network/msghandl.h
   network/packetdefs.cpp
   network/packetdefs.h
+  network/packetdispatch.cpp
+  network/packetdispatch.h
   network/packethelper.h
   network/packethooks.cpp
   network/packethooks.h
@@ -337,6 +345,8 @@ set (pol_sources  # sorted !
   repsys_cfg.h
   savedata.cpp
   savedata.h
+  savejournal.cpp
+  savejournal.h
   schedule.cpp
   schedule.h
   scrdef.cpp
@@ -382,16 +392,24 @@ set (pol_sources  # sorted !
   tasks.h
   testing/poltest.cpp
   testing/poltest.h
+  testing/testcfgcache.cpp
+  testing/testcfgsnapshot.cpp
+  testing/testdatastore.cpp
   testing/testdrop.cpp
   testing/testenv.cpp
   testing/testenv.h
+  testing/testholdlist.cpp
+  testing/testhuffman.cpp
   testing/testlos.cpp
   testing/testmisc.cpp
+  testing/testpathfind.cpp
   testing/testpos.cpp
   testing/testrange.cpp
+  testing/testsavejournal.cpp
   testing/testskill.cpp
   testing/testvector.cpp
   testing/testwalk.cpp
+  testing/testzone.cpp
   textcmd.cpp
   textcmd.h
   tildecmd.cpp
@@ -420,6 +438,7 @@ set (pol_sources  # sorted !
   uoexec.cpp
   uoexec.h
   uolisten.cpp
+  uopathnode.cpp
   uopathnode.h
   uoscrobj.cpp
   uoscrobj.h
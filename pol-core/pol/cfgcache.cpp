@@ -0,0 +1,405 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "cfgcache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include "../bscript/bobject.h"
+#include "../bscript/impstr.h"
+#include "../clib/fileutil.h"
+#include "../clib/logfacility.h"
+#include "../plib/systemstate.h"
+#include "cfgrepos.h"
+#include "polcfg.h"
+#include <format/format.h>
+
+namespace Pol
+{
+namespace Core
+{
+namespace
+{
+const char IMAGE_MAGIC[8] = {'P', 'O', 'L', 'C', 'F', 'G', 'C', '\0'};
+const u32 IMAGE_VERSION = 3;
+
+struct ImageHeader
+{
+  char magic[8];
+  u32 version;
+  u32 element_count;
+  u64 source_mtime;
+  u64 source_size;
+  u64 names_offset;
+  u64 index_offset;
+  u32 source_crc;
+  u32 reserved;
+};
+
+// reads from the mapped image, fails instead of reading past end
+class ImageCursor
+{
+public:
+  ImageCursor( const char* data, size_t size, size_t pos )
+      : _data( data ), _size( size ), _pos( pos )
+  {
+  }
+  bool ok() const { return _pos <= _size; }
+  template <class T>
+  T get()
+  {
+    T value = T();
+    if ( skip( sizeof( T ) ) )
+      std::memcpy( &value, _data + _pos - sizeof( T ), sizeof( T ) );
+    return value;
+  }
+  // str as pointer into the image
+  const char* get_str( u32& len )
+  {
+    len = get<u32>();
+    return skip( len ) ? _data + _pos - len : nullptr;
+  }
+
+private:
+  bool skip( size_t len )
+  {
+    if ( _pos > _size || len > _size - _pos )
+    {
+      _pos = _size + 1;
+      return false;
+    }
+    _pos += len;
+    return true;
+  }
+  const char* _data;
+  size_t _size;
+  size_t _pos;
+};
+
+// FNV-1a, stable between runs and platforms unlike std::hash
+u32 path_hash( const std::string& path )
+{
+  u32 hash = 2166136261u;
+  for ( unsigned char c : path )
+  {
+    hash ^= c;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+}  // namespace
+
+// the readable part alone is ambiguous ("config/x.cfg" and "config_x.cfg"), the hash of the full
+// path keeps such files apart and open() still compares the path stored in the image
+std::string CompiledConfig::image_filename( const std::string& sourcefile )
+{
+  std::string name = sourcefile;
+  for ( auto& c : name )
+  {
+    if ( c == '/' || c == '\\' || c == ':' )
+      c = '_';
+  }
+  fmt::Writer hash;
+  hash << fmt::pad( fmt::hex( path_hash( sourcefile ) ), 8, '0' );
+  return Plib::systemstate.config.config_cache_path + name + "." + hash.str() + ".cfgc";
+}
+
+bool CompiledConfig::source_checksum( const std::string& sourcefile, u32& crc )
+{
+  std::ifstream ifs( sourcefile, std::ios::binary );
+  if ( !ifs )
+    return false;
+  uLong sum = crc32( 0L, Z_NULL, 0 );
+  char buf[64 * 1024];
+  while ( ifs )
+  {
+    ifs.read( buf, sizeof buf );
+    if ( ifs.gcount() > 0 )
+      sum = crc32( sum, reinterpret_cast<const Bytef*>( buf ), static_cast<uInt>( ifs.gcount() ) );
+  }
+  if ( ifs.bad() )
+    return false;
+  crc = static_cast<u32>( sum );
+  return true;
+}
+
+std::shared_ptr<const CompiledConfig> CompiledConfig::open( const std::string& sourcefile )
+{
+  struct stat source_stat;
+  if ( stat( sourcefile.c_str(), &source_stat ) != 0 )
+    return nullptr;
+  std::string filename = image_filename( sourcefile );
+  if ( !Clib::FileExists( filename ) )
+    return nullptr;
+
+  std::shared_ptr<CompiledConfig> image( new CompiledConfig() );
+  try
+  {
+    image->_file.open( filename );
+  }
+  catch ( std::exception& ex )
+  {
+    POLLOG_ERROR << "Unable to map " << filename << ": " << ex.what() << "\n";
+    return nullptr;
+  }
+  ImageHeader hdr;
+  if ( image->_file.size() < sizeof hdr )
+    return nullptr;
+  std::memcpy( &hdr, image->_file.data(), sizeof hdr );
+  if ( std::memcmp( hdr.magic, IMAGE_MAGIC, sizeof hdr.magic ) != 0 ||
+       hdr.version != IMAGE_VERSION ||
+       hdr.source_mtime != static_cast<u64>( source_stat.st_mtime ) ||
+       hdr.source_size != static_cast<u64>( source_stat.st_size ) )
+    return nullptr;
+  ImageCursor source( image->_file.data(), image->_file.size(), sizeof hdr );
+  u32 source_len;
+  const char* source_path = source.get_str( source_len );
+  if ( source_path == nullptr || std::string( source_path, source_len ) != sourcefile )
+    return nullptr;
+  // mtime and size miss edits within the same second which keep the size
+  u32 source_crc;
+  if ( !source_checksum( sourcefile, source_crc ) || source_crc != hdr.source_crc )
+    return nullptr;
+
+  image->_modified = static_cast<time_t>( hdr.source_mtime );
+  image->_element_count = hdr.element_count;
+  const char* data = image->_file.data();
+  size_t size = image->_file.size();
+  if ( hdr.index_offset > size || ( size - hdr.index_offset ) / 8 < hdr.element_count )
+    return nullptr;
+  image->_index = data + hdr.index_offset;
+
+  ImageCursor names( data, size, hdr.names_offset );
+  u32 count = names.get<u32>();
+  if ( !names.ok() || count > size )
+    return nullptr;
+  image->_names.reserve( count );
+  for ( u32 i = 0; i < count; ++i )
+  {
+    u32 len;
+    const char* name = names.get_str( len );
+    if ( name == nullptr )
+      return nullptr;
+    image->_names.emplace_back( std::string( name, len ) );
+  }
+  if ( !image->validate() )
+  {
+    POLLOG_ERROR << "Compiled config " << filename << " is damaged, recompiling it\n";
+    return nullptr;
+  }
+  return image;
+}
+
+bool CompiledConfig::validate()
+{
+  const char* data = _file.data();
+  size_t size = _file.size();
+  for ( size_t idx = 0; idx < _element_count; ++idx )
+  {
+    u64 offset;
+    std::memcpy( &offset, _index + idx * 8, sizeof offset );
+    ImageCursor cursor( data, size, offset );
+    u32 len;
+    cursor.get_str( len );
+    u32 nprops = cursor.get<u32>();
+    for ( u32 i = 0; i < nprops && cursor.ok(); ++i )
+    {
+      if ( cursor.get<u32>() >= _names.size() )
+        return false;
+      switch ( cursor.get<u8>() )
+      {
+      case 'l':
+        cursor.get<s32>();
+        break;
+      case 'r':
+        cursor.get<double>();
+        break;
+      case 's':
+        cursor.get_str( len );
+        break;
+      default:
+        return false;
+      }
+    }
+    if ( !cursor.ok() )
+      return false;
+  }
+  return true;
+}
+
+time_t CompiledConfig::modified() const
+{
+  return _modified;
+}
+
+size_t CompiledConfig::element_count() const
+{
+  return _element_count;
+}
+
+std::string CompiledConfig::element_key( size_t idx ) const
+{
+  u64 offset;
+  std::memcpy( &offset, _index + idx * 8, sizeof offset );
+  ImageCursor cursor( _file.data(), _file.size(), offset );
+  u32 len;
+  const char* key = cursor.get_str( len );
+  return std::string( key, len );
+}
+
+std::mutex& CompiledConfig::decode_mutex() const
+{
+  return _decode_mutex;
+}
+
+// the image was validated when opening it
+void CompiledConfig::decode_element(
+    size_t idx, const std::function<void( const Clib::Atom&, Bscript::BObjectImp* )>& add ) const
+{
+  u64 offset;
+  std::memcpy( &offset, _index + idx * 8, sizeof offset );
+  ImageCursor cursor( _file.data(), _file.size(), offset );
+  u32 len;
+  cursor.get_str( len );
+  u32 nprops = cursor.get<u32>();
+  for ( u32 i = 0; i < nprops; ++i )
+  {
+    const Clib::Atom& name = _names[cursor.get<u32>()];
+    Bscript::BObjectImp* imp;
+    switch ( cursor.get<u8>() )
+    {
+    case 'l':
+      imp = new Bscript::BLong( cursor.get<s32>() );
+      break;
+    case 'r':
+      imp = new Bscript::Double( cursor.get<double>() );
+      break;
+    default:
+    {
+      const char* str = cursor.get_str( len );
+      imp = new Bscript::ConstString( std::string( str, len ) );
+      break;
+    }
+    }
+    add( name, imp );
+  }
+}
+
+CompiledConfigWriter::CompiledConfigWriter( const std::string& sourcefile, time_t modified,
+                                            u64 size, u32 crc )
+    : _sourcefile( sourcefile ),
+      _modified( modified ),
+      _size( size ),
+      _crc( crc ),
+      _data( sizeof( ImageHeader ), '\0' ),
+      _offsets(),
+      _names(),
+      _name_ids()
+{
+  put_str( sourcefile );
+}
+
+u32 CompiledConfigWriter::name_id( const std::string& name )
+{
+  auto itr = _name_ids.find( name );
+  if ( itr != _name_ids.end() )
+    return itr->second;
+  u32 id = static_cast<u32>( _names.size() );
+  _names.push_back( name );
+  _name_ids.emplace( name, id );
+  return id;
+}
+
+void CompiledConfigWriter::put_u32( u32 value )
+{
+  _data.append( reinterpret_cast<const char*>( &value ), sizeof value );
+}
+
+void CompiledConfigWriter::put_str( const std::string& str )
+{
+  put_u32( static_cast<u32>( str.size() ) );
+  _data.append( str );
+}
+
+void CompiledConfigWriter::put_value( const Bscript::BObjectImp* imp )
+{
+  if ( imp->isa( Bscript::BObjectImp::OTLong ) )
+  {
+    s32 value = static_cast<const Bscript::BLong*>( imp )->value();
+    _data.push_back( 'l' );
+    _data.append( reinterpret_cast<const char*>( &value ), sizeof value );
+  }
+  else if ( imp->isa( Bscript::BObjectImp::OTDouble ) )
+  {
+    double value = static_cast<const Bscript::Double*>( imp )->value();
+    _data.push_back( 'r' );
+    _data.append( reinterpret_cast<const char*>( &value ), sizeof value );
+  }
+  else
+  {
+    _data.push_back( 's' );
+    put_str( imp->getStringRep() );
+  }
+}
+
+void CompiledConfigWriter::add_element( const std::string& key, const StoredConfigElem& elem )
+{
+  _offsets.push_back( _data.size() );
+  put_str( key );
+  put_u32( static_cast<u32>( elem.propimps_.size() ) );
+  for ( const auto& prop : elem.propimps_ )
+  {
+    put_u32( name_id( prop.first.name() ) );
+    put_value( prop.second.get() );
+  }
+}
+
+void CompiledConfigWriter::write()
+{
+  ImageHeader hdr;
+  std::memcpy( hdr.magic, IMAGE_MAGIC, sizeof hdr.magic );
+  hdr.version = IMAGE_VERSION;
+  hdr.element_count = static_cast<u32>( _offsets.size() );
+  hdr.source_mtime = static_cast<u64>( _modified );
+  hdr.source_size = _size;
+  hdr.source_crc = _crc;
+  hdr.reserved = 0;
+  hdr.names_offset = _data.size();
+  put_u32( static_cast<u32>( _names.size() ) );
+  for ( const auto& name : _names )
+    put_str( name );
+  hdr.index_offset = _data.size();
+  for ( u64 offset : _offsets )
+    _data.append( reinterpret_cast<const char*>( &offset ), sizeof offset );
+  std::memcpy( &_data[0], &hdr, sizeof hdr );
+
+  std::string filename = CompiledConfig::image_filename( _sourcefile );
+  std::string tmpname = filename + ".tmp";
+  {
+    std::ofstream ofs( tmpname, std::ios::binary | std::ios::trunc );
+    ofs.write( _data.data(), _data.size() );
+    ofs.close();
+    if ( !ofs )
+    {
+      POLLOG_ERROR << "Unable to write compiled config " << tmpname << "\n";
+      Clib::RemoveFile( tmpname );
+      return;
+    }
+  }
+  std::remove( filename.c_str() );
+  if ( std::rename( tmpname.c_str(), filename.c_str() ) != 0 )
+  {
+    POLLOG_ERROR << "Unable to rename " << tmpname << " to " << filename << "\n";
+    Clib::RemoveFile( tmpname );
+  }
+}
+}  // namespace Core
+}  // namespace Pol
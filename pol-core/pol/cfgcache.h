@@ -0,0 +1,105 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef CFGCACHE_H
+#define CFGCACHE_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <time.h>
+#include <unordered_map>
+#include <vector>
+
+#include "../clib/atom.h"
+#include "../clib/mappedfile.h"
+#include "../clib/rawtypes.h"
+
+namespace Pol
+{
+namespace Bscript
+{
+class BObjectImp;
+}
+namespace Core
+{
+class StoredConfigElem;
+
+// Compiled image of a config file (pol.cfg ConfigCachePath), so loading it again only maps the
+// image instead of parsing the text and converting the values.
+// The values are stored as they were converted when compiling (integer, double or string), the
+// property names once in a name table. Elements are only decoded when they are used.
+//
+// Layout, native byte order (the cache belongs to the machine which wrote it):
+//   header    "POLCFGC\0", u32 version, u32 element count, u64 source mtime, u64 source size,
+//             u64 offset of the name table, u64 offset of the element index, u32 crc32 of the
+//             source, u32 reserved, str source path
+//   elements  str key, u32 property count, properties: u32 name id, u8 type, value
+//             (type 'l': s32, 'r': double, 's': str; str: u32 length followed by the bytes)
+//   names     u32 count, str names
+//   index     u64 offset per element
+class CompiledConfig
+{
+public:
+  // the image of the source file, nullptr if there is none or the source has changed since
+  static std::shared_ptr<const CompiledConfig> open( const std::string& sourcefile );
+  static std::string image_filename( const std::string& sourcefile );
+  // crc32 of the content, false if the file can't be read
+  static bool source_checksum( const std::string& sourcefile, u32& crc );
+
+  time_t modified() const;
+  size_t element_count() const;
+  std::string element_key( size_t idx ) const;
+  // calls add for each property of the element, in the order of the source
+  void decode_element(
+      size_t idx,
+      const std::function<void( const Clib::Atom&, Bscript::BObjectImp* )>& add ) const;
+  // serializes decoding the elements of this image, config reads don't need the world lock
+  std::mutex& decode_mutex() const;
+
+private:
+  CompiledConfig() = default;
+  // checks the structure of the whole image, false if it's damaged
+  bool validate();
+
+  Clib::MappedFile _file;
+  time_t _modified;
+  u32 _element_count;
+  const char* _index;
+  std::vector<Clib::Atom> _names;
+  mutable std::mutex _decode_mutex;
+};
+
+// Writes the image while the source is loaded
+class CompiledConfigWriter
+{
+public:
+  // mtime, size and checksum of the source before loading it
+  CompiledConfigWriter( const std::string& sourcefile, time_t modified, u64 size, u32 crc );
+
+  void add_element( const std::string& key, const StoredConfigElem& elem );
+  // writes into a temporary file which replaces the image, errors are only logged
+  void write();
+
+private:
+  u32 name_id( const std::string& name );
+  void put_u32( u32 value );
+  void put_str( const std::string& str );
+  void put_value( const Bscript::BObjectImp* imp );
+
+  std::string _sourcefile;
+  time_t _modified;
+  u64 _size;
+  u32 _crc;
+  std::string _data;
+  std::vector<u64> _offsets;
+  std::vector<std::string> _names;
+  std::unordered_map<std::string, u32> _name_ids;
+};
+}  // namespace Core
+}  // namespace Pol
+#endif
@@ -17,11 +17,13 @@
 
 #include "cfgrepos.h"
 
+#include <algorithm>
 #include <ctype.h>
 #include <exception>
 #include <iosfwd>
 #include <stdlib.h>
 #include <sys/stat.h>
+#include <vector>
 
 #include "../bscript/bobject.h"
 #include "../bscript/escrutil.h"
@@ -33,6 +35,7 @@
 #include "../clib/strutil.h"
 #include "../plib/pkg.h"
 #include "../plib/systemstate.h"
+#include "cfgcache.h"
 #include "globals/ucfg.h"
 #include "polcfg.h"
 
@@ -52,6 +55,11 @@ StoredConfigElem::StoredConfigElem( Clib::ConfigElem& elem )
   }
 }
 
+StoredConfigElem::StoredConfigElem( std::shared_ptr<const CompiledConfig> image, size_t image_idx )
+    : propimps_(), decoded_( false ), image_( std::move( image ) ), image_idx_( image_idx )
+{
+}
+
 // ToDo: we have to think over... it's a problem with script-inside references
 StoredConfigElem::~StoredConfigElem()
 {
@@ -64,13 +72,36 @@ StoredConfigElem::~StoredConfigElem()
 
 void StoredConfigElem::addprop( const std::string& propname, Bscript::BObjectImp* imp )
 {
-  propimps_.insert( PropImpList::value_type( boost_utils::cfg_key_flystring( propname ),
+  propimps_.insert( PropImpList::value_type( Clib::Atom( propname ),
                                              ref_ptr<class Bscript::BObjectImp>( imp ) ) );
 }
 
+void StoredConfigElem::addprop( const Clib::Atom& propname, Bscript::BObjectImp* imp )
+{
+  propimps_.insert(
+      PropImpList::value_type( propname, ref_ptr<class Bscript::BObjectImp>( imp ) ) );
+}
+
+void StoredConfigElem::decode() const
+{
+  if ( decoded_.load( std::memory_order_acquire ) )
+    return;
+  std::lock_guard<std::mutex> lock( image_->decode_mutex() );
+  if ( decoded_.load( std::memory_order_relaxed ) )
+    return;
+  image_->decode_element( image_idx_,
+                          [this]( const Clib::Atom& name, Bscript::BObjectImp* imp )
+                          {
+                            propimps_.insert( PropImpList::value_type(
+                                name, ref_ptr<Bscript::BObjectImp>( imp ) ) );
+                          } );
+  decoded_.store( true, std::memory_order_release );
+}
+
 Bscript::BObjectImp* StoredConfigElem::getimp( const std::string& propname ) const
 {
-  PropImpList::const_iterator itr = propimps_.find( boost_utils::cfg_key_flystring( propname ) );
+  decode();
+  PropImpList::const_iterator itr = propimps_.find( Clib::Atom( propname ) );
   if ( itr == propimps_.end() )
     return nullptr;
   else
@@ -79,26 +110,35 @@ Bscript::BObjectImp* StoredConfigElem::getimp( const std::string& propname ) con
 
 Bscript::BObjectImp* StoredConfigElem::listprops() const
 {
+  decode();
+  // the map isn't sorted by name, list the names in case insensitive order
+  std::vector<const Clib::Atom*> names;
+  for ( auto itr = propimps_.begin(); itr != propimps_.end();
+        itr = propimps_.upper_bound( itr->first ) )
+    names.push_back( &itr->first );
+  std::sort( names.begin(), names.end(), []( const Clib::Atom* a, const Clib::Atom* b ) {
+    return a->folded() < b->folded();
+  } );
+
   Bscript::ObjArray* objarr = new Bscript::ObjArray;
-  PropImpList::const_iterator itr;
-  for ( itr = propimps_.begin(); itr != propimps_.end(); ++itr )
-  {
-    Bscript::String propname( ( *itr ).first );
-    if ( !objarr->contains( propname ) )
-      objarr->addElement( propname.copy() );
-  }
+  for ( const Clib::Atom* name : names )
+    objarr->addElement( new Bscript::String( name->name() ) );
   return objarr;
 }
 
 std::pair<StoredConfigElem::const_iterator, StoredConfigElem::const_iterator>
 StoredConfigElem::equal_range( const std::string& propname ) const
 {
-  return propimps_.equal_range( boost_utils::cfg_key_flystring( propname ) );
+  decode();
+  return propimps_.equal_range( Clib::Atom( propname ) );
 }
 
 size_t StoredConfigElem::estimateSize() const
 {
-  size_t size = 0;
+  // the values of an element which isn't decoded yet are in the image
+  size_t size = image_ != nullptr ? sizeof( image_ ) : 0;
+  if ( !decoded_.load( std::memory_order_acquire ) )
+    return size;
   for ( const auto& pair : propimps_ )
   {
     size_t elemsize = sizeof( ref_ptr<Bscript::BObjectImp> );
@@ -127,7 +167,7 @@ StoredConfigFile::StoredConfigFile() : reload( false ), modified_( 0 ) {}
 //  }
 //}
 
-void StoredConfigFile::load( Clib::ConfigFile& cf )
+void StoredConfigFile::load( Clib::ConfigFile& cf, CompiledConfigWriter* writer )
 {
   reload = false;
   modified_ = cf.modified();
@@ -135,17 +175,58 @@ void StoredConfigFile::load( Clib::ConfigFile& cf )
   Clib::ConfigElem elem;
   while ( cf.read( elem ) )
   {
+    std::string key( elem.rest() );
     ElemRef elemref( new StoredConfigElem( elem ) );
+    if ( writer != nullptr )
+      writer->add_element( key, *elemref );
+    add_element( key, elemref );
+  }
+}
 
-    if ( isdigit( elem.rest()[0] ) )
-    {
-      unsigned int key = strtoul( elem.rest(), nullptr, 0 );
-      elements_bynum_.insert( ElementsByNum::value_type( key, elemref ) );
-    }
+void StoredConfigFile::load_file( const std::string& filename )
+{
+  if ( Plib::systemstate.config.config_cache_path.empty() )
+  {
+    Clib::ConfigFile cf( filename.c_str() );
+    load( cf );
+    return;
+  }
 
-    std::string key( elem.rest() );
-    elements_byname_.insert( ElementsByName::value_type( key, elemref ) );
+  std::shared_ptr<const CompiledConfig> image = CompiledConfig::open( filename );
+  if ( image != nullptr )
+  {
+    reload = false;
+    modified_ = image->modified();
+    for ( size_t idx = 0; idx < image->element_count(); ++idx )
+      add_element( image->element_key( idx ), ElemRef( new StoredConfigElem( image, idx ) ) );
+    return;
   }
+
+  // stat and checksum first, a change while reading makes the image outdated instead of wrong
+  struct stat source_stat;
+  u32 source_crc;
+  if ( stat( filename.c_str(), &source_stat ) != 0 ||
+       !CompiledConfig::source_checksum( filename, source_crc ) )
+  {
+    Clib::ConfigFile cf( filename.c_str() );
+    load( cf );
+    return;
+  }
+  CompiledConfigWriter writer( filename, source_stat.st_mtime,
+                               static_cast<u64>( source_stat.st_size ), source_crc );
+  Clib::ConfigFile cf( filename.c_str() );
+  load( cf, &writer );
+  writer.write();
+}
+
+void StoredConfigFile::add_element( const std::string& key, ElemRef elemref )
+{
+  if ( isdigit( key[0] ) )
+  {
+    unsigned int num = strtoul( key.c_str(), nullptr, 0 );
+    elements_bynum_.insert( ElementsByNum::value_type( num, elemref ) );
+  }
+  elements_byname_.insert( ElementsByName::value_type( key, elemref ) );
 }
 
 StoredConfigFile::ElemRef StoredConfigFile::findelem( int key )
@@ -279,8 +360,7 @@ ConfigFileRef FindConfigFile( const std::string& filename, const std::string& al
       std::string main_cfg = "config/" + allpkgbase + ".cfg";
       if ( Clib::FileExists( main_cfg.c_str() ) )
       {
-        Clib::ConfigFile cf_main( main_cfg.c_str() );
-        scfg->load( cf_main );
+        scfg->load_file( main_cfg );
         any = true;
       }
       for ( Plib::Packages::iterator pitr = Plib::systemstate.packages.begin(),
@@ -292,8 +372,7 @@ ConfigFileRef FindConfigFile( const std::string& filename, const std::string& al
         std::string pkgfilename = GetPackageCfgPath( pkg, allpkgbase + ".cfg" );
         if ( Clib::FileExists( pkgfilename.c_str() ) )
         {
-          Clib::ConfigFile cf( pkgfilename.c_str() );
-          scfg->load( cf );
+          scfg->load_file( pkgfilename );
           any = true;
         }
       }
@@ -313,10 +392,8 @@ ConfigFileRef FindConfigFile( const std::string& filename, const std::string& al
         return ConfigFileRef( nullptr );
       }
 
-      Clib::ConfigFile cf( filename.c_str() );
-
       ref_ptr<StoredConfigFile> scfg( new StoredConfigFile() );
-      scfg->load( cf );
+      scfg->load_file( filename );
       Core::configurationbuffer.cfgfiles.insert( CfgFiles::value_type( filename, scfg ) );
       return scfg;
     }
@@ -13,11 +13,14 @@
 
 #include "pol_global_config.h"
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <string>
 #include <time.h>
 #include <utility>
 
+#include "../clib/atom.h"
 #include "../clib/boostutils.h"
 #include "../clib/maputil.h"
 #include "../clib/refptr.h"
@@ -35,16 +38,20 @@ class ConfigFile;
 }
 namespace Core
 {
+class CompiledConfig;
+class CompiledConfigWriter;
+
 class StoredConfigElem : public ref_counted
 {
 private:
-  typedef std::multimap<boost_utils::cfg_key_flystring, ref_ptr<Bscript::BObjectImp>,
-                        Clib::ci_cmp_pred>
-      PropImpList;
+  // property names compare as atoms, repeated properties keep their order
+  typedef std::multimap<Clib::Atom, ref_ptr<Bscript::BObjectImp>, Clib::AtomIdLess> PropImpList;
 
 public:
   StoredConfigElem() = default;
   StoredConfigElem( Clib::ConfigElem& elem );
+  // element of a compiled config, decoded when it's used the first time
+  StoredConfigElem( std::shared_ptr<const CompiledConfig> image, size_t image_idx );
   ~StoredConfigElem();
 
   StoredConfigElem( const StoredConfigElem& elem ) = delete;
@@ -55,12 +62,20 @@ public:
   Bscript::BObjectImp* getimp( const std::string& propname ) const;
   Bscript::BObjectImp* listprops() const;
   void addprop( const std::string& propname, Bscript::BObjectImp* imp );
+  void addprop( const Clib::Atom& propname, Bscript::BObjectImp* imp );
 
   typedef StoredConfigElem::PropImpList::const_iterator const_iterator;
   std::pair<const_iterator, const_iterator> equal_range( const std::string& propname ) const;
 
 private:
-  PropImpList propimps_;
+  friend class CompiledConfigWriter;
+  // fills the property cache from the image on first use, locked by the image
+  void decode() const;
+
+  mutable PropImpList propimps_;
+  mutable std::atomic<bool> decoded_{ true };
+  std::shared_ptr<const CompiledConfig> image_;
+  size_t image_idx_ = 0;
 };
 
 class StoredConfigFile : public ref_counted
@@ -68,7 +83,9 @@ class StoredConfigFile : public ref_counted
 public:
   StoredConfigFile();
   //    ~StoredConfigFile();
-  void load( Clib::ConfigFile& cf );
+  void load( Clib::ConfigFile& cf, CompiledConfigWriter* writer = nullptr );
+  // loads the file from its compiled image if there's a current one (pol.cfg ConfigCachePath)
+  void load_file( const std::string& filename );
   void load_tus_scp( const std::string& filename );
   size_t estimateSize() const;
 
@@ -87,6 +104,8 @@ public:
   ElementsByNum::const_iterator bynum_end() { return elements_bynum_.end(); }
   bool reload;  // try to reload cfg file?
 private:
+  void add_element( const std::string& key, ElemRef elemref );
+
   ElementsByName elements_byname_;
 
   ElementsByNum elements_bynum_;
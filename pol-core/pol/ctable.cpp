@@ -6,6 +6,9 @@
 
 #include "ctable.h"
 
+#include "../clib/passert.h"
+#include "../clib/rawtypes.h"
+
 namespace Pol
 {
 namespace Core
@@ -77,5 +80,50 @@ SVR_KEYDESC keydesc[257] = {
     {9, 0x0167, 0x01cd},  {10, 0x0210, 0x0021}, {10, 0x023a, 0x0171}, {10, 0x01b8, 0x0076},
     {11, 0x03af, 0x07ae}, {10, 0x018e, 0x01c6}, {10, 0x02ec, 0x00dd}, {7, 0x0062, 0x0023},
     {4, 0x000d, 0x000b}};
+
+namespace
+{
+// appends the code MSB first to the accumulator, full 32 bit words are written big endian
+inline void huffman_put( const SVR_KEYDESC& code, u64& acc, unsigned int& nacc,
+                         unsigned char*& pch, const unsigned char* end )
+{
+  acc = ( acc << code.nbits ) | code.bits;
+  nacc += code.nbits;
+  if ( nacc >= 32 )
+  {
+    nacc -= 32;
+    passert_always( end - pch >= 4 );
+    u32 word = static_cast<u32>( acc >> nacc );
+    pch[0] = static_cast<unsigned char>( word >> 24 );
+    pch[1] = static_cast<unsigned char>( word >> 16 );
+    pch[2] = static_cast<unsigned char>( word >> 8 );
+    pch[3] = static_cast<unsigned char>( word );
+    pch += 4;
+  }
+}
+}  // namespace
+
+size_t huffman_compress( const unsigned char* data, size_t len, unsigned char* out,
+                         size_t out_size )
+{
+  u64 acc = 0;
+  unsigned int nacc = 0;  // pending bits in acc, always less than 32 between codes
+  unsigned char* pch = out;
+  const unsigned char* end = out + out_size;
+  for ( size_t i = 0; i < len; ++i )
+    huffman_put( keydesc[data[i]], acc, nacc, pch, end );
+  huffman_put( keydesc[0x100], acc, nacc, pch, end );
+
+  // remaining bits, the last byte is padded with zero bits
+  passert_always( end - pch >= static_cast<ptrdiff_t>( ( nacc + 7 ) / 8 ) );
+  while ( nacc >= 8 )
+  {
+    nacc -= 8;
+    *pch++ = static_cast<unsigned char>( acc >> nacc );
+  }
+  if ( nacc )
+    *pch++ = static_cast<unsigned char>( acc << ( 8 - nacc ) );
+  return pch - out;
+}
 }
 }
\ No newline at end of file
@@ -5,6 +5,9 @@
 
 #ifndef __CTABLE_H
 #define __CTABLE_H
+
+#include <stddef.h>
+
 namespace Pol
 {
 namespace Core
@@ -18,6 +21,11 @@ struct SVR_KEYDESC
 
 // last one is a terminator
 extern SVR_KEYDESC keydesc[257];
+
+// Huffman compresses len bytes of data plus the terminator into out, returns the compressed
+// size. Fails a passert if out_size is too small.
+size_t huffman_compress( const unsigned char* data, size_t len, unsigned char* out,
+                         size_t out_size );
 }
 }
 #endif
@@ -176,6 +176,7 @@ enum DynPropTypes : u8
   PROP_SWING_SPEED_INCREASE = 89,        // UObject
   PROP_SWING_SPEED_INCREASE_MOD = 90,    // UObject
   PROP_ORIG_SWING_SPEED_INCREASE = 91,   // Npc
+  PROP_AOS_TOOLTIP = 92,                 // UObject
 
   PROP_FLAG_SIZE  // used for bitset size
 };
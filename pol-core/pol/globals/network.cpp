@@ -10,10 +10,12 @@
 #include "../accounts/account.h"
 #include "../mobile/charactr.h"
 #include "../network/auxclient.h"
+#include "../network/clienteventloop.h"
 #include "../network/clienttransmit.h"
 #include "../network/cliface.h"
 #include "../network/msgfiltr.h"
 #include "../network/msghandl.h"
+#include "../network/packetdispatch.h"
 #include "../network/packethooks.h"
 #include "../network/packetinterface.h"
 #include "../network/sockio.h"
@@ -51,6 +53,8 @@ NetworkManager::NetworkManager()
       ext_handler_table(),
       packetsSingleton( new Network::PacketsSingleton() ),
       clientTransmit( new Network::ClientTransmit() ),
+      packetDispatch( new Network::PacketDispatch() ),
+      clientEventLoop( nullptr ),
       auxthreadpool( new threadhelp::DynTaskThreadPool( "AuxPool" ) ),  // TODO: seems to work
                                                                         // activate by default?
                                                                         // maybe add a cfg entry for
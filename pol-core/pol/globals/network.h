@@ -20,7 +20,9 @@ namespace Network
 {
 class AuxService;
 class Client;
+class ClientEventLoop;
 class ClientTransmit;
+class PacketDispatch;
 class PacketHookData;
 class PacketsSingleton;
 class UOClientInterface;
@@ -97,6 +99,9 @@ public:
   std::unique_ptr<Network::PacketsSingleton> packetsSingleton;
 
   std::unique_ptr<Network::ClientTransmit> clientTransmit;
+  std::unique_ptr<Network::PacketDispatch> packetDispatch;
+  // only set if pol.cfg NetworkEventLoopThreads is used
+  std::unique_ptr<Network::ClientEventLoop> clientEventLoop;
 
   std::unique_ptr<threadhelp::DynTaskThreadPool> auxthreadpool;
 
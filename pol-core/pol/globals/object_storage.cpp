@@ -22,6 +22,7 @@ ObjectStorageManager::ObjectStorageManager()
       clean_objects( 0 ),
       dirty_objects( 0 ),
       incremental_saves_disabled( false ),
+      journal(),
       objecthash()
 {
 }
@@ -31,6 +32,7 @@ ObjectStorageManager::~ObjectStorageManager() {}
 
 void ObjectStorageManager::deinitialize()
 {
+  journal.close();
   objecthash.Clear();
   incremental_serial_index.clear();
   deferred_insertions.clear();
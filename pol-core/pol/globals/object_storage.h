@@ -9,6 +9,7 @@
 #include "../../clib/rawtypes.h"
 #include "../../plib/poltype.h"
 #include "../objecthash.h"
+#include "../savejournal.h"
 
 namespace Pol
 {
@@ -40,6 +41,7 @@ public:
   unsigned int clean_objects;
   unsigned int dirty_objects;
   bool incremental_saves_disabled;
+  SaveJournal journal;
 
   ObjectHash objecthash;
 
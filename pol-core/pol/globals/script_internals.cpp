@@ -1,10 +1,12 @@
 #include "script_internals.h"
 
 #include <string.h>
+#include <vector>
 
 #include "../../clib/logfacility.h"
 #include "../../clib/passert.h"
 #include "../../clib/stlutil.h"
+#include "../../clib/threadhelp.h"
 #include "../../plib/systemstate.h"
 #include "../polsig.h"
 #include "../uoexec.h"
@@ -31,7 +33,8 @@ ScriptScheduler::ScriptScheduler()
       notimeoutholdlist(),
       debuggerholdlist(),
       pidlist(),
-      next_pid( PID_MIN )
+      next_pid( PID_MIN ),
+      detached_pool()
 {
 }
 
@@ -43,12 +46,16 @@ ScriptScheduler::~ScriptScheduler() {}
 // before cleanup_scripts() is called.
 void ScriptScheduler::deinitialize()
 {
+  // finishes the detached scripts, they deliver their results to the executors deleted below
+  detached_pool.reset();
   scrstore.clear();
   Clib::delete_all( runlist );
-  while ( !holdlist.empty() )
+  std::vector<UOExecutor*> held;
+  holdlist.for_each( [&]( UOExecutor* exec ) { held.push_back( exec ); } );
+  for ( auto& exec : held )
   {
-    delete ( ( *holdlist.begin() ).second );
-    holdlist.erase( holdlist.begin() );
+    holdlist.erase( exec->hold_link() );
+    delete exec;
   }
   while ( !notimeoutholdlist.empty() )
   {
@@ -113,18 +120,16 @@ ScriptScheduler::Memory ScriptScheduler::estimateSize( bool verbose ) const
   }
   usage.script_count += ranlist.size();
 
+  usage.script_size += sizeof( HoldList );
   if ( verbose )
     verbose_w << "holdlist:\n";
-  for ( const auto& hold : holdlist )
-  {
-    if ( hold.second != nullptr )
-    {
-      usage.script_size += hold.second->sizeEstimate();
-      if ( verbose )
-        verbose_w << hold.second->scriptname() << " " << hold.second->sizeEstimate() << "\n";
-    }
-    usage.script_size += sizeof( Core::polclock_t ) + ( sizeof( void* ) * 3 + 1 ) / 2;
-  }
+  holdlist.for_each(
+      [&]( UOExecutor* hold )
+      {
+        usage.script_size += hold->sizeEstimate();
+        if ( verbose )
+          verbose_w << hold->scriptname() << " " << hold->sizeEstimate() << "\n";
+      } );
   usage.script_count += holdlist.size();
 
   usage.script_size += 3 * sizeof( void* );
@@ -292,7 +297,7 @@ void ScriptScheduler::run_ready()
       if ( ex->sleep_until_clock() )
       {
         ex->in_hold_list( Core::HoldListType::TIMEOUT_LIST );
-        ex->hold_itr( holdlist.insert( HoldList::value_type( ex->sleep_until_clock(), ex ) ) );
+        holdlist.insert( ex->hold_link(), ex, ex->sleep_until_clock() );
       }
       else
       {
@@ -322,6 +327,13 @@ void ScriptScheduler::schedule( UOExecutor* exec )
   enqueue( exec );
 }
 
+void ScriptScheduler::run_detached( const std::function<void()>& task )
+{
+  if ( !detached_pool )
+    detached_pool.reset( new threadhelp::TaskThreadPool( "DetachedScripts" ) );
+  detached_pool->push( task );
+}
+
 unsigned int ScriptScheduler::get_new_pid( UOExecutor* exec )
 {
   for ( ;; )
@@ -375,11 +387,12 @@ bool ScriptScheduler::logScriptVariables( const std::string& name ) const
     if ( exec != nullptr && stricmp( exec->scriptname().c_str(), name.c_str() ) == 0 )
       scripts.push_back( exec );
   }
-  for ( const auto& exec : holdlist )
-  {
-    if ( exec.second != nullptr && stricmp( exec.second->scriptname().c_str(), name.c_str() ) == 0 )
-      scripts.push_back( exec.second );
-  }
+  holdlist.for_each(
+      [&]( UOExecutor* exec )
+      {
+        if ( stricmp( exec->scriptname().c_str(), name.c_str() ) == 0 )
+          scripts.push_back( exec );
+      } );
   for ( const auto& exec : notimeoutholdlist )
   {
     if ( exec != nullptr && stricmp( exec->scriptname().c_str(), name.c_str() ) == 0 )
@@ -446,12 +459,18 @@ void ScriptScheduler::revive_debugged( UOExecutor* exec )
   enqueue( exec );
 }
 
-void ScriptScheduler::revive_timeout( UOExecutor* exec, TimeoutHandle hold_itr )
+void ScriptScheduler::revive_timeout( UOExecutor* exec )
 {
-  holdlist.erase( hold_itr );
+  holdlist.erase( exec->hold_link() );
   enqueue( exec );
 }
 
+UOExecutor* ScriptScheduler::next_expired( polclock_t now_clock )
+{
+  HoldListLink* link = holdlist.front_expired( now_clock );
+  return link != nullptr ? link->exec : nullptr;
+}
+
 void ScriptScheduler::revive_notimeout( UOExecutor* exec )
 {
   notimeoutholdlist.erase( exec );
@@ -2,26 +2,31 @@
 #define GLOBALS_SCRIPT_INTERNALS_H
 
 #include <deque>
+#include <functional>
 #include <map>
+#include <memory>
 #include <set>
 
 #include "../../bscript/eprog.h"
 #include "../../clib/maputil.h"
+#include "../holdlist.h"
 #include "../polclock.h"
 #include "../reftypes.h"
 
 namespace Pol
 {
+namespace threadhelp
+{
+class TaskThreadPool;
+}
 namespace Core
 {
 class UOExecutor;
 
 typedef std::deque<UOExecutor*> ExecList;
 typedef std::set<UOExecutor*> NoTimeoutHoldList;
-typedef std::multimap<Core::polclock_t, Core::UOExecutor*> HoldList;
 typedef std::map<std::string, ref_ptr<Bscript::EScriptProgram>, Clib::ci_cmp_pred> ScriptStorage;
 typedef std::map<unsigned int, UOExecutor*> PidList;
-typedef HoldList::iterator TimeoutHandle;
 
 
 enum HoldListType
@@ -80,17 +85,23 @@ public:
 
   const PidList& getPidlist();
 
-  // void revive_timeout(UOExecutor* exec);
-  void revive_timeout( UOExecutor* exec, TimeoutHandle hold_itr );
+  void revive_timeout( UOExecutor* exec );
   void revive_notimeout( UOExecutor* exec );
   void revive_debugged( UOExecutor* exec );
 
+  // Returns the first executor whose timeout is due, it stays in the holdlist until revived.
+  UOExecutor* next_expired( polclock_t now_clock );
+
   // Adds a new executor to the queue directly
   void enqueue( UOExecutor* exec );
 
   // Sets up the executor before adding to the queue
   void schedule( UOExecutor* exec );
 
+  // Runs the task on the worker threads of the detached scripts, without the world lock.
+  // The workers are started with the first task.
+  void run_detached( const std::function<void()>& task );
+
 
   // The following methods should go to a different class,
   // together with the pidlist and new_pid.
@@ -113,6 +124,8 @@ private:
 
   PidList pidlist;
   unsigned int next_pid;
+
+  std::unique_ptr<threadhelp::TaskThreadPool> detached_pool;
 };
 
 const inline ExecList& ScriptScheduler::getRanlist()
@@ -164,6 +164,7 @@ GameState::GameState()
       landtiles(),
       landtiles_loaded( false ),
       listen_points(),
+      listen_point_index(),
       wwwroot_pkg( nullptr ),
       mime_types(),
       task_queue(),
@@ -376,6 +377,9 @@ void GameState::clear_listen_points()
     lp_pair.second = nullptr;
   }
   listen_points.clear();
+  listen_point_index.zoned.clear();
+  listen_point_index.zoned_ranges.clear();
+  listen_point_index.others.clear();
 }
 
 void GameState::unload_intrinsic_weapons()
@@ -587,6 +591,8 @@ GameState::Memory GameState::estimateSize() const
   usage.misc += ( sizeof( UOExecutor* ) + sizeof( ListenPoint* ) + sizeof( ListenPoint ) +
                   ( sizeof( void* ) * 3 + 1 ) / 2 ) *
                 listen_points.size();
+  usage.misc += ( sizeof( void* ) * 4 + sizeof( u16 ) ) * listen_point_index.zoned.size() +
+                ( sizeof( void* ) * 3 + 1 ) * listen_point_index.others.size();
   for ( const auto& elem : mime_types )
   {
     usage.misc += elem.first.capacity() + elem.second.capacity() + ( sizeof( void* ) * 3 + 1 ) / 2;
@@ -24,6 +24,7 @@
 #include "../action.h"
 #include "../cmdlevel.h"
 #include "../layers.h"
+#include "../listenpt.h"
 #include "../menu.h"
 #include "../reftypes.h"
 #include "../schedule.h"
@@ -226,6 +227,7 @@ public:
   bool landtiles_loaded;
 
   ListenPoints listen_points;
+  ListenPointIndex listen_point_index;
 
   Plib::Package* wwwroot_pkg;
   std::map<std::string, std::string> mime_types;
@@ -0,0 +1,196 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "holdlist.h"
+
+#include <algorithm>
+
+#include "../clib/passert.h"
+
+namespace Pol
+{
+namespace Core
+{
+namespace
+{
+unsigned level_shift( unsigned level )
+{
+  return level == 0 ? 0 : HoldList::LEVEL0_BITS + ( level - 1 ) * HoldList::LEVEL_BITS;
+}
+
+size_t slot_index( unsigned level, polclock_t clock )
+{
+  const size_t level0_size = size_t( 1 ) << HoldList::LEVEL0_BITS;
+  const size_t level_size = size_t( 1 ) << HoldList::LEVEL_BITS;
+  if ( level == 0 )
+    return static_cast<size_t>( clock ) & ( level0_size - 1 );
+  return level0_size + ( level - 1 ) * level_size +
+         ( static_cast<size_t>( clock >> level_shift( level ) ) & ( level_size - 1 ) );
+}
+}  // namespace
+
+HoldListLink::HoldListLink()
+    : prev( nullptr ), next( nullptr ), exec( nullptr ), until( 0 ), level( 0 )
+{
+}
+
+HoldList::HoldList() : slots_(), expired_(), level_sizes_(), current_( 0 ), size_( 0 )
+{
+  for ( auto& head : slots_ )
+    head.prev = head.next = &head;
+  expired_.prev = expired_.next = &expired_;
+}
+
+HoldListLink& HoldList::slot( unsigned level, polclock_t clock )
+{
+  return slots_[slot_index( level, clock )];
+}
+
+void HoldList::insert( HoldListLink& link, UOExecutor* exec, polclock_t until )
+{
+  passert( !link.linked() );
+  link.exec = exec;
+  link.until = until;
+  place( link );
+  ++size_;
+}
+
+void HoldList::erase( HoldListLink& link )
+{
+  passert( link.linked() );
+  link.prev->next = link.next;
+  link.next->prev = link.prev;
+  link.prev = link.next = nullptr;
+  --level_sizes_[link.level];
+  --size_;
+}
+
+// appends the link to the slot of the lowest level which can hold its delay
+void HoldList::place( HoldListLink& link )
+{
+  polclock_t at = link.until;
+  unsigned level = 0;
+  HoldListLink* head = &expired_;  // clock of the link was already processed
+  if ( at >= current_ )
+  {
+    const polclock_t delta = at - current_;
+    while ( level + 1 < LEVELS && delta >= ( polclock_t( 1 ) << level_shift( level + 1 ) ) )
+      ++level;
+    const polclock_t max_delta = polclock_t( 1 ) << ( level_shift( LEVELS - 1 ) + LEVEL_BITS );
+    if ( delta >= max_delta )
+    {
+      // beyond the wheel, gets placed again once the last slot in reach is cascaded
+      at = current_ + max_delta - 1;
+    }
+    head = &slot( level, at );
+  }
+
+  link.prev = head->prev;
+  link.next = head;
+  head->prev->next = &link;
+  head->prev = &link;
+  link.level = level;
+  ++level_sizes_[level];
+}
+
+// sets the current clock and cascades the slots of all levels which wrapped around
+void HoldList::advance_to( polclock_t clock )
+{
+  current_ = clock;
+  for ( unsigned level = 1; level < LEVELS; ++level )
+  {
+    const polclock_t mask = ( polclock_t( 1 ) << level_shift( level ) ) - 1;
+    if ( current_ & mask )
+      break;
+    cascade( level );
+  }
+}
+
+// distributes the slot of the given level which the current clock reached to the lower levels
+void HoldList::cascade( unsigned level )
+{
+  HoldListLink& head = slot( level, current_ );
+  if ( head.next == &head )
+    return;
+  HoldListLink* link = head.next;
+  head.prev->next = nullptr;
+  head.prev = head.next = &head;
+  while ( link != nullptr )
+  {
+    HoldListLink* next = link->next;
+    --level_sizes_[level];
+    place( *link );
+    link = next;
+  }
+}
+
+unsigned HoldList::lowest_used_level() const
+{
+  unsigned level = 0;
+  while ( level + 1 < LEVELS && level_sizes_[level] == 0 )
+    ++level;
+  return level;
+}
+
+HoldListLink* HoldList::front_expired( polclock_t now_clock )
+{
+  if ( expired_.next != &expired_ )
+    return expired_.next;
+  if ( size_ == 0 )
+  {
+    current_ = std::max( current_, now_clock );
+    return nullptr;
+  }
+  while ( current_ <= now_clock )
+  {
+    const unsigned level = lowest_used_level();
+    if ( level == 0 )
+    {
+      HoldListLink& head = slot( 0, current_ );
+      if ( head.next != &head )
+        return head.next;
+      advance_to( current_ + 1 );
+    }
+    else
+    {
+      // nothing can get due before the next slot of the lowest used level is cascaded
+      const unsigned shift = level_shift( level );
+      const polclock_t next_cascade = ( ( current_ >> shift ) + 1 ) << shift;
+      if ( next_cascade > now_clock + 1 )
+        current_ = now_clock + 1;
+      else
+        advance_to( next_cascade );
+    }
+  }
+  return nullptr;
+}
+
+polclock_t HoldList::clocks_left( polclock_t now_clock, polclock_t max_clocks ) const
+{
+  if ( size_ == 0 )
+    return max_clocks;
+  if ( expired_.next != &expired_ )
+    return 0;
+  // the first level holds the exact clocks up to its wrap around, everything else is due at the
+  // earliest when the next slot of the lowest used level gets cascaded
+  const unsigned shift = level_shift( std::max( lowest_used_level(), 1u ) );
+  const polclock_t next_cascade = ( ( current_ >> shift ) + 1 ) << shift;
+  polclock_t clock = current_;
+  if ( level_sizes_[0] > 0 )
+  {
+    for ( ; clock < next_cascade; ++clock )
+    {
+      const HoldListLink& head = slots_[slot_index( 0, clock )];
+      if ( head.next != &head )
+        break;
+    }
+  }
+  else
+    clock = next_cascade;
+  return std::min( std::max( clock - now_clock, polclock_t( 0 ) ), max_clocks );
+}
+}  // namespace Core
+}  // namespace Pol
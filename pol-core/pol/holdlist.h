@@ -0,0 +1,113 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef HOLDLIST_H
+#define HOLDLIST_H
+
+#include <array>
+#include <stddef.h>
+
+#include "polclock.h"
+
+namespace Pol
+{
+namespace Core
+{
+class UOExecutor;
+
+// embedded into every executor, links it into one slot of the HoldList
+struct HoldListLink
+{
+  HoldListLink();
+  HoldListLink( const HoldListLink& ) = delete;
+  HoldListLink& operator=( const HoldListLink& ) = delete;
+  bool linked() const;
+
+  HoldListLink* prev;
+  HoldListLink* next;
+  UOExecutor* exec;
+  polclock_t until;
+  unsigned level;
+};
+
+// Executors sleeping until a given clock, stored in a hierarchical timing wheel.
+// The first level has one slot per clock tick, every further level covers the whole range of the
+// level below with each of its slots. Slots of the upper levels get distributed to the lower ones
+// once the current clock reaches them. Inserting and removing is O(1), the links are part of the
+// executors so nothing gets allocated.
+class HoldList
+{
+public:
+  HoldList();
+  HoldList( const HoldList& ) = delete;
+  HoldList& operator=( const HoldList& ) = delete;
+
+  void insert( HoldListLink& link, UOExecutor* exec, polclock_t until );
+  void erase( HoldListLink& link );
+
+  // advances the wheel up to now_clock and returns the first link which is due, without removing
+  // it. nullptr if none is due.
+  HoldListLink* front_expired( polclock_t now_clock );
+  // clocks until the next link could be due, never more than max_clocks
+  polclock_t clocks_left( polclock_t now_clock, polclock_t max_clocks ) const;
+
+  size_t size() const;
+  bool empty() const;
+
+  template <typename F>
+  void for_each( F&& f ) const;
+
+  static const unsigned LEVEL0_BITS = 8;
+  static const unsigned LEVEL_BITS = 6;
+  static const unsigned LEVELS = 5;
+
+private:
+  static const size_t LEVEL0_SIZE = size_t( 1 ) << LEVEL0_BITS;
+  static const size_t LEVEL_SIZE = size_t( 1 ) << LEVEL_BITS;
+  static const size_t SLOT_COUNT = LEVEL0_SIZE + ( LEVELS - 1 ) * LEVEL_SIZE;
+
+  HoldListLink& slot( unsigned level, polclock_t clock );
+  void place( HoldListLink& link );
+  void advance_to( polclock_t clock );
+  void cascade( unsigned level );
+  unsigned lowest_used_level() const;
+
+  std::array<HoldListLink, SLOT_COUNT> slots_;  // list heads
+  HoldListLink expired_;  // links inserted after their clock was processed
+  std::array<size_t, LEVELS> level_sizes_;
+  polclock_t current_;  // next clock to process
+  size_t size_;
+};
+
+inline bool HoldListLink::linked() const
+{
+  return next != nullptr;
+}
+
+inline size_t HoldList::size() const
+{
+  return size_;
+}
+
+inline bool HoldList::empty() const
+{
+  return size_ == 0;
+}
+
+template <typename F>
+void HoldList::for_each( F&& f ) const
+{
+  for ( const HoldListLink* link = expired_.next; link != &expired_; link = link->next )
+    f( link->exec );
+  for ( const auto& head : slots_ )
+  {
+    for ( const HoldListLink* link = head.next; link != &head; link = link->next )
+      f( link->exec );
+  }
+}
+}  // namespace Core
+}  // namespace Pol
+#endif
@@ -33,6 +33,7 @@
 #include "../objtype.h"
 #include "../polcfg.h"
 #include "../proplist.h"
+#include "../realms/realm.h"
 #include "../scrdef.h"
 #include "../scrsched.h"
 #include "../scrstore.h"
@@ -918,6 +919,8 @@ bool Item::setgraphic( u16 newgraphic )
     else
       facing = id.facing;
 
+    if ( in_zone() )
+      realm()->invalidate_los( pos2d() );
     increv();
     update_item_to_inrange( this );
     return true;
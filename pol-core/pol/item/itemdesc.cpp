@@ -45,6 +45,7 @@
 #include "../network/pktdef.h"
 #include "../proplist.h"
 #include "../syshookscript.h"
+#include "../tooltips.h"
 #include "../uobject.h"
 #include "armrtmpl.h"
 #include "regions/resource.h"
@@ -1177,7 +1178,7 @@ const ItemDesc* CreateItemDescriptor( Bscript::BStruct* itemdesc_struct )
   Bscript::BStruct::Contents::const_iterator itr;
   for ( itr = struct_cont.begin(); itr != struct_cont.end(); ++itr )
   {
-    const std::string& key = ( *itr ).first;
+    const std::string& key = ( *itr ).first.name();
     Bscript::BObjectImp* val_imp = ( *itr ).second->impptr();
 
     if ( key == "CProps" )
@@ -1404,6 +1405,7 @@ void load_itemdesc()
     load_package_itemdesc( pkg );
 
   write_objtypes_txt();
+  Core::invalidate_aos_tooltips();
 }
 
 void unload_itemdesc()
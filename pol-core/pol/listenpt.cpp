@@ -13,24 +13,88 @@
 #include <algorithm>
 #include <limits>
 #include <stddef.h>
+#include <vector>
 
 #include "../bscript/bobject.h"
 #include "../plib/uconst.h"
 #include "globals/settings.h"
 #include "globals/uvars.h"
+#include "item/item.h"
 #include "mobile/charactr.h"
 #include "uoexec.h"
 #include "uoscrobj.h"
+#include "uworld.h"
 
 namespace Pol
 {
 namespace Core
 {
 ListenPoint::ListenPoint( UObject* obj, UOExecutor* uoexec, u16 range, int flags )
-    : object( obj ), uoexec( uoexec ), range( range ), flags( flags )
+    : object( obj ), uoexec( uoexec ), range( range ), flags( flags ), zoned( false )
 {
 }
 
+void ListenPoint::index()
+{
+  auto& lp_index = gamestate.listen_point_index;
+  object->listen_point( true );
+  // the zones only have toplevel items and mobiles, multis are not searched
+  zoned = range <= LISTENPT_ZONE_RANGE && object->in_zone() && !object->ismulti();
+  if ( zoned )
+  {
+    lp_index.zoned.emplace( object.get(), this );
+    lp_index.zoned_ranges.insert( range );
+  }
+  else
+    lp_index.others.insert( this );
+}
+
+void ListenPoint::unindex()
+{
+  auto& lp_index = gamestate.listen_point_index;
+  if ( zoned )
+  {
+    auto lps = lp_index.zoned.equal_range( object.get() );
+    for ( auto itr = lps.first; itr != lps.second; ++itr )
+    {
+      if ( itr->second == this )
+      {
+        lp_index.zoned.erase( itr );
+        break;
+      }
+    }
+    lp_index.zoned_ranges.erase( lp_index.zoned_ranges.find( range ) );
+  }
+  else
+    lp_index.others.erase( this );
+}
+
+void ListenPoint::remove( ListenPoint* lp )
+{
+  lp->unindex();
+  gamestate.listen_points.erase( lp->uoexec );
+  delete lp;
+}
+
+void ListenPoint::zone_changed( const UObject* obj )
+{
+  auto& lp_index = gamestate.listen_point_index;
+  std::vector<ListenPoint*> lps;
+  auto zoned_lps = lp_index.zoned.equal_range( obj );
+  for ( auto itr = zoned_lps.first; itr != zoned_lps.second; ++itr )
+    lps.push_back( itr->second );
+  for ( auto& lp : lp_index.others )
+  {
+    if ( lp->object.get() == obj )
+      lps.push_back( lp );
+  }
+  for ( auto& lp : lps )
+  {
+    lp->unindex();
+    lp->index();
+  }
+}
+
 std::string ListenPoint::TextTypeToString( u8 texttype )
 {
   switch ( texttype )
@@ -50,23 +114,42 @@ void ListenPoint::sayto_listening_points( Mobile::Character* speaker, const std:
                                           u8 texttype, const char* p_lang,
                                           Bscript::ObjArray* speechtokens )
 {
-  ListenPoints::iterator itr = gamestate.listen_points.begin();
-  while ( itr != gamestate.listen_points.end() )
+  auto& lp_index = gamestate.listen_point_index;
+  const std::string texttype_str = TextTypeToString( texttype );
+  if ( !lp_index.zoned_ranges.empty() )
   {
-    ListenPoint* lp = itr->second;
+    auto hear = [&]( const UObject* obj )
+    {
+      if ( !obj->listen_point() )
+        return;
+      auto lps = lp_index.zoned.equal_range( obj );
+      for ( auto itr = lps.first; itr != lps.second; ++itr )
+        itr->second->sayto( speaker, text, texttype_str, p_lang, speechtokens );
+    };
+    const u16 max_range = *lp_index.zoned_ranges.rbegin();
+    WorldIterator<MobileFilter>::InRange( speaker->pos(), max_range,
+                                          [&]( Mobile::Character* chr ) { hear( chr ); } );
+    WorldIterator<ItemFilter>::InRange( speaker->pos(), max_range,
+                                        [&]( Items::Item* item ) { hear( item ); } );
+  }
+
+  auto itr = lp_index.others.begin();
+  while ( itr != lp_index.others.end() )
+  {
+    ListenPoint* lp = *itr;
+    ++itr;
     if ( lp->object->orphan() )
     {
-      itr = gamestate.listen_points.erase( itr );
-      delete lp;
+      remove( lp );
       continue;
     }
-    ++itr;
-    lp->sayto( speaker, text, texttype, p_lang, speechtokens );
+    lp->sayto( speaker, text, texttype_str, p_lang, speechtokens );
   }
 }
 
-void ListenPoint::sayto( Mobile::Character* speaker, const std::string& text, u8 texttype,
-                         const char* p_lang, Bscript::ObjArray* speechtokens ) const
+void ListenPoint::sayto( Mobile::Character* speaker, const std::string& text,
+                         const std::string& texttype, const char* p_lang,
+                         Bscript::ObjArray* speechtokens ) const
 {
   if ( speaker->dead() && !( flags & LISTENPT_HEAR_GHOSTS ) )
     return;
@@ -80,10 +163,10 @@ void ListenPoint::sayto( Mobile::Character* speaker, const std::string& text, u8
   if ( !speaker->in_range( object.get(), range ) )
     return;
   if ( p_lang )
-    uoexec->signal_event( new Module::SpeechEvent( speaker, text, TextTypeToString( texttype ),
-                                                   p_lang, speechtokens ) );
+    uoexec->signal_event(
+        new Module::SpeechEvent( speaker, text, texttype, p_lang, speechtokens ) );
   else
-    uoexec->signal_event( new Module::SpeechEvent( speaker, text, TextTypeToString( texttype ) ) );
+    uoexec->signal_event( new Module::SpeechEvent( speaker, text, texttype ) );
 }
 
 void ListenPoint::deregister_from_speech_events( UOExecutor* uoexec )
@@ -91,21 +174,20 @@ void ListenPoint::deregister_from_speech_events( UOExecutor* uoexec )
   ListenPoints::iterator itr = gamestate.listen_points.find( uoexec );
   if ( itr !=
        gamestate.listen_points.end() )  // could have been cleaned up in sayto_listening_points
-  {
-    ListenPoint* lp = itr->second;
-    gamestate.listen_points.erase( uoexec );
-    delete lp;
-  }
+    remove( itr->second );
 }
 
 void ListenPoint::register_for_speech_events( UObject* obj, UOExecutor* uoexec, int range,
                                               int flags )
 {
-  gamestate.listen_points[uoexec] =
+  deregister_from_speech_events( uoexec );
+  ListenPoint* lp =
       new ListenPoint( obj, uoexec,
                        static_cast<u16>( std::clamp(
                            range, 0, static_cast<int>( std::numeric_limits<u16>::max() ) ) ),
                        flags );
+  gamestate.listen_points[uoexec] = lp;
+  lp->index();
 }
 
 Bscript::BObjectImp* ListenPoint::GetListenPoints()
@@ -115,13 +197,12 @@ Bscript::BObjectImp* ListenPoint::GetListenPoints()
   while ( itr != gamestate.listen_points.end() )
   {
     ListenPoint* lp = itr->second;
+    ++itr;
     if ( lp->object->orphan() )
     {
-      itr = gamestate.listen_points.erase( itr );
-      delete lp;
+      remove( lp );
       continue;
     }
-    ++itr;
     arr->addElement( lp->object->make_ref() );
   }
   return arr;
@@ -9,7 +9,9 @@
 
 #include "../clib/rawtypes.h"
 #include "reftypes.h"
+#include <set>
 #include <string>
+#include <unordered_map>
 
 namespace Pol
 {
@@ -27,6 +29,17 @@ namespace Core
 class UOExecutor;
 class UObject;
 
+class ListenPoint;
+
+// Listen points of items and mobiles in the world zones with a range up to LISTENPT_ZONE_RANGE are
+// found by a zone search around the speaker, all others are checked one by one.
+struct ListenPointIndex
+{
+  std::unordered_multimap<const UObject*, ListenPoint*> zoned;
+  std::multiset<u16> zoned_ranges;
+  std::set<ListenPoint*> others;
+};
+
 class ListenPoint
 {
 public:
@@ -41,20 +54,28 @@ public:
   static void deregister_from_speech_events( UOExecutor* uoexec );
   static Bscript::BObjectImp* GetListenPoints();
   static std::string TextTypeToString( u8 texttype );
+  // the object entered or left the world zones
+  static void zone_changed( const UObject* obj );
 
 private:
-  void sayto( Mobile::Character* speaker, const std::string& text, u8 texttype, const char* p_lang,
-              Bscript::ObjArray* speechtokens ) const;
+  void sayto( Mobile::Character* speaker, const std::string& text, const std::string& texttype,
+              const char* p_lang, Bscript::ObjArray* speechtokens ) const;
+  void index();
+  void unindex();
+  static void remove( ListenPoint* lp );
 
   UObjectRef object;
   UOExecutor* uoexec;
   u16 range;
   int flags;
+  bool zoned;  // in ListenPointIndex::zoned instead of others
 };
 
 const int LISTENPT_HEAR_GHOSTS = 0x01;
 const int LISTENPT_HEAR_TOKENS = 0x02;
 const int LISTENPT_NO_SPEECH = 0x04;
+
+const u16 LISTENPT_ZONE_RANGE = 32;
 }  // namespace Core
 }  // namespace Pol
 #endif
@@ -65,6 +65,16 @@ void load_incremental_indexes()  // indices is such a stupid word
       }
     }
   }
+
+  // the journal records follow the incr-index files
+  for ( const auto& rec : objStorageManager.journal.recover() )
+  {
+    ++objStorageManager.incremental_save_count;
+    for ( u32 serial : rec.modified )
+      objStorageManager.incremental_serial_index[serial] = objStorageManager.incremental_save_count;
+    for ( u32 serial : rec.deleted )
+      objStorageManager.incremental_serial_index[serial] = UINT_MAX;
+  }
 }
 
 unsigned get_save_index( pol_serial_t serial )
@@ -78,14 +88,32 @@ unsigned get_save_index( pol_serial_t serial )
 
 void read_incremental_saves()
 {
-  for ( unsigned i = 1; i <= objStorageManager.incremental_save_count; ++i )
+  const char* tags = "CHARACTER NPC ITEM GLOBALPROPERTIES SYSTEM MULTI STORAGEAREA";
+  const auto& records = objStorageManager.journal.recovered();
+  unsigned file_saves = objStorageManager.incremental_save_count -
+                        static_cast<unsigned>( records.size() );
+  for ( unsigned i = 1; i <= file_saves; ++i )
   {
     std::string filename =
         Plib::systemstate.config.world_data_path + "incr-data-" + Clib::tostring( i ) + ".txt";
     objStorageManager.current_incremental_save = i;
 
-    slurp( filename.c_str(), "CHARACTER NPC ITEM GLOBALPROPERTIES SYSTEM MULTI STORAGEAREA" );
+    slurp( filename.c_str(), tags );
+  }
+
+  if ( records.empty() )
+    return;
+  std::string filename = SaveJournal::filename();
+  INFO_PRINT << "  " << filename << ":";
+  Tools::Timer<> timer;
+  unsigned int nobjects = 0;
+  for ( const auto& rec : records )
+  {
+    objStorageManager.current_incremental_save = ++file_saves;
+    nobjects += slurp_range( filename, rec.data_offset, rec.data_offset + rec.data_size, tags );
   }
+  INFO_PRINT << " " << records.size() << " records, " << nobjects << " elements in "
+             << timer.ellapsed() << " ms.\n";
 }
 
 void register_deleted_serials()
@@ -106,6 +134,7 @@ void register_deleted_serials()
 void clear_save_index()
 {
   objStorageManager.incremental_serial_index.clear();
+  objStorageManager.journal.clear_recovered();
 }
 
 
@@ -7,6 +7,9 @@
 #ifndef LOADDATA_H
 #define LOADDATA_H
 
+#include <cstddef>
+#include <string>
+
 #include "../plib/poltype.h"
 
 namespace Pol
@@ -26,6 +29,9 @@ unsigned get_save_index( pol_serial_t serial );
 
 void read_incremental_saves();
 void slurp( const char* filename, const char* tags, int sysfind_flags = 0 );
+// the elements in [begin, end) of filename, without progress output
+unsigned int slurp_range( const std::string& filename, size_t begin, size_t end,
+                          const char* tags );
 void register_deleted_serials();
 void clear_save_index();
 
@@ -30,6 +30,7 @@
 #include "multi/multidef.h"
 #include "objtype.h"
 #include "polcfg.h"
+#include "tooltips.h"
 
 namespace Pol
 {
@@ -273,6 +274,7 @@ void reload_configuration()
   read_npc_templates();  // dave 1/12/3 npc template data wasn't actually being read, just names.
   ConsoleCommand::load_console_commands();
   Module::load_fileaccess_cfg();
+  invalidate_aos_tooltips();
 }
 
 void unload_data()
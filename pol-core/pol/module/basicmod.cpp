@@ -607,7 +607,8 @@ picojson::value recurseE2J( BObjectImp* v )
     for ( const auto& content : bstruct->contents() )
     {
       BObjectImp* imp = content.second->impptr();
-      jsonObj.insert( std::pair<std::string, picojson::value>( content.first, recurseE2J( imp ) ) );
+      jsonObj.insert(
+          std::pair<std::string, picojson::value>( content.first.name(), recurseE2J( imp ) ) );
     }
     return picojson::value( jsonObj );
   }
@@ -9,19 +9,29 @@
 
 
 #include "datastore.h"
+#include <cstdio>
 #include <exception>
 #include <fstream>
 #include <stddef.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #include "../../bscript/berror.h"
 #include "../../bscript/bobject.h"
 #include "../../bscript/bstruct.h"
+#include "../../bscript/dict.h"
 #include "../../bscript/executor.h"
 #include "../../bscript/impstr.h"
 #include "../../bscript/objmethods.h"
 #include "../../clib/cfgelem.h"
 #include "../../clib/cfgfile.h"
+#include "../../clib/clib.h"
 #include "../../clib/fileutil.h"
+#include "../../clib/logfacility.h"
 #include "../../clib/rawtypes.h"
 #include "../../clib/streamsaver.h"
 #include "../../plib/pkg.h"
@@ -47,6 +57,32 @@ namespace Module
 Bscript::BApplicObjType datafileref_type;
 Bscript::BApplicObjType datafileelem_type;
 
+namespace
+{
+// snapshots of the last write_datastore() which flush_datastore() still has to write
+std::vector<std::shared_ptr<DataFileSnapshot>> pending_flushes;
+
+bool sync_path( const std::string& path, bool directory )
+{
+#ifdef _WIN32
+  if ( directory )
+    return true;  // not supported
+  int fd = _open( path.c_str(), _O_RDWR );
+  if ( fd < 0 )
+    return false;
+  bool ok = _commit( fd ) == 0;
+  _close( fd );
+#else
+  int fd = ::open( path.c_str(), directory ? O_RDONLY | O_DIRECTORY : O_RDONLY );
+  if ( fd < 0 )
+    return false;
+  bool ok = fsync( fd ) == 0;
+  ::close( fd );
+#endif
+  return ok;
+}
+}  // namespace
+
 DataFileContents::DataFileContents( DataStoreFile* dsf ) : dsf( dsf ), dirty( false ) {}
 
 DataFileContents::~DataFileContents()
@@ -90,27 +126,6 @@ void DataFileContents::load( Clib::ConfigFile& cf )
   }
 }
 
-void DataFileContents::save( Clib::StreamWriter& sw )
-{
-  for ( const auto& element : elements_by_string )
-  {
-    sw() << "Element " << element.first << "\n"
-         << "{\n";
-    element.second->printOn( sw );
-    sw() << "}\n\n";
-    // sw.flush();
-  }
-
-  for ( const auto& element : elements_by_integer )
-  {
-    sw() << "Element " << element.first << "\n"
-         << "{\n";
-    element.second->printOn( sw );
-    sw() << "}\n\n";
-    // sw.flush();
-  }
-}
-
 Bscript::BObjectImp* DataFileContents::methodCreateElement( int key )
 {
   ElementsByInteger::iterator itr = elements_by_integer.find( key );
@@ -120,6 +135,8 @@ Bscript::BObjectImp* DataFileContents::methodCreateElement( int key )
     dfelem.set( new DataFileElement );
     elements_by_integer[key] = dfelem;
     dirty = true;
+    if ( has_indexes() )
+      index_element( Clib::tostring( key ), dfelem.get() );
   }
   else
   {
@@ -137,6 +154,8 @@ Bscript::BObjectImp* DataFileContents::methodCreateElement( const std::string& k
     dfelem.set( new DataFileElement );
     elements_by_string[key] = dfelem;
     dirty = true;
+    if ( has_indexes() )
+      index_element( key, dfelem.get() );
   }
   else
   {
@@ -177,8 +196,12 @@ Bscript::BObjectImp* DataFileContents::methodFindElement( const std::string& key
 
 Bscript::BObjectImp* DataFileContents::methodDeleteElement( int key )
 {
-  if ( elements_by_integer.erase( key ) )
+  ElementsByInteger::iterator itr = elements_by_integer.find( key );
+  if ( itr != elements_by_integer.end() )
   {
+    if ( has_indexes() )
+      unindex_element( itr->second.get() );
+    elements_by_integer.erase( itr );
     dirty = true;
     return new Bscript::BLong( 1 );
   }
@@ -188,8 +211,12 @@ Bscript::BObjectImp* DataFileContents::methodDeleteElement( int key )
 
 Bscript::BObjectImp* DataFileContents::methodDeleteElement( const std::string& key )
 {
-  if ( elements_by_string.erase( key ) )
+  ElementsByString::iterator itr = elements_by_string.find( key );
+  if ( itr != elements_by_string.end() )
   {
+    if ( has_indexes() )
+      unindex_element( itr->second.get() );
+    elements_by_string.erase( itr );
     dirty = true;
     return new Bscript::BLong( 1 );
   }
@@ -217,6 +244,285 @@ Bscript::BObjectImp* DataFileContents::methodKeys() const
 }
 
 
+bool DataFileContents::valid_key( const Bscript::BObjectImp& key ) const
+{
+  if ( dsf->flags & DF_KEYTYPE_INTEGER )
+    return key.isa( Bscript::BObjectImp::OTLong );
+  else
+    return key.isa( Bscript::BObjectImp::OTString );
+}
+
+DataFileElementRef DataFileContents::find( const Bscript::BObjectImp& key ) const
+{
+  if ( dsf->flags & DF_KEYTYPE_INTEGER )
+  {
+    if ( key.isa( Bscript::BObjectImp::OTLong ) )
+    {
+      auto itr = elements_by_integer.find( static_cast<const Bscript::BLong&>( key ).value() );
+      if ( itr != elements_by_integer.end() )
+        return itr->second;
+    }
+  }
+  else if ( key.isa( Bscript::BObjectImp::OTString ) )
+  {
+    auto itr = elements_by_string.find( static_cast<const Bscript::String&>( key ).value() );
+    if ( itr != elements_by_string.end() )
+      return itr->second;
+  }
+  return DataFileElementRef( nullptr );
+}
+
+// key has to be valid
+DataFileElementRef DataFileContents::create( const Bscript::BObjectImp& key )
+{
+  DataFileElementRef dfelem = find( key );
+  if ( dfelem.get() != nullptr )
+    return dfelem;
+  dfelem.set( new DataFileElement );
+  std::string keystr;
+  if ( dsf->flags & DF_KEYTYPE_INTEGER )
+  {
+    int num = static_cast<const Bscript::BLong&>( key ).value();
+    elements_by_integer[num] = dfelem;
+    keystr = Clib::tostring( num );
+  }
+  else
+  {
+    keystr = static_cast<const Bscript::String&>( key ).value();
+    elements_by_string[keystr] = dfelem;
+  }
+  dirty = true;
+  if ( has_indexes() )
+    index_element( keystr, dfelem.get() );
+  return dfelem;
+}
+
+Bscript::BObjectImp* DataFileContents::key_imp( const std::string& key ) const
+{
+  if ( dsf->flags & DF_KEYTYPE_INTEGER )
+    return new Bscript::BLong( atoi( key.c_str() ) );
+  else
+    return new Bscript::String( key );
+}
+
+Bscript::BObjectImp* DataFileContents::methodFindElements( const Bscript::ObjArray& keys )
+{
+  std::unique_ptr<Bscript::BDictionary> dict( new Bscript::BDictionary );
+  for ( const auto& ref : keys.ref_arr )
+  {
+    if ( ref.get() == nullptr )
+      continue;
+    const Bscript::BObjectImp* key = ref->impptr();
+    DataFileElementRef dfelem = find( *key );
+    if ( dfelem.get() != nullptr )
+      dict->addMember( key->copy(), new DataElemRefObjImp( DataFileContentsRef( this ), dfelem ) );
+  }
+  return dict.release();
+}
+
+Bscript::BObjectImp* DataFileContents::methodElementsInRange( const Bscript::BObjectImp& first,
+                                                              const Bscript::BObjectImp& last,
+                                                              int limit )
+{
+  std::unique_ptr<Bscript::BDictionary> dict( new Bscript::BDictionary );
+  int count = 0;
+  if ( dsf->flags & DF_KEYTYPE_INTEGER )
+  {
+    int lo = static_cast<const Bscript::BLong&>( first ).value();
+    int hi = static_cast<const Bscript::BLong&>( last ).value();
+    for ( auto itr = elements_by_integer.lower_bound( lo );
+          itr != elements_by_integer.end() && itr->first <= hi; ++itr )
+    {
+      if ( limit > 0 && count++ == limit )
+        break;
+      dict->addMember( new Bscript::BLong( itr->first ),
+                       new DataElemRefObjImp( DataFileContentsRef( this ), itr->second ) );
+    }
+  }
+  else
+  {
+    const std::string& lo = static_cast<const Bscript::String&>( first ).value();
+    const std::string& hi = static_cast<const Bscript::String&>( last ).value();
+    for ( auto itr = elements_by_string.lower_bound( lo );
+          itr != elements_by_string.end() && stricmp( itr->first.c_str(), hi.c_str() ) <= 0;
+          ++itr )
+    {
+      if ( limit > 0 && count++ == limit )
+        break;
+      dict->addMember( new Bscript::String( itr->first ),
+                       new DataElemRefObjImp( DataFileContentsRef( this ), itr->second ) );
+    }
+  }
+  return dict.release();
+}
+
+Bscript::BObjectImp* DataFileContents::methodElementsWithPrefix( const std::string& prefix,
+                                                                 int limit )
+{
+  std::unique_ptr<Bscript::BDictionary> dict( new Bscript::BDictionary );
+  int count = 0;
+  // keys are sorted case insensitive, the ones with the prefix follow each other
+  for ( auto itr = elements_by_string.lower_bound( prefix );
+        itr != elements_by_string.end() &&
+        strnicmp( itr->first.c_str(), prefix.c_str(), prefix.size() ) == 0;
+        ++itr )
+  {
+    if ( limit > 0 && count++ == limit )
+      break;
+    dict->addMember( new Bscript::String( itr->first ),
+                     new DataElemRefObjImp( DataFileContentsRef( this ), itr->second ) );
+  }
+  return dict.release();
+}
+
+Bscript::BObjectImp* DataFileContents::methodGetProps( const Bscript::ObjArray& keys,
+                                                       const std::string& propname ) const
+{
+  std::unique_ptr<Bscript::BDictionary> dict( new Bscript::BDictionary );
+  for ( const auto& ref : keys.ref_arr )
+  {
+    if ( ref.get() == nullptr )
+      continue;
+    const Bscript::BObjectImp* key = ref->impptr();
+    DataFileElementRef dfelem = find( *key );
+    if ( dfelem.get() == nullptr )
+      continue;
+    copy_on_write( dfelem.get() );
+    Bscript::BObjectImp* value = dfelem->proplist.getpropimp( propname );
+    if ( value != nullptr )
+      dict->addMember( key->copy(), value );
+  }
+  return dict.release();
+}
+
+Bscript::BObjectImp* DataFileContents::methodSetProps( const std::string& propname,
+                                                       const Bscript::BDictionary& values )
+{
+  for ( const auto& kv : values.contents() )
+  {
+    if ( !valid_key( *kv.first.impptr() ) )
+      return new Bscript::BError( "Invalid key " + kv.first->getStringRep() );
+  }
+  for ( const auto& kv : values.contents() )
+  {
+    DataFileElementRef dfelem = create( *kv.first.impptr() );
+    copy_on_write( dfelem.get() );
+    dfelem->proplist.setpropimp( propname, *kv.second->impptr() );
+    if ( has_indexes() )
+      reindex( dfelem.get() );
+  }
+  if ( propname[0] != '#' )
+    dirty = true;
+  return new Bscript::BLong( static_cast<int>( values.contents().size() ) );
+}
+
+void DataFileContents::snapshot( DataFileSnapshot& snapshot ) const
+{
+  for ( const auto& element : elements_by_string )
+    snapshot.add( element.first, element.second );
+  for ( const auto& element : elements_by_integer )
+    snapshot.add( Clib::tostring( element.first ), element.second );
+}
+
+void DataFileContents::copy_on_write( DataFileElement* elem ) const
+{
+  if ( dsf->snapshot )
+    dsf->snapshot->copy_on_write( elem );
+}
+
+void DataFileContents::index_value( Index& index, const std::string& propname,
+                                    const DataFileElement* elem )
+{
+  auto itr = index.by_element.find( elem );
+  if ( itr != index.by_element.end() )
+  {
+    index.by_value.erase( itr->second );
+    index.by_element.erase( itr );
+  }
+  std::string value;
+  if ( elem->proplist.getprop( propname, value ) )
+    index.by_element[elem] = index.by_value.emplace( value, elem );
+}
+
+void DataFileContents::index_element( const std::string& key, const DataFileElement* elem )
+{
+  indexed_keys[elem] = key;
+  for ( auto& index : indexes )
+    index_value( index.second, index.first, elem );
+}
+
+void DataFileContents::unindex_element( const DataFileElement* elem )
+{
+  for ( auto& index : indexes )
+  {
+    auto itr = index.second.by_element.find( elem );
+    if ( itr != index.second.by_element.end() )
+    {
+      index.second.by_value.erase( itr->second );
+      index.second.by_element.erase( itr );
+    }
+  }
+  indexed_keys.erase( elem );
+}
+
+void DataFileContents::reindex( const DataFileElement* elem )
+{
+  // deleted elements can still be changed through old references
+  if ( indexed_keys.find( elem ) == indexed_keys.end() )
+    return;
+  for ( auto& index : indexes )
+    index_value( index.second, index.first, elem );
+}
+
+Bscript::BObjectImp* DataFileContents::methodCreateIndex( const std::string& propname )
+{
+  if ( indexes.find( propname ) != indexes.end() )
+    return new Bscript::BLong( 1 );
+  if ( indexes.empty() )
+  {
+    for ( const auto& element : elements_by_string )
+      indexed_keys[element.second.get()] = element.first;
+    for ( const auto& element : elements_by_integer )
+      indexed_keys[element.second.get()] = Clib::tostring( element.first );
+  }
+  Index& index = indexes[propname];
+  for ( const auto& element : indexed_keys )
+    index_value( index, propname, element.first );
+  return new Bscript::BLong( 1 );
+}
+
+Bscript::BObjectImp* DataFileContents::methodDeleteIndex( const std::string& propname )
+{
+  if ( !indexes.erase( propname ) )
+    return new Bscript::BError( "Index not found" );
+  if ( indexes.empty() )
+    indexed_keys.clear();
+  return new Bscript::BLong( 1 );
+}
+
+Bscript::BObjectImp* DataFileContents::methodFindByIndex( const std::string& propname,
+                                                          const Bscript::BObjectImp& value,
+                                                          int limit )
+{
+  auto index = indexes.find( propname );
+  if ( index == indexes.end() )
+    return new Bscript::BError( "Index not found" );
+  std::unique_ptr<Bscript::BDictionary> dict( new Bscript::BDictionary );
+  int count = 0;
+  auto range = index->second.by_value.equal_range( value.pack() );
+  for ( auto itr = range.first; itr != range.second; ++itr )
+  {
+    if ( limit > 0 && count++ == limit )
+      break;
+    DataFileElement* elem = const_cast<DataFileElement*>( itr->second );
+    dict->addMember( key_imp( indexed_keys[elem] ),
+                     new DataElemRefObjImp( DataFileContentsRef( this ),
+                                            DataFileElementRef( elem ) ) );
+  }
+  return dict.release();
+}
+
+
 DataFileRefObjImp::DataFileRefObjImp( DataFileContentsRef dfcontents )
     : DataFileRefObjImpBase( &datafileref_type, dfcontents )
 {
@@ -315,6 +621,99 @@ Bscript::BObjectImp* DataFileRefObjImp::call_method_id( const int id, Bscript::E
     break;
   case Bscript::MTH_KEYS:
     return obj_->methodKeys();
+  case Bscript::MTH_FINDELEMENTS:
+  {
+    Bscript::ObjArray* keys;
+    if ( !ex.hasParams( 1 ) )
+      return new Bscript::BError( "not enough parameters to datafile.findelements(keys)" );
+    if ( !ex.getObjArrayParam( 0, keys ) )
+      return new Bscript::BError( "datafile.findelements(keys): keys must be an Array" );
+    return obj_->methodFindElements( *keys );
+  }
+  case Bscript::MTH_ELEMENTSINRANGE:
+  {
+    if ( !ex.hasParams( 2 ) )
+    {
+      return new Bscript::BError(
+          "not enough parameters to datafile.elementsinrange(first, last[, limit])" );
+    }
+    int limit = 0;
+    if ( ex.hasParams( 3 ) && !ex.getParam( 2, limit ) )
+      return new Bscript::BError( "datafile.elementsinrange: limit must be an Integer" );
+    Bscript::BObjectImp::BObjectType keytype = ( obj_->dsf->flags & DF_KEYTYPE_INTEGER )
+                                       ? Bscript::BObjectImp::OTLong
+                                       : Bscript::BObjectImp::OTString;
+    Bscript::BObjectImp* first = ex.getParamImp( 0 );
+    Bscript::BObjectImp* last = ex.getParamImp( 1 );
+    if ( !first->isa( keytype ) || !last->isa( keytype ) )
+      return new Bscript::BError( "datafile.elementsinrange: keys must match the key type" );
+    return obj_->methodElementsInRange( *first, *last, limit );
+  }
+  case Bscript::MTH_ELEMENTSWITHPREFIX:
+  {
+    const Bscript::String* prefix;
+    int limit = 0;
+    if ( !ex.hasParams( 1 ) )
+    {
+      return new Bscript::BError(
+          "not enough parameters to datafile.elementswithprefix(prefix[, limit])" );
+    }
+    if ( obj_->dsf->flags & DF_KEYTYPE_INTEGER )
+      return new Bscript::BError( "datafile.elementswithprefix: datafile has Integer keys" );
+    if ( !ex.getStringParam( 0, prefix ) )
+      return new Bscript::BError( "datafile.elementswithprefix: prefix must be a String" );
+    if ( ex.hasParams( 2 ) && !ex.getParam( 1, limit ) )
+      return new Bscript::BError( "datafile.elementswithprefix: limit must be an Integer" );
+    return obj_->methodElementsWithPrefix( prefix->value(), limit );
+  }
+  case Bscript::MTH_GETPROPS:
+  {
+    Bscript::ObjArray* keys;
+    const Bscript::String* propname;
+    if ( !ex.hasParams( 2 ) )
+      return new Bscript::BError( "not enough parameters to datafile.getprops(keys, propname)" );
+    if ( !ex.getObjArrayParam( 0, keys ) || !ex.getStringParam( 1, propname ) )
+      return new Bscript::BError( "Invalid parameter type" );
+    return obj_->methodGetProps( *keys, propname->value() );
+  }
+  case Bscript::MTH_SETPROPS:
+  {
+    const Bscript::String* propname;
+    if ( !ex.hasParams( 2 ) )
+      return new Bscript::BError( "not enough parameters to datafile.setprops(propname, values)" );
+    Bscript::BObjectImp* values = ex.getParamImp( 1, Bscript::BObjectImp::OTDictionary );
+    if ( !ex.getStringParam( 0, propname ) || values == nullptr )
+      return new Bscript::BError( "Invalid parameter type" );
+    return obj_->methodSetProps( propname->value(),
+                                 *static_cast<Bscript::BDictionary*>( values ) );
+  }
+  case Bscript::MTH_CREATEINDEX:
+  case Bscript::MTH_DELETEINDEX:
+  {
+    const Bscript::String* propname;
+    if ( !ex.hasParams( 1 ) )
+      return new Bscript::BError( "not enough parameters" );
+    if ( !ex.getStringParam( 0, propname ) )
+      return new Bscript::BError( "propname must be a String" );
+    if ( id == Bscript::MTH_CREATEINDEX )
+      return obj_->methodCreateIndex( propname->value() );
+    return obj_->methodDeleteIndex( propname->value() );
+  }
+  case Bscript::MTH_FINDBYINDEX:
+  {
+    const Bscript::String* propname;
+    int limit = 0;
+    if ( !ex.hasParams( 2 ) )
+    {
+      return new Bscript::BError(
+          "not enough parameters to datafile.findbyindex(propname, value[, limit])" );
+    }
+    if ( !ex.getStringParam( 0, propname ) )
+      return new Bscript::BError( "datafile.findbyindex: propname must be a String" );
+    if ( ex.hasParams( 3 ) && !ex.getParam( 2, limit ) )
+      return new Bscript::BError( "datafile.findbyindex: limit must be an Integer" );
+    return obj_->methodFindByIndex( propname->value(), *ex.getParamImp( 1 ), limit );
+  }
   default:
     return nullptr;
   }
@@ -350,21 +749,24 @@ Bscript::BObjectImp* DataElemRefObjImp::copy() const
 Bscript::BObjectImp* DataElemRefObjImp::call_method_id( const int id, Bscript::Executor& ex,
                                                         bool /*forcebuiltin*/ )
 {
+  obj_.dfcontents->copy_on_write( obj_.dfelem.get() );
   bool changed = false;
   Bscript::BObjectImp* res = CallPropertyListMethod_id( obj_.dfelem->proplist, id, ex, changed );
   if ( changed )
     obj_.dfcontents->dirty = true;
+  if ( ( id == Bscript::MTH_SETPROP || id == Bscript::MTH_ERASEPROP ) &&
+       obj_.dfcontents->has_indexes() )
+    obj_.dfcontents->reindex( obj_.dfelem.get() );
   return res;
 }
 
 Bscript::BObjectImp* DataElemRefObjImp::call_method( const char* methodname, Bscript::Executor& ex )
 {
-  bool changed = false;
-  Bscript::BObjectImp* res =
-      CallPropertyListMethod( obj_.dfelem->proplist, methodname, ex, changed );
-  if ( changed )
-    obj_.dfcontents->dirty = true;
-  return res;
+  Bscript::ObjMethod* objmethod = Bscript::getKnownObjMethod( methodname );
+  if ( objmethod != nullptr )
+    return this->call_method_id( objmethod->id, ex );
+  else
+    return nullptr;
 }
 
 DataFileExecutorModule::DataFileExecutorModule( Bscript::Executor& exec )
@@ -603,6 +1005,9 @@ void DataStoreFile::load()
   if ( loaded() )
     return;
 
+  // unloaded during the save, the last version may not be written yet
+  if ( snapshot )
+    snapshot->wait_written();
   dfcontents.set( new DataFileContents( this ) );
 
   std::string fn = filename();
@@ -653,13 +1058,6 @@ std::string DataStoreFile::filename() const
   return filename( version );
 }
 
-void DataStoreFile::save() const
-{
-  std::string fname = filename();
-  std::ofstream ofs( fname.c_str(), std::ios::out );
-  Clib::OFStreamWriter sw( &ofs );
-  dfcontents->save( sw );
-}
 
 size_t DataStoreFile::estimateSize() const
 {
@@ -675,19 +1073,123 @@ size_t DataStoreFile::estimateSize() const
 }
 
 
-DataFileElement::DataFileElement() : proplist( Core::CPropProfiler::Type::DATAFILEELEMENT ) {}
+DataFileElement::DataFileElement()
+    : proplist( Core::CPropProfiler::Type::DATAFILEELEMENT ), snapshot_idx( 0 )
+{
+}
 
 DataFileElement::DataFileElement( Clib::ConfigElem& elem )
-    : proplist( Core::CPropProfiler::Type::DATAFILEELEMENT )
+    : proplist( Core::CPropProfiler::Type::DATAFILEELEMENT ), snapshot_idx( 0 )
 {
   proplist.readRemainingPropertiesAsStrings( elem );
 }
 
+DataFileElement::DataFileElement( const DataFileElement& other )
+    : ref_counted(), proplist( other.proplist ), snapshot_idx( 0 )
+{
+}
+
 void DataFileElement::printOn( Clib::StreamWriter& sw ) const
 {
   proplist.printPropertiesAsStrings( sw );
 }
 
+DataFileSnapshot::DataFileSnapshot( const std::string& filename )
+    : filename_( filename ),
+      elements_(),
+      written_( 0 ),
+      mutex_(),
+      failed_( false ),
+      written_promise_(),
+      written_future_( written_promise_.get_future().share() )
+{
+}
+
+void DataFileSnapshot::add( const std::string& key, DataFileElementRef elem )
+{
+  elem->snapshot_idx = elements_.size();
+  elements_.emplace_back( key, elem );
+}
+
+void DataFileSnapshot::copy_on_write( DataFileElement* elem )
+{
+  std::lock_guard<std::mutex> lock( mutex_ );
+  size_t idx = elem->snapshot_idx;
+  if ( idx < written_ || idx >= elements_.size() || elements_[idx].second.get() != elem )
+    return;
+  elements_[idx].second.set( new DataFileElement( *elem ) );
+}
+
+bool DataFileSnapshot::write()
+{
+  bool ok = false;
+  try
+  {
+    ok = write_file();
+  }
+  catch ( std::exception& ex )
+  {
+    POLLOG_ERROR << "Datastore: failed to write " << filename_ << ": " << ex.what() << "\n";
+  }
+  failed_ = !ok;
+  // even if it failed, reloads of the file must not wait forever
+  written_promise_.set_value();
+  return ok;
+}
+
+bool DataFileSnapshot::write_file()
+{
+  unsigned short fsync_mode = Plib::systemstate.config.datastore_fsync;
+  std::string tmpname = filename_ + ".tmp";
+  bool ok;
+  {
+    std::ofstream ofs( tmpname.c_str(), std::ios::out | std::ios::trunc );
+    {
+      Clib::OFStreamWriter sw( &ofs );
+      for ( size_t i = 0; i < elements_.size(); ++i )
+      {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        const auto& element = elements_[i];
+        sw() << "Element " << element.first << "\n"
+             << "{\n";
+        element.second->printOn( sw );
+        sw() << "}\n\n";
+        written_ = i + 1;
+      }
+      sw.flush_file();
+    }
+    ofs.close();
+    ok = !ofs.fail();
+  }
+  if ( ok && fsync_mode >= 1 && !sync_path( tmpname, false ) )
+    POLLOG_ERROR << "Datastore: failed to sync " << tmpname << "\n";
+  if ( ok )
+  {
+    std::remove( filename_.c_str() );
+    ok = std::rename( tmpname.c_str(), filename_.c_str() ) == 0;
+  }
+  if ( ok && fsync_mode >= 2 )
+  {
+    std::string::size_type pos = filename_.find_last_of( "/\\" );
+    std::string dir = pos == std::string::npos ? "." : filename_.substr( 0, pos );
+    if ( !sync_path( dir, true ) )
+      POLLOG_ERROR << "Datastore: failed to sync " << dir << "\n";
+  }
+  if ( !ok )
+    POLLOG_ERROR << "Datastore: failed to write " << filename_ << "\n";
+  return ok;
+}
+
+void DataFileSnapshot::wait_written() const
+{
+  written_future_.wait();
+}
+
+bool DataFileSnapshot::failed() const
+{
+  return failed_;
+}
+
 void read_datastore_dat()
 {
   std::string datastorefile = Plib::systemstate.config.world_data_path + "datastore.txt";
@@ -705,55 +1207,95 @@ void read_datastore_dat()
   }
 }
 
-void write_datastore( Clib::StreamWriter& sw )
+std::shared_ptr<DataFileSnapshot> DataStoreFile::take_snapshot()
 {
-  for ( Core::DataStore::iterator itr = Core::configurationbuffer.datastore.begin();
-        itr != Core::configurationbuffer.datastore.end(); ++itr )
+  if ( snapshot && snapshot->failed() )
   {
-    DataStoreFile* dsf = ( *itr ).second;
+    // the last save could not write its version: the one before is still the current file,
+    // write the contents again
+    version = oldversion;
+    if ( dfcontents.get() )
+      dfcontents->dirty = true;
+  }
 
-    dsf->delversion = dsf->oldversion;
-    dsf->oldversion = dsf->version;
+  delversion = oldversion;
+  oldversion = version;
 
-    if ( dsf->dfcontents.get() && dsf->dfcontents->dirty )
-    {
-      // make a new generation of file and write it.
-      ++dsf->version;
+  if ( dfcontents.get() && dfcontents->dirty )
+  {
+    // make a new generation of the file, flush_datastore() writes it
+    ++version;
 
-      dsf->save();
+    snapshot = std::make_shared<DataFileSnapshot>( filename() );
+    dfcontents->snapshot( *snapshot );
+    dfcontents->dirty = false;
+  }
+  else
+  {
+    snapshot.reset();
+  }
+  return snapshot;
+}
 
-      dsf->dfcontents->dirty = false;
-    }
+void DataStoreFile::commit()
+{
+  if ( delversion != version && delversion != oldversion )
+  {
+    Clib::RemoveFile( filename( delversion ) );
+  }
 
-    dsf->printOn( sw );
-    // sw.flush();
+  // a file written by this save stays loaded until it is on disk, a later save unloads it
+  if ( unload && !snapshot )
+  {
+    if ( dfcontents.get() != nullptr )
+    {
+      if ( dfcontents->count() == 1 )
+      {
+        dfcontents.clear();
+      }
+    }
+    unload = false;
   }
 }
 
-void commit_datastore()
+// Runs while the world is held, only takes snapshots of the dirty files
+void write_datastore( Clib::StreamWriter& sw )
 {
+  pending_flushes.clear();
   for ( Core::DataStore::iterator itr = Core::configurationbuffer.datastore.begin();
         itr != Core::configurationbuffer.datastore.end(); ++itr )
   {
     DataStoreFile* dsf = ( *itr ).second;
 
-    if ( dsf->delversion != dsf->version && dsf->delversion != dsf->oldversion )
-    {
-      Clib::RemoveFile( dsf->filename( dsf->delversion ) );
-    }
+    auto snapshot = dsf->take_snapshot();
+    if ( snapshot )
+      pending_flushes.push_back( snapshot );
 
-    if ( dsf->unload )
-    {
-      if ( dsf->dfcontents.get() != nullptr )
-      {
-        if ( dsf->dfcontents->count() == 1 )
-        {
-          dsf->dfcontents.clear();
-        }
-      }
-      dsf->unload = false;
-    }
+    dsf->printOn( sw );
+    // sw.flush();
   }
 }
+
+// Writes the files of the last write_datastore(), the worldsave calls it after the world runs
+// again and before it commits the data files
+bool flush_datastore()
+{
+  std::vector<std::shared_ptr<DataFileSnapshot>> snapshots;
+  snapshots.swap( pending_flushes );
+  bool result = true;
+  for ( const auto& snapshot : snapshots )
+  {
+    if ( !snapshot->write() )
+      result = false;
+  }
+  return result;
+}
+
+void commit_datastore()
+{
+  for ( Core::DataStore::iterator itr = Core::configurationbuffer.datastore.begin();
+        itr != Core::configurationbuffer.datastore.end(); ++itr )
+    ( *itr ).second->commit();
+}
 }  // namespace Module
 }  // namespace Pol
@@ -11,11 +11,22 @@
 
 #include "../proplist.h"
 
+#include <atomic>
+#include <future>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace Pol
 {
+namespace Bscript
+{
+class BDictionary;
+}
 namespace Clib
 {
 class ConfigElem;
@@ -33,12 +44,44 @@ class DataFileElement final : public ref_counted
 public:
   DataFileElement();
   explicit DataFileElement( Clib::ConfigElem& elem );
+  DataFileElement( const DataFileElement& other );
   void printOn( Clib::StreamWriter& sw ) const;
 
   Core::PropertyList proplist;
+  size_t snapshot_idx;  // position in the last snapshot of its file
 };
 typedef ref_ptr<DataFileElement> DataFileElementRef;
 
+// Elements of a dirty datafile as of the worldsave, write() prints them into the new version of
+// the file after the world runs again. Elements a script accesses before write() got to them are
+// replaced by a copy of their saved state, the script works on the original which the file keeps.
+class DataFileSnapshot
+{
+public:
+  explicit DataFileSnapshot( const std::string& filename );
+
+  void add( const std::string& key, DataFileElementRef elem );
+  // called before a script accesses elem (decoding a property changes it as well)
+  void copy_on_write( DataFileElement* elem );
+  // writes a temporary file and renames it, syncs it as pol.cfg DatastoreFsync says
+  bool write();
+  void wait_written() const;
+  // write() did not get the file on disk
+  bool failed() const;
+
+private:
+  bool write_file();
+
+  std::string filename_;
+  // kept until the snapshot is released by the next save, with the world held
+  std::vector<std::pair<std::string, DataFileElementRef>> elements_;
+  size_t written_;
+  std::mutex mutex_;  // elements_ and written_ while write() runs
+  std::atomic<bool> failed_;
+  std::promise<void> written_promise_;
+  std::shared_future<void> written_future_;
+};
+
 // const int DF_KEYTYPE_STRING = 0x00; // currently unneeded
 const int DF_KEYTYPE_INTEGER = 0x01;
 
@@ -50,7 +93,6 @@ public:
   size_t estimateSize() const;
 
   void load( Clib::ConfigFile& cf );
-  void save( Clib::StreamWriter& sw );
 
   Bscript::BObjectImp* methodCreateElement( int key );
   Bscript::BObjectImp* methodCreateElement( const std::string& key );
@@ -63,6 +105,28 @@ public:
 
   Bscript::BObjectImp* methodKeys() const;
 
+  // batch and range access, results are dictionaries key -> DataFileElemRef
+  Bscript::BObjectImp* methodFindElements( const Bscript::ObjArray& keys );
+  Bscript::BObjectImp* methodElementsInRange( const Bscript::BObjectImp& first,
+                                              const Bscript::BObjectImp& last, int limit );
+  Bscript::BObjectImp* methodElementsWithPrefix( const std::string& prefix, int limit );
+  Bscript::BObjectImp* methodGetProps( const Bscript::ObjArray& keys,
+                                       const std::string& propname ) const;
+  Bscript::BObjectImp* methodSetProps( const std::string& propname,
+                                       const Bscript::BDictionary& values );
+
+  Bscript::BObjectImp* methodCreateIndex( const std::string& propname );
+  Bscript::BObjectImp* methodDeleteIndex( const std::string& propname );
+  Bscript::BObjectImp* methodFindByIndex( const std::string& propname,
+                                          const Bscript::BObjectImp& value, int limit );
+
+  void snapshot( DataFileSnapshot& snapshot ) const;
+  void copy_on_write( DataFileElement* elem ) const;
+
+  bool has_indexes() const { return !indexes.empty(); }
+  // updates the indexes after a property of the element changed
+  void reindex( const DataFileElement* elem );
+
   DataStoreFile* dsf;
   bool dirty;
 
@@ -70,8 +134,29 @@ private:
   typedef std::map<std::string, DataFileElementRef, Clib::ci_cmp_pred> ElementsByString;
   typedef std::map<int, DataFileElementRef> ElementsByInteger;
 
+  // Secondary index over one property, only kept in memory. Maps the packed property value to
+  // the elements which have it.
+  struct Index
+  {
+    typedef std::multimap<std::string, const DataFileElement*> ByValue;
+    ByValue by_value;
+    std::unordered_map<const DataFileElement*, ByValue::iterator> by_element;
+  };
+
+  DataFileElementRef find( const Bscript::BObjectImp& key ) const;
+  DataFileElementRef create( const Bscript::BObjectImp& key );
+  bool valid_key( const Bscript::BObjectImp& key ) const;
+  Bscript::BObjectImp* key_imp( const std::string& key ) const;
+  void index_element( const std::string& key, const DataFileElement* elem );
+  void unindex_element( const DataFileElement* elem );
+  void index_value( Index& index, const std::string& propname, const DataFileElement* elem );
+
   ElementsByString elements_by_string;
   ElementsByInteger elements_by_integer;
+
+  std::map<std::string, Index> indexes;
+  // keys of all elements (integer keys as decimal strings), only filled while there are indexes
+  std::unordered_map<const DataFileElement*, std::string> indexed_keys;
 };
 typedef ref_ptr<DataFileContents> DataFileContentsRef;
 
@@ -132,11 +217,15 @@ public:
   size_t estimateSize() const;
   bool loaded() const;
   void load();
-  void save() const;
   std::string filename() const;
   std::string filename( unsigned ver ) const;
   void printOn( Clib::StreamWriter& sw ) const;
 
+  // worldsave steps while the world is held: take_snapshot() starts the next version of a dirty
+  // file and returns what has to be written, commit() removes the version not needed anymore
+  std::shared_ptr<DataFileSnapshot> take_snapshot();
+  void commit();
+
   std::string descriptor;
   std::string name;
 
@@ -150,6 +239,8 @@ public:
   unsigned delversion;
 
   DataFileContentsRef dfcontents;
+  // of the last save which wrote the file, kept until the next save
+  std::shared_ptr<DataFileSnapshot> snapshot;
 };
 }
 }
@@ -9,7 +9,10 @@
 #include "bscript/bobject.h"
 #include "bscript/bstruct.h"
 #include "bscript/dict.h"
+#include "bscript/escriptv.h"
+#include "bscript/fmodule.h"
 #include "bscript/impstr.h"
+#include "clib/esignal.h"
 #include "clib/logfacility.h"
 #include "clib/network/sckutil.h"
 #include "clib/rawtypes.h"
@@ -40,8 +43,11 @@
 #include "../skills.h"
 #include "../ufunc.h"
 #include "../uoexec.h"
+#include "basicmod.h"
+#include "mathmod.h"
 #include "npcmod.h"
 #include "uomod.h"
+#include "utilmod.h"
 
 #include <module_defs/os.h>
 
@@ -88,7 +94,7 @@ OSExecutorModule::OSExecutorModule( Bscript::Executor& exec )
       warn_on_runaway_( true ),
       blocked_( false ),
       sleep_until_clock_( 0 ),
-      hold_itr_(),
+      hold_link_(),
       in_hold_list_( Core::HoldListType::NO_LIST ),
       wait_type( Core::WAIT_TYPE::WAIT_UNKNOWN ),
       pid_( getnewpid( &uoexec() ) ),
@@ -432,6 +438,88 @@ BObjectImp* OSExecutorModule::mf_Run_Script()
   return ret;
 }
 
+BObjectImp* OSExecutorModule::mf_Start_Detached_Script()
+{
+  const String* scriptname_str;
+  if ( !exec.getStringParam( 0, scriptname_str ) )
+    return new BError( "Invalid parameter type" );
+  BObjectImp* imp = exec.getParamImp( 1 );
+
+  Core::ScriptDef sd;
+  if ( !sd.config_nodie( scriptname_str->value(), exec.prog()->pkg, "scripts/" ) )
+    return new BError( "Error in script name" );
+  if ( !sd.exists() )
+    return new BError( "Script " + sd.name() + " does not exist." );
+  ref_ptr<EScriptProgram> program = Core::find_script2( sd );
+  if ( program.get() == nullptr )
+    return new BError( "Unable to read script" );
+
+  // only modules which neither touch the world nor other shared state (config files are
+  // reloadable) can run without the world lock
+  auto ex = std::make_shared<Executor>();
+  ex->set_detached( true );
+  ex->addModule( new BasicExecutorModule( *ex ) );
+  ex->addModule( new MathExecutorModule( *ex ) );
+  ex->addModule( new UtilExecutorModule( *ex ) );
+  for ( const auto& module : program->modules )
+  {
+    if ( !module->functions.empty() && ex->findModule( module->modulename ) == nullptr )
+      return new BError( "Module " + module->modulename.get() +
+                         " is not available to detached scripts" );
+  }
+  // passed packed like for aux services, references to world objects must not get detached
+  if ( program->haveProgram )
+    ex->pushArg( BObjectImp::unpack( imp->pack().c_str() ) );
+  // also predecodes the program on this thread
+  if ( !ex->setProgram( program.get() ) )
+    return new BError( "Unable to start script" );
+
+  static unsigned int last_id = 0;
+  const unsigned int id = ++last_id;
+  weak_ptr<Core::UOExecutor> uoexec_w = uoexec().weakptr;
+  Core::scriptScheduler.run_detached(
+      [ex = std::move( ex ), program = std::move( program ), uoexec_w, id,
+       scriptname = sd.name()]() mutable
+      {
+        const u64 max_cycles = Plib::systemstate.config.max_detached_script_instructions;
+        u64 cycles = 0;
+        while ( ex->runnable() && !Clib::exit_signalled && cycles < max_cycles )
+        {
+          for ( int i = 0; ( i < 1000 ) && ex->runnable(); ++i, ++cycles )
+            ex->execInstr();
+        }
+        std::string result;
+        if ( ex->runnable() && cycles >= max_cycles )
+          result =
+              BObject( new BError( "Script exceeded the instruction limit" ) ).impptr()->pack();
+        else if ( ex->error() || ex->runnable() )
+          result =
+              BObject( new BError( "Script exited with an error condition" ) ).impptr()->pack();
+        else if ( ex->ValueStack.empty() )
+          result = BObject( new BLong( 1 ) ).impptr()->pack();
+        else
+          result = ex->ValueStack.back()->impptr()->pack();
+
+        Core::PolLock lck;
+        program->instr_cycles += cycles;
+        escript_instr_cycles += cycles;
+        program->detached_instr_cycles += cycles;
+        ++program->detached_invocations;
+        // released under the lock like every other executor and program
+        ex.reset();
+        program.clear();
+        if ( !uoexec_w.exists() )
+          return;
+        std::unique_ptr<BStruct> event( new BStruct );
+        event->addMember( "type", new String( "detached" ) );
+        event->addMember( "id", new BLong( id ) );
+        event->addMember( "script", new String( scriptname ) );
+        event->addMember( "value", BObjectImp::unpack( result.c_str() ) );
+        uoexec_w.get_weakptr()->signal_event( event.release() );
+      } );
+  return new BLong( id );
+}
+
 BObjectImp* OSExecutorModule::mf_Set_Debug()
 {
   int dbg;
@@ -687,7 +775,7 @@ BObjectImp* OSExecutorModule::mf_HTTPRequest()
             for ( const auto& content : headers->contents() )
             {
               BObjectImp* ref = content.second->impptr();
-              std::string header = content.first + ": " + ref->getStringRep();
+              std::string header = content.first.name() + ": " + ref->getStringRep();
               chunk = curl_slist_append( chunk, header.c_str() );
             }
             curl_easy_setopt( curl, CURLOPT_HTTPHEADER, chunk );
@@ -840,7 +928,7 @@ void OSExecutorModule::revive()
   if ( in_hold_list_ == Core::HoldListType::TIMEOUT_LIST )
   {
     in_hold_list_ = Core::HoldListType::NO_LIST;
-    Core::scriptScheduler.revive_timeout( &uoexec(), hold_itr_ );
+    Core::scriptScheduler.revive_timeout( &uoexec() );
   }
   else if ( in_hold_list_ == Core::HoldListType::NOTIMEOUT_LIST )
   {
@@ -898,13 +986,9 @@ void OSExecutorModule::sleep_until_clock( Core::polclock_t sleep_until_clock )
   sleep_until_clock_ = sleep_until_clock;
 }
 
-Core::TimeoutHandle OSExecutorModule::hold_itr() const
-{
-  return hold_itr_;
-}
-void OSExecutorModule::hold_itr( Core::TimeoutHandle hold_itr )
+Core::HoldListLink& OSExecutorModule::hold_link()
 {
-  hold_itr_ = hold_itr;
+  return hold_link_;
 }
 
 Core::HoldListType OSExecutorModule::in_hold_list() const
@@ -1044,8 +1128,7 @@ struct PerfData
       collect( scr );
     for ( const auto& scr : ranlist )
       collect( scr );
-    for ( const auto& scr : holdlist )
-      collect( scr.second );
+    holdlist.for_each( collect );
     for ( const auto& scr : notimeoutholdlist )
       collect( scr );
     std::sort( res.begin(), res.end(), std::greater<ScriptDiffData>() );
@@ -1098,8 +1181,9 @@ BObjectImp* OSExecutorModule::mf_PerformanceMeasure()
     perf->data.insert( std::make_pair( scr->pid(), ScriptDiffData( scr ) ) );
   for ( const auto& scr : ranlist )
     perf->data.insert( std::make_pair( scr->pid(), ScriptDiffData( scr ) ) );
-  for ( const auto& scr : holdlist )
-    perf->data.insert( std::make_pair( scr.second->pid(), ScriptDiffData( scr.second ) ) );
+  holdlist.for_each(
+      [&]( Core::UOExecutor* scr )
+      { perf->data.insert( std::make_pair( scr->pid(), ScriptDiffData( scr ) ) ); } );
   for ( const auto& scr : notimeoutholdlist )
     perf->data.insert( std::make_pair( scr->pid(), ScriptDiffData( scr ) ) );
 
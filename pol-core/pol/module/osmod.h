@@ -83,8 +83,7 @@ public:
   Core::polclock_t sleep_until_clock() const;
   void sleep_until_clock( Core::polclock_t sleep_until_clock );
 
-  Core::TimeoutHandle hold_itr() const;
-  void hold_itr( Core::TimeoutHandle hold_itr );
+  Core::HoldListLink& hold_link();
 
   Core::HoldListType in_hold_list() const;
   void in_hold_list( Core::HoldListType in_hold_list );
@@ -103,6 +102,7 @@ public:
   [[nodiscard]] Bscript::BObjectImp* mf_Start_Skill_Script();
   [[nodiscard]] Bscript::BObjectImp* mf_Run_Script_To_Completion();
   [[nodiscard]] Bscript::BObjectImp* mf_Run_Script();
+  [[nodiscard]] Bscript::BObjectImp* mf_Start_Detached_Script();
   [[nodiscard]] Bscript::BObjectImp* mf_Set_Debug();
   [[nodiscard]] Bscript::BObjectImp* mf_SysLog();
   [[nodiscard]] Bscript::BObjectImp* mf_Set_Priority();
@@ -127,7 +127,7 @@ protected:
   bool blocked_;
   Core::polclock_t sleep_until_clock_;  // 0 if wait forever
 
-  Core::TimeoutHandle hold_itr_;
+  Core::HoldListLink hold_link_;
   Core::HoldListType in_hold_list_;
   Core::WAIT_TYPE wait_type;
 
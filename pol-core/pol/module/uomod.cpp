@@ -73,6 +73,7 @@
 #include <exception>
 #include <stdlib.h>
 #include <string>
+#include <vector>
 
 #include "../../bscript/berror.h"
 #include "../../bscript/bobject.h"
@@ -1234,7 +1235,7 @@ void replace_properties( Clib::ConfigElem& elem, BStruct* custom )
                                           end = custom->contents().end();
         citr != end; ++citr )
   {
-    const std::string& name = ( *citr ).first;
+    const std::string& name = ( *citr ).first.name();
     BObjectImp* ref = ( *citr ).second->impptr();
 
     if ( name == "CProps" )
@@ -1761,10 +1762,10 @@ BObjectImp* UOExecutorModule::mf_GetObjProperty()
   const String* propname_str;
   if ( getUObjectParam( 0, uobj ) && getStringParam( 1, propname_str ) )
   {
-    std::string val;
-    if ( uobj->getprop( propname_str->value(), val ) )
+    BObjectImp* imp = uobj->getpropimp( propname_str->value() );
+    if ( imp != nullptr )
     {
-      return BObjectImp::unpack( val.c_str() );
+      return imp;
     }
     else
     {
@@ -1784,7 +1785,7 @@ BObjectImp* UOExecutorModule::mf_SetObjProperty()
   if ( getUObjectParam( 0, uobj ) && getStringParam( 1, propname_str ) )
   {
     BObjectImp* propval = getParamImp( 2 );
-    uobj->setprop( propname_str->value(), propval->pack() );
+    uobj->setpropimp( propname_str->value(), *propval );
     return new BLong( 1 );
   }
   else
@@ -1833,10 +1834,10 @@ BObjectImp* UOExecutorModule::mf_GetGlobalProperty()
   const String* propname_str;
   if ( getStringParam( 0, propname_str ) )
   {
-    std::string val;
-    if ( gamestate.global_properties->getprop( propname_str->value(), val ) )
+    BObjectImp* imp = gamestate.global_properties->getpropimp( propname_str->value() );
+    if ( imp != nullptr )
     {
-      return BObjectImp::unpack( val.c_str() );
+      return imp;
     }
     else
     {
@@ -1855,7 +1856,7 @@ BObjectImp* UOExecutorModule::mf_SetGlobalProperty()
   if ( exec.getStringParam( 0, propname_str ) )
   {
     BObjectImp* propval = exec.getParamImp( 1 );
-    gamestate.global_properties->setprop( propname_str->value(), propval->pack() );
+    gamestate.global_properties->setpropimp( propname_str->value(), *propval );
     return new BLong( 1 );
   }
   else
@@ -4974,8 +4975,6 @@ BObjectImp* UOExecutorModule::mf_ListStaticsNearLocation( /* x, y, z, range, fla
 //          It is this class that encapsulates the necessary functionality to
 //          make the otherwise fairly generic stlastar class work.
 
-typedef Plib::AStarSearch<UOPathState> UOSearch;
-
 BObjectImp* UOExecutorModule::mf_FindPath()
 {
   unsigned short x1, x2;
@@ -5009,9 +5008,6 @@ BObjectImp* UOExecutorModule::mf_FindPath()
       return new BError( "Start Coordinates Invalid for Realm" );
     if ( !realm->valid( x2, y2, z2 ) )
       return new BError( "End Coordinates Invalid for Realm" );
-    UOSearch* astarsearch;
-    unsigned int SearchState;
-    astarsearch = new UOSearch;
     short xL, xH, yL, yH;
 
     if ( x1 < x2 )
@@ -5077,52 +5073,36 @@ BObjectImp* UOExecutorModule::mf_FindPath()
       POLLOG.Format( "[FindPath]   use EndNode {} {} {}\n" ) << x2 << y2 << z2;
     }
 
-    // Create a start state
-    UOPathState nodeStart( x1, y1, z1, realm, &theBlockers );
-    // Define the goal state
-    UOPathState nodeEnd( x2, y2, z2, realm, &theBlockers );
-    // Set Start and goal states
-    astarsearch->SetStartAndGoalStates( nodeStart, nodeEnd );
-    do
-    {
-      SearchState = astarsearch->SearchStep( doors_block );
-    } while ( SearchState == UOSearch::SEARCH_STATE_SEARCHING );
+    std::vector<Pos3d> path;
+    unsigned int SearchState = find_path( realm, Pos3d( x1, y1, static_cast<s8>( z1 ) ),
+                                          Pos3d( x2, y2, static_cast<s8>( z2 ) ), theBlockers,
+                                          doors_block, path );
     if ( SearchState == UOSearch::SEARCH_STATE_SUCCEEDED )
     {
-      UOPathState* node = astarsearch->GetSolutionStart();
-      ObjArray* nodeArray = nullptr;
-      BStruct* nextStep = nullptr;
-
-      nodeArray = new ObjArray();
-      while ( ( node = astarsearch->GetSolutionNext() ) != nullptr )
+      ObjArray* nodeArray = new ObjArray();
+      for ( const auto& step : path )
       {
-        nextStep = new BStruct;
-        nextStep->addMember( "x", new BLong( node->x ) );
-        nextStep->addMember( "y", new BLong( node->y ) );
-        nextStep->addMember( "z", new BLong( node->z ) );
+        BStruct* nextStep = new BStruct;
+        nextStep->addMember( "x", new BLong( step.x() ) );
+        nextStep->addMember( "y", new BLong( step.y() ) );
+        nextStep->addMember( "z", new BLong( step.z() ) );
         nodeArray->addElement( nextStep );
       }
-      astarsearch->FreeSolutionNodes();
-      delete astarsearch;
       return nodeArray;
     }
     else if ( SearchState == UOSearch::SEARCH_STATE_FAILED )
     {
-      delete astarsearch;
       return new BError( "Failed to find a path." );
     }
     else if ( SearchState == UOSearch::SEARCH_STATE_OUT_OF_MEMORY )
     {
-      delete astarsearch;
       return new BError( "Out of memory." );
     }
     else if ( SearchState == UOSearch::SEARCH_STATE_SOLUTION_CORRUPTED )
     {
-      delete astarsearch;
       return new BError( "Solution Corrupted!" );
     }
 
-    delete astarsearch;
     return new BError( "Pathfind Error." );
   }
   else
@@ -1739,10 +1739,7 @@ BObjectImp* GetAllScriptList()
   {
     add_script( arr, script, "Running" );
   }
-  for ( const auto& script : holdlist )
-  {
-    add_script( arr, ( script ).second, "Sleeping" );
-  }
+  holdlist.for_each( [&]( UOExecutor* script ) { add_script( arr, script, "Sleeping" ); } );
   for ( const auto& script : notimeoutholdlist )
   {
     add_script( arr, script, "Sleeping" );
@@ -1775,6 +1772,9 @@ BObjectImp* GetScriptProfiles()
     double cycle_percent =
         total_instr != 0 ? ( static_cast<double>( eprog->instr_cycles ) / total_instr * 100.0 ) : 0;
     elem->addMember( "instr_percent", new Double( cycle_percent ) );
+    elem->addMember( "detached_instr",
+                     new Double( static_cast<double>( eprog->detached_instr_cycles ) ) );
+    elem->addMember( "detached_invocations", new BLong( eprog->detached_invocations ) );
 
     arr->addElement( elem.release() );
   }
@@ -1807,6 +1807,14 @@ BObjectImp* GetIoStatsObj( const IOStats& stats )
     received->addElement( elem.release() );
   }
 
+  unsigned int send_calls = stats.send_calls;
+  double send_bytes = static_cast<double>( stats.send_bytes );
+  arr->addMember( "send_calls", new BLong( send_calls ) );
+  arr->addMember( "send_bytes", new Double( send_bytes ) );
+  arr->addMember( "bytes_per_send", new Double( send_calls ? send_bytes / send_calls : 0.0 ) );
+  arr->addMember( "transmit_queue_depth", new BLong( stats.transmit_queue_depth ) );
+  arr->addMember( "transmit_queue_depth_max", new BLong( stats.transmit_queue_depth_max ) );
+
   return arr.release();
 }
 
@@ -1863,6 +1871,14 @@ BObjectImp* GetCoreVariable( const char* corevar )
     return new Double( static_cast<double>( networkManager.polstats.bytes_sent ) );
   if ( stricmp( corevar, "bytes_received" ) == 0 )
     return new Double( static_cast<double>( networkManager.polstats.bytes_received ) );
+  if ( stricmp( corevar, "los_cache_hits" ) == 0 )
+    return new Double( static_cast<double>( networkManager.polstats.los_cache_hits ) );
+  if ( stricmp( corevar, "los_cache_misses" ) == 0 )
+    return new Double( static_cast<double>( networkManager.polstats.los_cache_misses ) );
+  if ( stricmp( corevar, "walk_cache_hits" ) == 0 )
+    return new Double( static_cast<double>( networkManager.polstats.walk_cache_hits ) );
+  if ( stricmp( corevar, "walk_cache_misses" ) == 0 )
+    return new Double( static_cast<double>( networkManager.polstats.walk_cache_misses ) );
 
   LONG_COREVAR( uptime, polclock() / POLCLOCKS_PER_SEC );
   LONG_COREVAR( sysload, stateManager.profilevars.last_sysload );
@@ -1885,6 +1901,15 @@ BObjectImp* GetCoreVariable( const char* corevar )
   LONG_COREVAR( scripts_late_per_min, GET_PROFILEVAR_PER_MIN( scripts_late ) );
   LONG_COREVAR( scripts_ontime_per_min, GET_PROFILEVAR_PER_MIN( scripts_ontime ) );
 
+  LONG_COREVAR( packet_batches_per_min, GET_PROFILEVAR_PER_MIN( packet_batches ) );
+  LONG_COREVAR( packet_batch_msgs_per_min, GET_PROFILEVAR_PER_MIN( packet_batch_msgs ) );
+  LONG_COREVAR( packet_batch_lock_us_per_min, GET_PROFILEVAR_PER_MIN( packet_batch_lock_us ) );
+  LONG_COREVAR( packet_batch_max_msgs, GET_PROFILEMAX( packet_batch_msgs ) );
+  LONG_COREVAR( packet_batch_max_lock_us, GET_PROFILEMAX( packet_batch_lock_us ) );
+
+  LONG_COREVAR( worldsave_stall_ms, networkManager.polstats.worldsave_stall_ms );
+  LONG_COREVAR( worldsave_duration_ms, networkManager.polstats.worldsave_duration_ms );
+
   LONG_COREVAR( instr_per_min, stateManager.profilevars.last_sipm );
   LONG_COREVAR( priority_divide, scriptScheduler.priority_divide );
   LONG_COREVAR( update_range, gamestate.update_range.x() );
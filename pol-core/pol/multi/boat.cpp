@@ -1400,6 +1400,7 @@ void UBoat::transform_components( const BoatShape& old_boatshape, Realms::Realm*
         item->graphic = itr2->altgraphic;
       else
         item->graphic = itr2->graphic;
+      item->increv();
 
       Core::Pos4d oldpos = item->pos();
 
@@ -1750,6 +1751,7 @@ void UBoat::create_components()
       hold = component;
 
     component->graphic = itr->graphic;
+    component->increv();
     // component itemdesc entries generally have graphic=1, so they don't get their height set.
     component->height = Plib::tileheight( component->graphic );
     component->setposition(
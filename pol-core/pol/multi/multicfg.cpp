@@ -7,7 +7,6 @@
 
 #include <string>
 
-#include "../../clib/cfgfile.h"
 #include "../../clib/fileutil.h"
 #include "../../clib/refptr.h"
 #include "../../plib/pkg.h"
@@ -26,8 +25,7 @@ void load_special_storedconfig( const std::string& cfgname )
   ref_ptr<Core::StoredConfigFile> scfg = Core::FindConfigFile( main_cfg, "" );
   if ( Clib::FileExists( main_cfg.c_str() ) )
   {
-    Clib::ConfigFile cf_main( main_cfg.c_str() );
-    scfg->load( cf_main );
+    scfg->load_file( main_cfg );
   }
 
   for ( Plib::Packages::iterator itr = Plib::systemstate.packages.begin();
@@ -38,8 +36,7 @@ void load_special_storedconfig( const std::string& cfgname )
     std::string filename = Plib::GetPackageCfgPath( pkg, cfgname + ".cfg" );
     if ( Clib::FileExists( filename.c_str() ) )
     {
-      Clib::ConfigFile cf( filename.c_str() );
-      scfg->load( cf );
+      scfg->load_file( filename );
     }
   }
 }
@@ -71,6 +71,9 @@ namespace Network
 unsigned int Client::instance_counter_;
 std::mutex ThreadedClient::_SocketMutex;
 
+// upper bound of a coalesced send buffer, queue_data() can't handle more than 64k at once
+static const size_t XMIT_COALESCE_MAX = 16 * 1024;
+
 ThreadedClient::ThreadedClient( Crypt::TCryptInfo& encryption, Client& myClient )
     : myClient( myClient ),
       thread_pid( static_cast<size_t>( -1 ) ),
@@ -81,6 +84,9 @@ ThreadedClient::ThreadedClient( Crypt::TCryptInfo& encryption, Client& myClient
       encrypt_server_stream( false ),
       last_activity_at( 0 ),
       last_packet_at( 0 ),
+      recv_held( false ),
+      on_data_queued(),
+      on_recv_released(),
       recv_state( RECV_STATE_CRYPTSEED_WAIT ),
       bufcheck1_AA( 0xAA ),
       buffer(),  // zero-initializes the buffer
@@ -96,7 +102,9 @@ ThreadedClient::ThreadedClient( Crypt::TCryptInfo& encryption, Client& myClient
       first_xmit_buffer( nullptr ),
       last_xmit_buffer( nullptr ),
       n_queued( 0 ),
-      queued_bytes_counter( 0 )
+      queued_bytes_counter( 0 ),
+      xmit_coalescing( false ),
+      xmit_coalesce_buffer()
 {
   memset( &counters, 0, sizeof counters );
   memset( &ipaddr, 0, sizeof( ipaddr ) );
@@ -209,6 +217,7 @@ void Client::PreDelete()
     --n_queued;
   }
   last_xmit_buffer = nullptr;
+  xmit_coalesce_buffer.clear();
 
   // while (!movementqueue.empty())
   //  movementqueue.pop();
@@ -427,6 +436,7 @@ void ThreadedClient::queue_data( const void* data, unsigned short datalen )
   if ( xbuffer )
   {
     THREAD_CHECKPOINT( active_client, 302 );
+    bool was_empty = ( first_xmit_buffer == nullptr );
     xbuffer->next = nullptr;
     xbuffer->nsent = 0;
     xbuffer->lenleft = datalen;
@@ -446,6 +456,8 @@ void ThreadedClient::queue_data( const void* data, unsigned short datalen )
     last_xmit_buffer = xbuffer;
     ++n_queued;
     queued_bytes_counter += datalen;
+    if ( was_empty && on_data_queued )
+      on_data_queued();
   }
   else
   {
@@ -477,10 +489,53 @@ void ThreadedClient::xmit( const void* data, unsigned short datalen )
   }
   THREAD_CHECKPOINT( active_client, 203 );
 
+  if ( xmit_coalescing )
+  {
+    if ( xmit_coalesce_buffer.size() + datalen > XMIT_COALESCE_MAX )
+      send_coalesced();
+    if ( last_xmit_buffer )  // the flush did not get through
+    {
+      queue_data( data, datalen );
+      return;
+    }
+    const unsigned char* cdata = static_cast<const unsigned char*>( data );
+    xmit_coalesce_buffer.insert( xmit_coalesce_buffer.end(), cdata, cdata + datalen );
+    return;
+  }
+  send_or_queue( data, datalen );
+}
+
+void ThreadedClient::coalesce_xmit()
+{
+  xmit_coalescing = true;
+}
+
+void ThreadedClient::flush_xmit()
+{
+  std::lock_guard<std::mutex> lock( _SocketMutex );
+  xmit_coalescing = false;
+  if ( csocket == INVALID_SOCKET )
+    xmit_coalesce_buffer.clear();
+  else
+    send_coalesced();
+}
+
+void ThreadedClient::send_coalesced()
+{
+  if ( xmit_coalesce_buffer.empty() )
+    return;
+  send_or_queue( &xmit_coalesce_buffer[0],
+                 static_cast<unsigned short>( xmit_coalesce_buffer.size() ) );
+  xmit_coalesce_buffer.clear();
+}
+
+void ThreadedClient::send_or_queue( const void* data, unsigned short datalen )
+{
   /* client not backlogged - try to send. */
   const unsigned char* cdata = (const unsigned char*)data;
   int nsent;
 
+  ++Core::networkManager.iostats.send_calls;
   if ( -1 == ( nsent = send( csocket, (const char*)cdata, datalen, 0 ) ) )
   {
     THREAD_CHECKPOINT( active_client, 204 );
@@ -513,6 +568,7 @@ void ThreadedClient::xmit( const void* data, unsigned short datalen )
     datalen -= static_cast<unsigned short>( nsent );
     counters.bytes_transmitted += nsent;
     Core::networkManager.polstats.bytes_sent += nsent;
+    Core::networkManager.iostats.send_bytes += nsent;
     if ( datalen )  // anything left? if so, queue for later.
     {
       THREAD_CHECKPOINT( active_client, 211 );
@@ -534,6 +590,7 @@ void ThreadedClient::send_queued_data()
   while ( nullptr != ( xbuffer = first_xmit_buffer ) )
   {
     int nsent;
+    ++Core::networkManager.iostats.send_calls;
     nsent = send( csocket, (char*)&xbuffer->data[xbuffer->nsent], xbuffer->lenleft, 0 );
     if ( nsent == -1 )
     {
@@ -562,6 +619,7 @@ void ThreadedClient::send_queued_data()
       xbuffer->lenleft -= static_cast<unsigned short>( nsent );
       counters.bytes_transmitted += nsent;
       Core::networkManager.polstats.bytes_sent += nsent;
+      Core::networkManager.iostats.send_bytes += nsent;
       if ( xbuffer->lenleft == 0 )
       {
         first_xmit_buffer = first_xmit_buffer->next;
@@ -633,7 +691,7 @@ void Client::restart()
 
 // Note: this doesnt test single packets it only summs the delay and tests
 // here only the "start"-value is set the additional delay is set in PKT_02 handler
-bool Client::SpeedHackPrevention( bool add )
+bool Client::SpeedHackPrevention( bool add, const unsigned char* pktbuffer )
 {
   if ( ( !movementqueue.empty() ) && ( add ) )
   {
@@ -645,7 +703,7 @@ bool Client::SpeedHackPrevention( bool add )
       return false;
     }
     PacketThrottler throttlestruct;
-    memcpy( &throttlestruct.pktbuffer, &buffer, PKTIN_02_SIZE );
+    memcpy( &throttlestruct.pktbuffer, pktbuffer ? pktbuffer : buffer, PKTIN_02_SIZE );
     movementqueue.push( throttlestruct );
     return false;
   }
@@ -671,7 +729,8 @@ bool Client::SpeedHackPrevention( bool add )
         return false;
       }
       PacketThrottler throttlestruct;
-      memcpy( &throttlestruct.pktbuffer, &buffer, sizeof( throttlestruct.pktbuffer ) );
+      memcpy( &throttlestruct.pktbuffer, pktbuffer ? pktbuffer : buffer,
+              sizeof( throttlestruct.pktbuffer ) );
       movementqueue.push( throttlestruct );
     }
     return false;
@@ -707,7 +766,8 @@ u8 Client::update_range() const
 size_t Client::estimatedSize() const
 {
   Clib::SpinLockGuard guard( _fpLog_lock );
-  size_t size = sizeof( Client ) + fpLog.capacity() + version_.capacity();
+  size_t size = sizeof( Client ) + fpLog.capacity() + version_.capacity() +
+                xmit_coalesce_buffer.capacity();
   Core::XmitBuffer* buffer_size = first_xmit_buffer;
   while ( buffer_size != nullptr )
   {
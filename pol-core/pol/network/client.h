@@ -24,10 +24,12 @@
 
 #include <atomic>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <queue>
 #include <string>
+#include <vector>
 
 #include "../../clib/network/sockets.h"
 #include "../../clib/rawtypes.h"
@@ -153,6 +155,12 @@ public:
   bool have_queued_data() const;
   void send_queued_data();
 
+  // collects everything xmit()ed until flush_xmit() in one buffer, so that many small packets
+  // need only one send() call. Only used by the ClientTransmit thread.
+  void coalesce_xmit();
+  bool coalescing_xmit() const;
+  void flush_xmit();
+
   void recv_remaining( int total_expected );
   void recv_remaining_nocrypt( int total_expected );
 
@@ -181,6 +189,14 @@ public:
   // Will be set by clientthread
   std::atomic<Core::polclock_t> last_activity_at;
   std::atomic<Core::polclock_t> last_packet_at;
+  // a message queued for the PacketDispatch thread changes the framing of the following ones,
+  // nothing more is read from the socket until it is handled
+  std::atomic<bool> recv_held;
+  // set by the ClientEventLoop worker serving this client, called when the send queue stops
+  // being empty so that the worker starts waiting for the socket to become writable
+  std::function<void()> on_data_queued;
+  // set by the ClientEventLoop worker as well, called when recv_held gets cleared
+  std::function<void()> on_recv_released;
 
   static std::mutex _SocketMutex;
 
@@ -218,11 +234,16 @@ protected:
   int n_queued;
   int queued_bytes_counter;  // only used for monitoring
 
+  bool xmit_coalescing;
+  std::vector<unsigned char> xmit_coalesce_buffer;
+
   // we may want to track how many bytes total are outstanding,
   // and boot clients that are too far behind.
   void queue_data( const void* data, unsigned short datalen );
   void transmit_encrypted( const void* data, int len );
   void xmit( const void* data, unsigned short datalen );
+  void send_or_queue( const void* data, unsigned short datalen );
+  void send_coalesced();
 
 private:
   struct
@@ -337,7 +358,8 @@ public:
   void restart();
   std::atomic<int> pause_count;
 
-  bool SpeedHackPrevention( bool add = true );
+  // pktbuffer is the 0x02 message to delay, defaults to the receive buffer
+  bool SpeedHackPrevention( bool add = true, const unsigned char* pktbuffer = nullptr );
   Bscript::BObjectImp* make_ref();
   weak_ptr<Client> getWeakPtr() const;
 
@@ -369,6 +391,11 @@ inline bool ThreadedClient::have_queued_data() const
   return ( first_xmit_buffer != nullptr );
 }
 
+inline bool ThreadedClient::coalescing_xmit() const
+{
+  return xmit_coalescing;
+}
+
 
 // Disconnects client. Might lose packets that were not sent by packetqueue.
 inline void ThreadedClient::forceDisconnect()
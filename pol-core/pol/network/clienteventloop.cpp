@@ -0,0 +1,480 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "clienteventloop.h"
+
+#include <exception>
+#include <list>
+#include <mutex>
+#include <string>
+
+#include "../../clib/esignal.h"
+#include "../../clib/logfacility.h"
+#include "../../clib/network/eventpoller.h"
+#include "../../clib/threadhelp.h"
+#include "../../plib/systemstate.h"
+#include "../accounts/account.h"
+#include "../globals/network.h"
+#include "../polclock.h"
+#include "../polsem.h"
+#include "../schedule.h"
+#include "client.h"
+#include "clienttransmit.h"
+#include "clientthread.h"
+#include <format/format.h>
+
+#define SESSION_CHECKPOINT( x ) session->checkpoint = x
+
+namespace Pol
+{
+namespace Network
+{
+#ifdef HAVE_EVENTPOLLER
+namespace
+{
+// how often idle and speedhack checks run for all clients of a worker
+const Core::polclock_t HOUSEKEEPING_INTERVAL = Core::POLCLOCKS_PER_SEC / 10;
+const int WAIT_TIMEOUT_MS = 100;
+
+struct EventLoopSession
+{
+  explicit EventLoopSession( Client* aclient )
+      : client( aclient ),
+        notify_incoming( true ),
+        notify_writable( false ),
+        idle_warned( false ),
+        in_game( false ),
+        login_at( Core::polclock() ),
+        logoff_at( 0 )
+  {
+  }
+  Client* client;
+  bool notify_incoming;
+  bool notify_writable;
+  bool idle_warned;
+  // once a character got selected pol.cfg LoginServerTimeout does not apply anymore
+  bool in_game;
+  Core::polclock_t login_at;
+  Core::polclock_t logoff_at;
+};
+}  // namespace
+
+class ClientEventLoop::Worker
+{
+public:
+  explicit Worker( unsigned int id )
+      : _id( id ), _poller(), _count( 0 ), _interest_changed( false )
+  {
+  }
+
+  void start()
+  {
+    std::string threadname = "ClientEventLoop " + std::to_string( _id );
+    threadhelp::start_thread( &Worker::thread_stub, threadname.c_str(), this );
+  }
+
+  void add( Client* client )
+  {
+    // nothing is sent to or queued for the client before the worker read its first data, so the
+    // hooks can still be set without locking
+    client->session()->on_data_queued = [this]() { interest_changed(); };
+    client->session()->on_recv_released = [this]() { interest_changed(); };
+    {
+      std::lock_guard<std::mutex> lock( _pending_lock );
+      _pending.push_back( client );
+    }
+    ++_count;
+    _poller.wakeup();
+  }
+
+  size_t count() const { return _count; }
+
+private:
+  // called by the thread which queued data for one of our clients, or which handled a message
+  // the reading of a client was held for
+  void interest_changed()
+  {
+    _interest_changed = true;
+    _poller.wakeup();
+  }
+
+  static void thread_stub( void* arg ) { static_cast<Worker*>( arg )->run(); }
+
+  void run();
+  void accept_pending();
+  void handle_event( EventLoopSession& elsession, const Clib::EventPoller::Event& ev );
+  bool housekeeping( EventLoopSession& elsession );
+  void update_interest( EventLoopSession& elsession );
+  void close_session( EventLoopSession& elsession );
+  void finish_logoff( Client* client );
+  void report_exception( Client* client, const char* what );
+
+  unsigned int _id;
+  Clib::EventPoller _poller;
+  std::mutex _pending_lock;
+  std::vector<Client*> _pending;
+  // std::list keeps the address stable, epoll hands it back as event data
+  std::list<EventLoopSession> _sessions;
+  std::list<EventLoopSession> _closing;
+  std::atomic<size_t> _count;
+  std::atomic<bool> _interest_changed;
+};
+
+void ClientEventLoop::Worker::run()
+{
+  Core::polclock_t next_housekeeping = Core::polclock() + HOUSEKEEPING_INTERVAL;
+  while ( !Clib::exit_signalled )
+  {
+    accept_pending();
+
+    int res = _poller.wait_for_events( WAIT_TIMEOUT_MS );
+    if ( res < 0 && socket_errno != SOCKET_ERRNO( EINTR ) )
+    {
+      POLLOG_ERROR.Format( "ClientEventLoop {}: wait failed, sckerr={}\n" ) << _id << socket_errno;
+      Core::pol_sleep_ms( WAIT_TIMEOUT_MS );
+    }
+    for ( const auto& ev : _poller.events() )
+      handle_event( *static_cast<EventLoopSession*>( ev.data ), ev );
+
+    // the send queue of a client got filled or its reading is not held anymore, only the few
+    // clients concerned change interest
+    if ( _interest_changed.exchange( false ) )
+    {
+      for ( auto& elsession : _sessions )
+        update_interest( elsession );
+    }
+
+    if ( Core::polclock() < next_housekeeping )
+      continue;
+    next_housekeeping = Core::polclock() + HOUSEKEEPING_INTERVAL;
+
+    for ( auto itr = _sessions.begin(); itr != _sessions.end(); )
+    {
+      if ( housekeeping( *itr ) )
+      {
+        ++itr;
+        continue;
+      }
+      close_session( *itr );
+      if ( itr->logoff_at )
+        _closing.splice( _closing.end(), _sessions, itr++ );
+      else
+        itr = _sessions.erase( itr );
+    }
+    Core::polclock_t now = Core::polclock();
+    for ( auto itr = _closing.begin(); itr != _closing.end(); )
+    {
+      if ( now < itr->logoff_at )
+      {
+        ++itr;
+        continue;
+      }
+      finish_logoff( itr->client );
+      itr = _closing.erase( itr );
+    }
+  }
+
+  // shutdown: everything left gets the same treatment as an exiting client thread
+  accept_pending();
+  for ( auto& elsession : _sessions )
+    close_session( elsession );  // no logoff delay once exit is signalled
+  _sessions.clear();
+  for ( auto& elsession : _closing )
+    finish_logoff( elsession.client );
+  _closing.clear();
+}
+
+void ClientEventLoop::Worker::accept_pending()
+{
+  std::vector<Client*> pending;
+  {
+    std::lock_guard<std::mutex> lock( _pending_lock );
+    pending.swap( _pending );
+  }
+  for ( auto& client : pending )
+  {
+    ThreadedClient* session = client->session();
+    session->thread_pid = threadhelp::thread_pid();
+    session->last_packet_at = Core::polclock();
+    session->last_activity_at = Core::polclock();
+    _sessions.emplace_back( client );
+    EventLoopSession& elsession = _sessions.back();
+    elsession.notify_writable = session->have_queued_data();
+    if ( !_poller.add( session->csocket, &elsession, elsession.notify_writable ) )
+    {
+      POLLOG_INFO.Format( "Client#{}: ERROR - couldn't poll socket={}\n" )
+          << client->instance_ << session->csocket;
+      session->forceDisconnect();
+    }
+  }
+}
+
+void ClientEventLoop::Worker::handle_event( EventLoopSession& elsession,
+                                            const Clib::EventPoller::Event& ev )
+{
+  Client* client = elsession.client;
+  ThreadedClient* session = client->session();
+  if ( !session->isReallyConnected() )
+    return;  // housekeeping will close it
+  try
+  {
+    if ( ev.error )
+    {
+      session->forceDisconnect();
+      return;
+    }
+    if ( ev.incoming )
+    {
+      SESSION_CHECKPOINT( 6 );
+      if ( Core::process_data( session ) )
+      {
+        SESSION_CHECKPOINT( 17 );
+        session->last_packet_at = Core::polclock();
+        if ( !Core::check_inactivity( session ) )
+        {
+          elsession.idle_warned = false;
+          session->last_activity_at = Core::polclock();
+        }
+
+        // with batched dispatch nothing has been handled yet, the dispatch thread pulses
+        if ( !Plib::systemstate.config.batched_packet_dispatch )
+        {
+          Core::PolLock lck;
+          SESSION_CHECKPOINT( 7 );
+          Core::send_pulse();
+          if ( Core::TaskScheduler::is_dirty() )
+            Core::wake_tasks_thread();
+        }
+      }
+    }
+    if ( ev.writable && session->isReallyConnected() && session->have_queued_data() )
+    {
+      Core::PolLock lck;
+      SESSION_CHECKPOINT( 8 );
+      session->send_queued_data();
+    }
+    if ( session->isReallyConnected() )
+      update_interest( elsession );
+    SESSION_CHECKPOINT( 21 );
+  }
+  catch ( std::exception& ex )
+  {
+    report_exception( client, ex.what() );
+    session->forceDisconnect();
+  }
+}
+
+// the same checks a client thread does after each (timed out) poll
+bool ClientEventLoop::Worker::housekeeping( EventLoopSession& elsession )
+{
+  Client* client = elsession.client;
+  ThreadedClient* session = client->session();
+  if ( !session->isReallyConnected() )
+    return false;
+  try
+  {
+    // region Speedhack
+    if ( session->has_delayed_packets() )
+    {
+      Core::PolLock lck;
+      session->process_delayed_packets();
+    }
+    // endregion Speedhack
+
+    Core::polclock_t now = Core::polclock();
+    if ( ( now - session->last_packet_at ) / Core::POLCLOCKS_PER_SEC >= 120 )  // 2 mins
+    {
+      session->forceDisconnect();
+      return false;
+    }
+
+    // the login server part of uo_client_listener_thread
+    if ( !elsession.in_game )
+    {
+      if ( client->isConnected() && client->chr )
+        elsession.in_game = true;
+      else if ( ( now - elsession.login_at ) / Core::POLCLOCKS_PER_SEC >=
+                Plib::systemstate.config.loginserver_timeout_mins * 60 )
+      {
+        POLLOG << "Client#" << client->instance_ << " LoginServer timeout disconnect\n";
+        session->forceDisconnect();
+        return false;
+      }
+    }
+
+    if ( client->should_check_idle() )
+    {
+      Core::polclock_t idle_mins =
+          ( now - session->last_activity_at ) / ( 60 * Core::POLCLOCKS_PER_SEC );
+      if ( idle_mins >= Plib::systemstate.config.inactivity_disconnect_timeout )
+      {
+        session->forceDisconnect();
+        return false;
+      }
+      if ( !elsession.idle_warned &&
+           idle_mins >= Plib::systemstate.config.inactivity_warning_timeout )
+      {
+        SESSION_CHECKPOINT( 4 );
+        elsession.idle_warned = true;
+        Core::PolLock lck;
+        client->warn_idle();
+      }
+    }
+  }
+  catch ( std::exception& ex )
+  {
+    report_exception( client, ex.what() );
+    session->forceDisconnect();
+    return false;
+  }
+  return session->isReallyConnected();
+}
+
+void ClientEventLoop::Worker::update_interest( EventLoopSession& elsession )
+{
+  ThreadedClient* session = elsession.client->session();
+  bool incoming = !session->recv_held;
+  bool writable = session->have_queued_data();
+  if ( incoming == elsession.notify_incoming && writable == elsession.notify_writable )
+    return;
+  if ( _poller.modify( session->csocket, &elsession, incoming, writable ) )
+  {
+    elsession.notify_incoming = incoming;
+    elsession.notify_writable = writable;
+  }
+}
+
+// counterpart of threadedclient_io_finalize, but the logoff delay must not block the worker
+void ClientEventLoop::Worker::close_session( EventLoopSession& elsession )
+{
+  Client* client = elsession.client;
+  ThreadedClient* session = client->session();
+  _poller.remove( session->csocket );
+
+  POLLOG.Format( "Client#{} ({}): disconnected (account {})\n" )
+      << client->instance_ << client->ipaddrAsString()
+      << ( ( client->acct != nullptr ) ? client->acct->name() : "unknown" );
+
+  int seconds_wait = 0;
+  try
+  {
+    SESSION_CHECKPOINT( 9 );
+    Core::PolLock lck;
+    seconds_wait = client->on_close();
+  }
+  catch ( std::exception& ex )
+  {
+    report_exception( client, ex.what() );
+  }
+  SESSION_CHECKPOINT( 10 );
+
+  if ( seconds_wait > 0 && !Clib::exit_signalled )
+  {
+    elsession.logoff_at = session->last_activity_at + seconds_wait * Core::POLCLOCKS_PER_SEC;
+  }
+  else
+  {
+    finish_logoff( client );
+    elsession.logoff_at = 0;
+  }
+}
+
+void ClientEventLoop::Worker::finish_logoff( Client* client )
+{
+  ThreadedClient* session = client->session();
+  SESSION_CHECKPOINT( 15 );
+  try
+  {
+    if ( client->chr )
+    {
+      Core::PolLock lck;
+      client->on_logoff();
+    }
+  }
+  catch ( std::exception& ex )
+  {
+    report_exception( client, ex.what() );
+  }
+  --_count;
+  // queue delete of client ptr see Client::Delete for reason
+  Core::networkManager.clientTransmit->QueueDelete( client );
+}
+
+void ClientEventLoop::Worker::report_exception( Client* client, const char* what )
+{
+  POLLOG_ERROR.Format( "Client#{}: Exception in event loop: {}! (checkpoint={})\n" )
+      << client->instance_ << what << client->session()->checkpoint;
+}
+
+#else
+
+// no EventPoller on this platform, ClientEventLoop::supported() returns false
+class ClientEventLoop::Worker
+{
+public:
+  void start() {}
+  void add( Client* ) {}
+  size_t count() const { return 0; }
+};
+
+#endif
+
+ClientEventLoop::ClientEventLoop( unsigned int nthreads ) : _workers(), _next_worker( 0 )
+{
+#ifdef HAVE_EVENTPOLLER
+  for ( unsigned int i = 0; i < nthreads; ++i )
+    _workers.emplace_back( new Worker( i ) );
+#else
+  (void)nthreads;
+#endif
+}
+
+ClientEventLoop::~ClientEventLoop() {}
+
+bool ClientEventLoop::supported()
+{
+#ifdef HAVE_EVENTPOLLER
+  return true;
+#else
+  return false;
+#endif
+}
+
+void ClientEventLoop::start()
+{
+  for ( auto& worker : _workers )
+    worker->start();
+}
+
+void ClientEventLoop::add_client( Client* client )
+{
+  // round robin, but skip a worker which is clearly busier than the others
+  size_t n = _workers.size();
+  size_t idx = _next_worker++ % n;
+  size_t best = idx;
+  for ( size_t i = 1; i < n; ++i )
+  {
+    size_t candidate = ( idx + i ) % n;
+    if ( _workers[candidate]->count() < _workers[best]->count() )
+      best = candidate;
+  }
+  _workers[best]->add( client );
+}
+
+size_t ClientEventLoop::client_count() const
+{
+  size_t count = 0;
+  for ( const auto& worker : _workers )
+    count += worker->count();
+  return count;
+}
+
+size_t ClientEventLoop::thread_count() const
+{
+  return _workers.size();
+}
+}  // namespace Network
+}  // namespace Pol
@@ -0,0 +1,49 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef CLIENTEVENTLOOP_H
+#define CLIENTEVENTLOOP_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Pol
+{
+namespace Network
+{
+class Client;
+
+// Alternative to the one thread per client i/o model (see clientthread.cpp):
+// a small number of worker threads, each waiting on many client sockets at once.
+// Framing, decryption and message dispatch are done by the same functions the client threads
+// use, so both models behave identically from the game logic point of view.
+// Enabled with pol.cfg NetworkEventLoopThreads > 0 (Linux only).
+class ClientEventLoop
+{
+public:
+  explicit ClientEventLoop( unsigned int nthreads );
+  ~ClientEventLoop();
+  ClientEventLoop( const ClientEventLoop& ) = delete;
+  ClientEventLoop& operator=( const ClientEventLoop& ) = delete;
+
+  static bool supported();
+
+  void start();
+  // takes over the socket i/o of a freshly connected client
+  void add_client( Client* client );
+  size_t client_count() const;
+  size_t thread_count() const;
+
+  class Worker;
+
+private:
+  std::vector<std::unique_ptr<Worker>> _workers;
+  std::atomic<unsigned int> _next_worker;
+};
+}  // namespace Network
+}  // namespace Pol
+#endif
@@ -154,86 +154,14 @@ void ThreadedClient::recv_remaining_nocrypt( int total_expected )
 void ThreadedClient::transmit_encrypted( const void* data, int len )
 {
   THREAD_CHECKPOINT( active_client, 100 );
-  const unsigned char* cdata = (const unsigned char*)data;
-  unsigned char* pch;
-  int i;
-  int bidx;  // Offset in output byte
   EncryptedPktBuffer* outbuffer =
       PktHelper::RequestPacket<EncryptedPktBuffer>( ENCRYPTEDPKTBUFFER );
-  pch = reinterpret_cast<unsigned char*>( outbuffer->getBuffer() );
-  bidx = 0;
   THREAD_CHECKPOINT( active_client, 101 );
-  for ( i = 0; i < len; i++ )
-  {
-    THREAD_CHECKPOINT( active_client, 102 );
-    unsigned char ch = cdata[i];
-    int nbits = Core::keydesc[ch].nbits;
-    unsigned short inval = Core::keydesc[ch].bits_reversed;
-
-    THREAD_CHECKPOINT( active_client, 103 );
-
-    while ( nbits-- )
-    {
-      THREAD_CHECKPOINT( active_client, 104 );
-      *pch <<= 1;
-      if ( inval & 1 )
-        *pch |= 1;
-      bidx++;
-      if ( bidx == 8 )
-      {
-        THREAD_CHECKPOINT( active_client, 105 );
-        pch++;
-        bidx = 0;
-      }
-      THREAD_CHECKPOINT( active_client, 106 );
-
-      inval >>= 1;
-    }
-    THREAD_CHECKPOINT( active_client, 107 );
-  }
-  THREAD_CHECKPOINT( active_client, 108 );
-
-  {
-    int nbits = Core::keydesc[0x100].nbits;
-    unsigned short inval = Core::keydesc[0x100].bits_reversed;
-
-    THREAD_CHECKPOINT( active_client, 109 );
-
-    while ( nbits-- )
-    {
-      THREAD_CHECKPOINT( active_client, 110 );
-      *pch <<= 1;
-      if ( inval & 1 )
-        *pch |= 1;
-      bidx++;
-      THREAD_CHECKPOINT( active_client, 111 );
-      if ( bidx == 8 )
-      {
-        pch++;
-        bidx = 0;
-      }
-      THREAD_CHECKPOINT( active_client, 112 );
-
-      inval >>= 1;
-    }
-  }
-  THREAD_CHECKPOINT( active_client, 113 );
-
-  if ( bidx == 0 )
-  {
-    pch--;
-  }
-  else
-  {
-    *pch <<= ( 8 - bidx );
-  }
-  THREAD_CHECKPOINT( active_client, 114 );
-
-  passert_always( pch - reinterpret_cast<unsigned char*>( outbuffer->buffer ) + 1 <=
-                  int( sizeof outbuffer->buffer ) );
+  size_t outlen = Core::huffman_compress( static_cast<const unsigned char*>( data ), len,
+                                          reinterpret_cast<unsigned char*>( outbuffer->buffer ),
+                                          sizeof outbuffer->buffer );
   THREAD_CHECKPOINT( active_client, 115 );
-  xmit( &outbuffer->buffer, static_cast<unsigned short>(
-                                pch - reinterpret_cast<unsigned char*>( outbuffer->buffer ) + 1 ) );
+  xmit( &outbuffer->buffer, static_cast<unsigned short>( outlen ) );
   PktHelper::ReAddPacket( outbuffer );
   THREAD_CHECKPOINT( active_client, 116 );
 }
@@ -18,6 +18,7 @@
 #include "../clib/network/sockets.h"
 #include "../core.h"
 #include "../crypt/cryptbase.h"
+#include "../globals/network.h"
 #include "../mobile/charactr.h"
 #include "../polcfg.h"
 #include "../polclock.h"
@@ -31,6 +32,7 @@
 #include "client.h"
 #include "msgfiltr.h"  // Client could also have a method client->is_msg_allowed(), for example. Then this is not needed here.
 #include "msghandl.h"
+#include "packetdispatch.h"
 #include "packethelper.h"
 #include "packets.h"
 #include "pktboth.h"
@@ -138,8 +140,6 @@ bool threadedclient_io_step( Network::ThreadedClient* session, Clib::SinglePolle
     if ( process_data( session ) )
     {
       SESSION_CHECKPOINT( 17 );
-      PolLock lck;
-
       // reset packet timer
       session->last_packet_at = polclock();
       if ( !check_inactivity( session ) )
@@ -148,10 +148,15 @@ bool threadedclient_io_step( Network::ThreadedClient* session, Clib::SinglePolle
         session->last_activity_at = polclock();
       }
 
-      SESSION_CHECKPOINT( 7 );
-      send_pulse();
-      if ( TaskScheduler::is_dirty() )
-        wake_tasks_thread();
+      // with batched dispatch nothing has been handled yet, the dispatch thread pulses
+      if ( !Plib::systemstate.config.batched_packet_dispatch )
+      {
+        PolLock lck;
+        SESSION_CHECKPOINT( 7 );
+        send_pulse();
+        if ( TaskScheduler::is_dirty() )
+          wake_tasks_thread();
+      }
     }
   }
 
@@ -184,6 +189,12 @@ void threadedclient_io_loop( Network::ThreadedClient* session, bool login )
 
   while ( !Clib::exit_signalled && session->isReallyConnected() )
   {
+    if ( session->recv_held )
+    {
+      if ( login )
+        break;  // the login server thread serves its other clients meanwhile
+      networkManager.packetDispatch->WaitUntilHandled( &session->myClient );
+    }
     if ( !threadedclient_io_step( session, clientpoller, nidle ) || login )
       break;
   }
@@ -300,6 +311,8 @@ bool process_data( Network::ThreadedClient* session )
   // normal processing its code doesn't see the code path.
   passert( session->bufcheck1_AA == 0xAA );
   passert( session->bufcheck2_55 == 0x55 );
+  if ( session->recv_held )
+    return false;
   if ( session->recv_state == Network::ThreadedClient::RECV_STATE_MSGTYPE_WAIT )
   {
     session->bytes_received = 0;
@@ -388,36 +401,17 @@ bool process_data( Network::ThreadedClient* session )
         INFO_PRINT.Format( "Message Received: Type 0x{:X}, Length {} bytes\n" )
             << (int)msgtype << session->message_length;
 
-      PolLock lck;  // multithread
-      // it can happen that a client gets disconnected while waiting for the lock.
-      if ( session->isConnected() )
+      if ( Plib::systemstate.config.batched_packet_dispatch )
       {
-        if ( session->msgtype_filter->msgtype_allowed[msgtype] )
-        {
-          // region Speedhack
-          if ( ( settingsManager.ssopt.speedhack_prevention ) && ( msgtype == PKTIN_02_ID ) )
-          {
-            if ( !session->myClient.SpeedHackPrevention() )
-            {
-              // client->SpeedHackPrevention() added packet to queue
-              session->recv_state = Network::ThreadedClient::RECV_STATE_MSGTYPE_WAIT;
-              SESSION_CHECKPOINT( 28 );
-              return true;
-            }
-          }
-          // endregion Speedhack
-
-          session->myClient.handle_msg( session->buffer, session->bytes_received );
-        }
-        else
-        {
-          // Such combinations of instance and acct happen quite often. Maybe this should become
-          // Client->full_id() or something.
-          POLLOG_ERROR.Format( "Client#{} ({}, Acct {}) sent non-allowed message type 0x{:X}.\n" )
-              << session->myClient.instance_ << session->ipaddrAsString()
-              << ( session->myClient.acct ? session->myClient.acct->name() : "unknown" )
-              << (int)msgtype;
-        }
+        // the dispatch thread handles it together with the messages of other clients, a new
+        // client type holds the reading until then (it changes the framing of the next message)
+        networkManager.packetDispatch->Queue( &session->myClient, session->buffer,
+                                              session->bytes_received );
+      }
+      else
+      {
+        PolLock lck;  // multithread
+        handle_received_message( session, session->buffer, session->bytes_received );
       }
       session->recv_state = Network::ThreadedClient::RECV_STATE_MSGTYPE_WAIT;
       SESSION_CHECKPOINT( 28 );
@@ -484,6 +478,41 @@ bool process_data( Network::ThreadedClient* session )
   return false;
 }
 
+// Checks and runs the handler of a completely received message. Caller must hold the PolLock.
+void handle_received_message( Network::ThreadedClient* session, unsigned char* msg,
+                              unsigned int msglen )
+{
+  // it can happen that a client gets disconnected while waiting for the lock.
+  if ( !session->isConnected() )
+    return;
+
+  unsigned char msgtype = msg[0];
+  if ( session->msgtype_filter->msgtype_allowed[msgtype] )
+  {
+    // region Speedhack
+    if ( ( settingsManager.ssopt.speedhack_prevention ) && ( msgtype == PKTIN_02_ID ) )
+    {
+      if ( !session->myClient.SpeedHackPrevention( true, msg ) )
+      {
+        // client->SpeedHackPrevention() added packet to queue
+        return;
+      }
+    }
+    // endregion Speedhack
+
+    session->myClient.handle_msg( msg, msglen );
+  }
+  else
+  {
+    // Such combinations of instance and acct happen quite often. Maybe this should become
+    // Client->full_id() or something.
+    POLLOG_ERROR.Format( "Client#{} ({}, Acct {}) sent non-allowed message type 0x{:X}.\n" )
+        << session->myClient.instance_ << session->ipaddrAsString()
+        << ( session->myClient.acct ? session->myClient.acct->name() : "unknown" )
+        << (int)msgtype;
+  }
+}
+
 // TODO: We may want to take a buffer directly here instead of a ThreadedClient
 bool check_inactivity( Network::ThreadedClient* session )
 {
@@ -11,6 +11,8 @@ namespace Pol::Core
 {
 bool client_io_thread( Network::Client* client, bool login );
 bool process_data( Network::ThreadedClient* client );
+void handle_received_message( Network::ThreadedClient* session, unsigned char* msg,
+                              unsigned int msglen );
 bool check_inactivity( Network::ThreadedClient* session );
 
 void handle_unknown_packet( Network::ThreadedClient* session );
@@ -1,5 +1,7 @@
 #include "clienttransmit.h"
 
+#include <algorithm>
+
 #include "../../clib/esignal.h"
 #include "../../clib/rawtypes.h"
 #include "../globals/network.h"
@@ -10,7 +12,11 @@ namespace Pol
 {
 namespace Network
 {
-ClientTransmit::ClientTransmit() : _transmitqueue() {}
+// TransmitData objects are reused, but big buffers are given back to the allocator
+static const size_t POOL_MAX_ENTRIES = 4096;
+static const size_t POOL_MAX_BUFFER = 4096;
+
+ClientTransmit::ClientTransmit() : _transmitqueue(), _poolmutex(), _pool() {}
 
 ClientTransmit::~ClientTransmit() {}
 
@@ -18,67 +24,149 @@ void ClientTransmit::Cancel()
 {
   _transmitqueue.cancel();
 }
+
+TransmitDataSPtr ClientTransmit::Acquire()
+{
+  {
+    std::lock_guard<std::mutex> lock( _poolmutex );
+    if ( !_pool.empty() )
+    {
+      auto transmitdata = std::move( _pool.back() );
+      _pool.pop_back();
+      return transmitdata;
+    }
+  }
+  return TransmitDataSPtr( new TransmitData );
+}
+
+void ClientTransmit::Push( TransmitDataSPtr&& transmitdata )
+{
+  auto& stats = Core::networkManager.iostats;
+  unsigned int depth = ++stats.transmit_queue_depth;
+  if ( depth > stats.transmit_queue_depth_max )
+    stats.transmit_queue_depth_max = depth;
+  _transmitqueue.push_move( std::move( transmitdata ) );
+}
+
 void ClientTransmit::AddToQueue( Client* client, const void* data, int len )
 {
   const u8* message = static_cast<const u8*>( data );
-  auto transmitdata = TransmitDataSPtr( new TransmitData );
+  auto transmitdata = Acquire();
   transmitdata->client = client->getWeakPtr();
   transmitdata->len = len;
   transmitdata->data.assign( message, message + len );
   transmitdata->disconnects = false;
-  _transmitqueue.push_move( std::move( transmitdata ) );
+  Push( std::move( transmitdata ) );
+}
+
+void ClientTransmit::AddToQueue( Client* client, const SharedPacketData& data )
+{
+  auto transmitdata = Acquire();
+  transmitdata->client = client->getWeakPtr();
+  transmitdata->len = static_cast<int>( data->size() );
+  transmitdata->shared = data;
+  transmitdata->disconnects = false;
+  Push( std::move( transmitdata ) );
 }
 
 void ClientTransmit::QueueDisconnection( Client* client )
 {
-  auto transmitdata = TransmitDataSPtr( new TransmitData );
+  auto transmitdata = Acquire();
   transmitdata->disconnects = true;
   transmitdata->client = client->getWeakPtr();
-  _transmitqueue.push_move( std::move( transmitdata ) );
+  Push( std::move( transmitdata ) );
 }
 
 void ClientTransmit::QueueDelete( Client* client )
 {
-  auto transmitdata = TransmitDataSPtr( new TransmitData );
+  auto transmitdata = Acquire();
   transmitdata->remove = true;
   transmitdata->client = client->getWeakPtr();
-  _transmitqueue.push_move( std::move( transmitdata ) );
+  Push( std::move( transmitdata ) );
 }
 
-TransmitDataSPtr ClientTransmit::NextQueueEntry()
+void ClientTransmit::NextQueueEntries( std::list<TransmitDataSPtr>* entries )
 {
-  auto transmitdata = TransmitDataSPtr();
-  _transmitqueue.pop_wait( &transmitdata );
-  return transmitdata;
+  _transmitqueue.pop_wait( entries );
+  Core::networkManager.iostats.transmit_queue_depth -= static_cast<unsigned int>( entries->size() );
+}
+
+void ClientTransmit::Recycle( std::list<TransmitDataSPtr>* entries )
+{
+  for ( auto& transmitdata : *entries )
+  {
+    transmitdata->client.clear();
+    transmitdata->len = 0;
+    transmitdata->shared.reset();
+    transmitdata->disconnects = false;
+    transmitdata->remove = false;
+  }
+  std::lock_guard<std::mutex> lock( _poolmutex );
+  for ( auto& transmitdata : *entries )
+  {
+    if ( _pool.size() >= POOL_MAX_ENTRIES )
+      break;
+    if ( transmitdata->data.capacity() <= POOL_MAX_BUFFER )
+      _pool.push_back( std::move( transmitdata ) );
+  }
+  entries->clear();
 }
 
 void ClientTransmitThread()
 {
   ClientTransmit* transmit_instance = Core::networkManager.clientTransmit.get();
+  std::list<TransmitDataSPtr> entries;
+  // clients with coalesced but not yet sent data
+  std::vector<Client*> coalescing;
   while ( !Clib::exit_signalled )
   {
     try
     {
-      auto data = transmit_instance->NextQueueEntry();
-      if ( data->client.exists() )
+      transmit_instance->NextQueueEntries( &entries );
+    }
+    catch ( ClientTransmitQueue::Canceled& )
+    {
+      return;
+    }
+    // Clients are only deleted by this thread, so the pointers stay valid until the flush below
+    // or until a delete entry for the client shows up.
+    for ( auto& data : entries )
+    {
+      if ( !data->client.exists() )
+        continue;
+      Client* client = data->client.get_weakptr();
+      if ( data->remove || data->disconnects )
       {
-        if ( data->remove )
+        if ( client->session()->coalescing_xmit() )
         {
-          Core::PolLock lock;
-          Client::Delete( data->client.get_weakptr() );
+          client->session()->flush_xmit();
+          coalescing.erase( std::find( coalescing.begin(), coalescing.end(), client ) );
         }
-        else if ( data->disconnects )
+      }
+      if ( data->remove )
+      {
+        Core::PolLock lock;
+        Client::Delete( client );
+      }
+      else if ( data->disconnects )
+      {
+        client->forceDisconnect();
+      }
+      else if ( client->isReallyConnected() )
+      {
+        if ( !client->session()->coalescing_xmit() )
         {
-          data->client->forceDisconnect();
+          client->session()->coalesce_xmit();
+          coalescing.push_back( client );
         }
-        else if ( data->client->isReallyConnected() )
-          data->client->transmit( static_cast<void*>( &data->data[0] ), data->len );
+        const u8* buffer = data->shared ? data->shared->data() : data->data.data();
+        client->transmit( buffer, data->len );
       }
     }
-    catch ( ClientTransmitQueue::Canceled& )
-    {
-      return;
-    }
+    for ( auto& client : coalescing )
+      client->session()->flush_xmit();
+    coalescing.clear();
+    transmit_instance->Recycle( &entries );
   }
 }
 }  // namespace Network
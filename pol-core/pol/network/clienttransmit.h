@@ -1,6 +1,7 @@
 #ifndef CLIENTSEND_H
 #define CLIENTSEND_H
 
+#include <list>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -15,12 +16,17 @@ namespace Network
 {
 class Client;
 
+// immutable packet data, encoded once and queued for many clients (see PktHelper::SharedPacket)
+typedef std::shared_ptr<const std::vector<u8>> SharedPacketData;
+
 struct TransmitData
 {
   // store a weak_ptr as a guard for pkts after deleting
   weak_ptr<Client> client;
   int len;
   std::vector<u8> data;
+  // used instead of data if set
+  SharedPacketData shared;
   bool disconnects;
   bool remove;
 
@@ -39,16 +45,25 @@ public:
   ClientTransmit& operator=( const ClientTransmit& ) = delete;
 
   void AddToQueue( Client* client, const void* data, int len );
+  void AddToQueue( Client* client, const SharedPacketData& data );
   void QueueDisconnection( Client* client );
   // queue delete and perform it in transmitthread, to be sure
   // that the weak_ptr stays valid without PolLock
   void QueueDelete( Client* client );
   void Cancel();
 
-  TransmitDataSPtr NextQueueEntry();
+  // waits for and returns all queued entries
+  void NextQueueEntries( std::list<TransmitDataSPtr>* entries );
+  // gives processed entries back to the pool, the list is empty afterwards
+  void Recycle( std::list<TransmitDataSPtr>* entries );
 
 private:
+  TransmitDataSPtr Acquire();
+  void Push( TransmitDataSPtr&& transmitdata );
+
   ClientTransmitQueue _transmitqueue;
+  std::mutex _poolmutex;
+  std::vector<TransmitDataSPtr> _pool;
 };
 
 void ClientTransmitThread();
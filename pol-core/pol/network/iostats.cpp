@@ -16,6 +16,10 @@ IOStats::IOStats()
 {
   memset( &sent, 0, sizeof sent );
   memset( &received, 0, sizeof received );
+  send_calls = 0;
+  send_bytes = 0;
+  transmit_queue_depth = 0;
+  transmit_queue_depth_max = 0;
 }
 }
 }
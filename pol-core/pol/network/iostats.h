@@ -7,6 +7,9 @@
 #define __IOSTATS_H
 
 #include <atomic>
+
+#include "../../clib/rawtypes.h"
+
 namespace Pol
 {
 namespace Network
@@ -24,6 +27,13 @@ public:
 
   Packet sent[256];
   Packet received[256];
+
+  // send() calls and bytes handed to them, the packets of one client are coalesced
+  std::atomic<unsigned int> send_calls;
+  std::atomic<u64> send_bytes;
+  // entries waiting in the ClientTransmit queue
+  std::atomic<unsigned int> transmit_queue_depth;
+  std::atomic<unsigned int> transmit_queue_depth_max;
 };
 }
 }
@@ -19,15 +19,15 @@ void SendWorldItem::Send( Client* client )
     if ( _p->offset == 1 )
       buildF3();
     if ( client->ClientType & CLIENTTYPE_7090 ) /*once known split class?*/
-      _p.Send( client, 26 );
+      _p.SendShared( client, 26 );
     else
-      _p.Send( client, 24 );
+      _p.SendShared( client, 24 );
   }
   else
   {
     if ( _p_old->offset == 1 )
       build1A();
-    _p_old.Send( client, _p_oldlen );
+    _p_old.SendShared( client, _p_oldlen );
   }
 }
 
@@ -163,15 +163,15 @@ void SendWorldMulti::Send( Client* client )
     if ( _p->offset == 1 )
       buildF3();
     if ( client->ClientType & CLIENTTYPE_7090 ) /*once known split class?*/
-      _p.Send( client, 26 );
+      _p.SendShared( client, 26 );
     else
-      _p.Send( client, 24 );
+      _p.SendShared( client, 24 );
   }
   else
   {
     if ( _p_old->offset == 1 )
       build1A();
-    _p_old.Send( client, _p_oldlen );
+    _p_old.SendShared( client, _p_oldlen );
   }
 }
 
@@ -223,13 +223,13 @@ void AddItemContainerMsg::Send( Client* client )
   {
     if ( _p->offset == 1 )
       build();
-    _p.Send( client, _p->getSize() );
+    _p.SendShared( client, _p->getSize() );
   }
   else
   {
     if ( _p_old->offset == 1 )
       buildLegacy();
-    _p_old.Send( client, _p->getSize() - 1 );
+    _p_old.SendShared( client, _p->getSize() - 1 );
   }
 }
 
@@ -325,7 +325,7 @@ void MobileAnimationMsg::Send( Client* client )
       return;
     if ( _p->offset == 1 )
       build();
-    _p.Send( client, _p->getSize() );
+    _p.SendShared( client, _p->getSize() );
   }
   else
   {
@@ -333,7 +333,7 @@ void MobileAnimationMsg::Send( Client* client )
       return;
     if ( _p_old->offset == 1 )
       build6E();
-    _p_old.Send( client, _p_old->getSize() );
+    _p_old.SendShared( client, _p_old->getSize() );
   }
 }
 
@@ -347,7 +347,7 @@ void PlaySoundPkt::Send( Client* client )
 {
   if ( _p->offset == 1 )
     build();
-  _p.Send( client, _p->getSize() );
+  _p.SendShared( client, _p->getSize() );
 }
 
 void PlaySoundPkt::build()
@@ -374,7 +374,7 @@ void RemoveObjectPkt::Send( Client* client )
 {
   if ( _p->offset == 1 )
     build();
-  _p.Send( client, _p->getSize() );
+  _p.SendShared( client, _p->getSize() );
 }
 
 void RemoveObjectPkt::build()
@@ -393,13 +393,13 @@ void SendDamagePkt::Send( Client* client )
   {
     if ( _p->offset == 1 )
       build();
-    _p.Send( client, _p->getSize() );
+    _p.SendShared( client, _p->getSize() );
   }
   else
   {
     if ( _p_old->offset == 1 )
       buildold();
-    _p_old.Send( client );
+    _p_old.SendShared( client );
   }
 }
 
@@ -439,13 +439,13 @@ void ObjRevisionPkt::Send( Client* client )
       {
         if ( _p->offset == 1 )
           build();
-        _p.Send( client, _p->getSize() );
+        _p.SendShared( client, _p->getSize() );
       }
       else
       {
         if ( _p_old->offset == 1 )
           buildold();
-        _p_old.Send( client );
+        _p_old.SendShared( client );
       }
     }
   }
@@ -559,7 +559,7 @@ void GraphicEffectPkt::Send( Client* client )
 {
   if ( _p->offset == 1 )
     build();
-  _p.Send( client, _p->getSize() );
+  _p.SendShared( client, _p->getSize() );
 }
 
 
@@ -700,7 +700,7 @@ void GraphicEffectExPkt::Send( Client* client )
 {
   if ( _p->offset == 1 )
     build();
-  _p.Send( client, _p->getSize() );
+  _p.SendShared( client, _p->getSize() );
 }
 
 
@@ -723,7 +723,7 @@ void HealthBarStatusUpdate::Send( Client* client )
   {
     if ( _p->offset == 1 )
       build();
-    _p.Send( client );
+    _p.SendShared( client );
   }
 }
 
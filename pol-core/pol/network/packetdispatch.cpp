@@ -0,0 +1,136 @@
+#include "packetdispatch.h"
+
+#include <chrono>
+#include <exception>
+
+#include "../../clib/esignal.h"
+#include "../../clib/logfacility.h"
+#include "../globals/network.h"
+#include "../globals/state.h"
+#include "../polsem.h"
+#include "../profile.h"
+#include "../schedule.h"
+#include "client.h"
+#include "clientthread.h"
+#include "pktbothid.h"
+#include "pktinid.h"
+
+namespace Pol
+{
+namespace Network
+{
+// upper bound of messages handled per lock acquisition, so that a flood of messages doesn't
+// starve the other threads waiting for the lock
+static const size_t MAX_BATCH_SIZE = 500;
+
+PacketDispatch::PacketDispatch() : _queue(), _released_mutex(), _released() {}
+
+PacketDispatch::~PacketDispatch() {}
+
+void PacketDispatch::Cancel()
+{
+  _queue.cancel();
+}
+
+void PacketDispatch::Queue( Client* client, const u8* data, unsigned int len )
+{
+  InboundMessage msg;
+  msg.client = client->getWeakPtr();
+  msg.data.assign( data, data + len );
+  msg.releases_recv = ChangesClientType( data[0] );
+  if ( msg.releases_recv )
+    client->session()->recv_held = true;
+  _queue.push_move( std::move( msg ) );
+}
+
+void PacketDispatch::WaitUntilHandled( Client* client )
+{
+  std::unique_lock<std::mutex> lock( _released_mutex );
+  while ( client->session()->recv_held && !Clib::exit_signalled )
+    _released.wait_for( lock, std::chrono::milliseconds( 100 ) );
+}
+
+void PacketDispatch::release_recv( Client* client )
+{
+  {
+    std::lock_guard<std::mutex> lock( _released_mutex );
+    client->session()->recv_held = false;
+  }
+  _released.notify_all();
+  if ( client->session()->on_recv_released )
+    client->session()->on_recv_released();
+}
+
+bool PacketDispatch::ChangesClientType( unsigned char msgtype )
+{
+  return msgtype == Core::PKTIN_91_ID || msgtype == Core::PKTBI_BD_ID ||
+         msgtype == Core::PKTIN_E1_ID || msgtype == Core::PKTIN_EF_ID;
+}
+
+void PacketDispatch::Run()
+{
+  while ( !Clib::exit_signalled )
+  {
+    std::list<InboundMessage> msgs;
+    try
+    {
+      _queue.pop_wait( &msgs );
+    }
+    catch ( InboundMessageQueue::Canceled& )
+    {
+      return;
+    }
+    dispatch( msgs );
+  }
+}
+
+void PacketDispatch::dispatch( std::list<InboundMessage>& msgs )
+{
+  auto itr = msgs.begin();
+  while ( itr != msgs.end() )
+  {
+    size_t count = 0;
+    {
+      Core::PolLock lck;
+      auto lock_start = std::chrono::steady_clock::now();
+      for ( ; itr != msgs.end() && count < MAX_BATCH_SIZE; ++itr, ++count )
+      {
+        if ( !itr->client.exists() )
+          continue;
+        Client* client = itr->client.get_weakptr();
+        try
+        {
+          Core::handle_received_message( client->session(), &itr->data[0],
+                                         static_cast<unsigned int>( itr->data.size() ) );
+        }
+        catch ( std::exception& ex )
+        {
+          // Client::handle_msg already logged the packet, same handling as in the i/o thread
+          POLLOG_ERROR.Format( "Client#{}: Exception in packet dispatch: {}!\n" )
+              << client->instance_ << ex.what();
+          client->forceDisconnect();
+        }
+        if ( itr->releases_recv )
+          release_recv( client );
+      }
+      auto lock_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now() - lock_start )
+                         .count();
+      INC_PROFILEVAR( packet_batches );
+      INC_PROFILEVAR_BY( packet_batch_msgs, static_cast<unsigned int>( count ) );
+      INC_PROFILEVAR_BY( packet_batch_lock_us, static_cast<unsigned int>( lock_us ) );
+      MAX_PROFILEVAR( packet_batch_msgs, static_cast<unsigned int>( count ) );
+      MAX_PROFILEVAR( packet_batch_lock_us, static_cast<unsigned int>( lock_us ) );
+    }
+    Core::send_pulse();
+    if ( Core::TaskScheduler::is_dirty() )
+      Core::wake_tasks_thread();
+  }
+}
+
+void PacketDispatchThread()
+{
+  Core::networkManager.packetDispatch->Run();
+}
+}  // namespace Network
+}  // namespace Pol
@@ -0,0 +1,67 @@
+#ifndef PACKETDISPATCH_H
+#define PACKETDISPATCH_H
+
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <vector>
+
+#include "../../clib/message_queue.h"
+#include "../../clib/rawtypes.h"
+#include "../../clib/weakptr.h"
+
+namespace Pol
+{
+namespace Network
+{
+class Client;
+
+struct InboundMessage
+{
+  // store a weak_ptr as a guard for msgs after deleting
+  weak_ptr<Client> client;
+  std::vector<u8> data;
+  bool releases_recv;  // the message changes the client type, see ThreadedClient::recv_held
+
+  InboundMessage() : client( 0 ), data(), releases_recv( false ){};
+};
+
+typedef Clib::message_queue<InboundMessage> InboundMessageQueue;
+
+// Used with pol.cfg BatchedPacketDispatch: the client i/o threads only frame and decrypt
+// messages and queue them here. The dispatch thread takes the PolLock once for a whole batch
+// of messages (of all clients) instead of once per message. Messages are handled in arrival
+// order, so the order per client is kept. The i/o of a client stops reading after a message
+// which changes the client type, until the dispatch thread handled it.
+class PacketDispatch
+{
+public:
+  PacketDispatch();
+  ~PacketDispatch();
+  PacketDispatch( const PacketDispatch& ) = delete;
+  PacketDispatch& operator=( const PacketDispatch& ) = delete;
+
+  void Queue( Client* client, const u8* data, unsigned int len );
+  void Cancel();
+  // blocks until the client's reading is not held anymore, for the client threads only
+  void WaitUntilHandled( Client* client );
+
+  // messages which set the client type, it decides how the following messages get framed
+  static bool ChangesClientType( unsigned char msgtype );
+
+  // waits for messages and handles them until canceled
+  void Run();
+
+private:
+  void dispatch( std::list<InboundMessage>& msgs );
+  void release_recv( Client* client );
+
+  InboundMessageQueue _queue;
+  std::mutex _released_mutex;
+  std::condition_variable _released;
+};
+
+void PacketDispatchThread();
+}  // namespace Network
+}  // namespace Pol
+#endif
@@ -32,18 +32,25 @@ class PacketOut
 {
 private:
   T* pkt;
+  // copies of the buffer, one per length sent since the packet got written last
+  mutable std::vector<SharedPacketData> shared;
+  mutable u32 shared_generation;
 
 public:
   PacketOut();
   ~PacketOut();
   void Release();
   void Send( Client* client, int len = -1 ) const;
+  // For packets which go to many clients: the content is copied only once per length into a
+  // buffer which all queued entries share, until the packet gets written again.
+  void SendShared( Client* client, int len = -1 ) const;
+  SharedPacketData GetShared( int len = -1 ) const;
   T* operator->(void)const;
   T* Get();
 };
 
 template <class T>
-PacketOut<T>::PacketOut()
+PacketOut<T>::PacketOut() : shared(), shared_generation( 0 )
 {
   pkt = RequestPacket<T>( T::ID, T::SUB );
 }
@@ -60,6 +67,7 @@ void PacketOut<T>::Release()
 {
   ReAddPacket( pkt );
   pkt = 0;
+  shared.clear();
 }
 
 template <class T>
@@ -72,6 +80,36 @@ void PacketOut<T>::Send( Client* client, int len ) const
   Core::networkManager.clientTransmit->AddToQueue( client, &pkt->buffer, len );
 }
 
+template <class T>
+void PacketOut<T>::SendShared( Client* client, int len ) const
+{
+  if ( pkt == 0 )
+    return;
+  Core::networkManager.clientTransmit->AddToQueue( client, GetShared( len ) );
+}
+
+template <class T>
+SharedPacketData PacketOut<T>::GetShared( int len ) const
+{
+  if ( pkt == 0 )
+    return SharedPacketData();
+  if ( len == -1 )
+    len = pkt->offset;
+  if ( shared_generation != pkt->generation )
+  {
+    shared.clear();
+    shared_generation = pkt->generation;
+  }
+  for ( const auto& data : shared )
+  {
+    if ( data->size() == static_cast<size_t>( len ) )
+      return data;
+  }
+  const u8* data = reinterpret_cast<const u8*>( &pkt->buffer );
+  shared.push_back( std::make_shared<const std::vector<u8>>( data, data + len ) );
+  return shared.back();
+}
+
 template <class T>
 T* PacketOut<T>::operator->(void)const
 {
@@ -13,9 +13,11 @@ namespace Network
 class PacketInterface
 {
 public:
-  PacketInterface() : offset( 0 ){};
+  PacketInterface() : offset( 0 ), generation( 0 ){};
   virtual ~PacketInterface() = default;
   u16 offset;
+  // changes with every write to the buffer, copies of it (PacketOut::SendShared) compare it
+  u32 generation;
   virtual void ReSetBuffer(){};
   virtual char* getBuffer() { return nullptr; };
   virtual inline u8 getID() const { return 0; };
@@ -171,7 +171,11 @@ public:
   static const u16 SUB = _sub;
   static const u16 SIZE = _size;
   char buffer[SIZE];
-  virtual char* getBuffer() override { return &buffer[offset]; };
+  virtual char* getBuffer() override
+  {
+    ++generation;
+    return &buffer[offset];
+  };
   virtual inline u8 getID() const override { return ID; };
   virtual inline u16 getSize() const override { return SIZE; };
   virtual size_t estimateSize() const override { return SIZE + sizeof( PacketInterface ); };
@@ -185,6 +189,7 @@ public:
   {
     static_assert( std::is_integral<N>::value || std::is_enum<N>::value,
                    "Invalid argument type integral type is needed!" );
+    ++generation;
     passert_always_r( offset + sizeof( T ) <= SIZE, "pkt " + Clib::hexint( ID ) );
     PktWriterTemplateSpecs::WriteHelper<T>::Write( x, buffer, offset );
   };
@@ -193,6 +198,7 @@ public:
   {
     static_assert( std::is_integral<N>::value || std::is_enum<N>::value,
                    "Invalid argument type integral type is needed!" );
+    ++generation;
     static_assert( std::is_signed<T>::value == std::is_signed<N>::value,
                    "Signed/Unsigned missmatch!" );
     // passert_always_r((std::numeric_limits<T>::max() >= x), "Number is bigger then desired type!"
@@ -216,6 +222,7 @@ public:
   {
     static_assert( std::is_integral<N>::value || std::is_enum<N>::value,
                    "Invalid argument type integral type is needed!" );
+    ++generation;
     passert_always_r( offset + sizeof( T ) <= SIZE, "pkt " + Clib::hexint( ID ) );
     PktWriterTemplateSpecs::WriteHelper<T>::WriteFlipped( x, buffer, offset );
   };
@@ -225,6 +232,7 @@ public:
   {
     static_assert( std::is_integral<N>::value || std::is_enum<N>::value,
                    "Invalid argument type integral type is needed!" );
+    ++generation;
     static_assert( std::is_signed<T>::value == std::is_signed<N>::value,
                    "Signed/Unsigned missmatch!" );
     // passert_always_r((std::numeric_limits<T>::max() >= x), "Number is bigger then desired type!"
@@ -248,6 +256,7 @@ public:
     if ( len < 1 )
       return;
     passert_always_r( offset + len <= SIZE, "pkt " + Clib::hexint( ID ) );
+    ++generation;
     strncpy( &buffer[offset], x, nullterm ? len - 1 : len );
     offset += len;
   };
@@ -256,12 +265,14 @@ public:
     if ( len < 1 )
       return;
     passert_always_r( offset + len <= SIZE, "pkt " + Clib::hexint( ID ) );
+    ++generation;
     memcpy( &buffer[offset], x, len );
     offset += len;
   };
   void Write( const std::vector<u16>& x, bool nullterm = true )
   {
     passert_always_r( offset + x.size() * 2 <= SIZE, "pkt " + Clib::hexint( ID ) );
+    ++generation;
     std::memcpy( &buffer[offset], x.data(), 2 * x.size() );
     offset += static_cast<u16>( x.size() * 2 );
     if ( nullterm )
@@ -273,6 +284,7 @@ public:
   void WriteFlipped( const std::vector<u16>& x, bool nullterm = true )
   {
     passert_always_r( offset + x.size() * 2 <= SIZE, "pkt " + Clib::hexint( ID ) );
+    ++generation;
     for ( const auto& c : x )
     {
       u16 tmp = ctBEu16( c );
@@ -298,6 +310,7 @@ public:
     memset( PacketWriter<_id, _size>::buffer, 0, _size );
     PacketWriter<_id, _size>::buffer[0] = _id;
     PacketWriter<_id, _size>::offset = 1;
+    ++PacketWriter<_id, _size>::generation;
   };
 };
 
@@ -314,6 +327,7 @@ public:
     u16 sub = cfBEu16( _sub );
     std::memcpy( &PacketWriter<_id, _size, _sub>::buffer[_suboff], &sub, sizeof( sub ) );
     PacketWriter<_id, _size, _sub>::offset = 1;
+    ++PacketWriter<_id, _size, _sub>::generation;
   };
   virtual inline u16 getSubID() const override { return _sub; };
 };
@@ -326,14 +340,19 @@ public:
   static const u8 ID = _id;
   static const u8 SUB = 0;
   static const u16 SIZE = _size;
-  EmptyBufferTemplate() { ReSetBuffer(); };
+  EmptyBufferTemplate() { memset( buffer, 0, SIZE ); };
   char buffer[SIZE];
+  // the user overwrites what it sends, no need to clear the whole buffer on every reuse
   virtual void ReSetBuffer() override
   {
-    memset( buffer, 0, SIZE );
     offset = 0;
+    ++generation;
+  };
+  virtual char* getBuffer() override
+  {
+    ++generation;
+    return &buffer[offset];
   };
-  virtual char* getBuffer() override { return &buffer[offset]; };
   virtual inline u8 getID() const override { return ID; };
   virtual inline u16 getSize() const override { return SIZE; };
   virtual size_t estimateSize() const override { return SIZE + sizeof( PacketInterface ); };
@@ -108,6 +108,7 @@
 #include "network/clientthread.h"
 #include "network/clienttransmit.h"
 #include "network/cliface.h"
+#include "network/packetdispatch.h"
 #include "network/packethelper.h"
 #include "network/packethooks.h"
 #include "network/packets.h"
@@ -722,6 +723,7 @@ void threadstatus_thread( void )
         send_pulse();
         wake_tasks_thread();
         networkManager.clientTransmit->Cancel();
+        networkManager.packetDispatch->Cancel();
 #ifdef HAVE_MYSQL
         networkManager.sql_service->stop();
 #endif
@@ -818,6 +820,12 @@ void start_threads()
   checkpoint( "start clienttransmit thread" );
   start_thread( Network::ClientTransmitThread, "ClientTransmit" );
 
+  if ( Plib::systemstate.config.batched_packet_dispatch )
+  {
+    checkpoint( "start packetdispatch thread" );
+    start_thread( Network::PacketDispatchThread, "PacketDispatch" );
+  }
+
 #ifdef HAVE_MYSQL
   checkpoint( "start sql service thread" );
   start_sql_service();
@@ -35,6 +35,7 @@
 #include "core.h"           // todo save_full does not belong here
 #include "globals/state.h"  // todo polsig dependency
 #include "globals/uvars.h"  // todo split write task
+#include "network/clienteventloop.h"
 #include "objtype.h"
 #include "polsig.h"    // thread_checkpoint
 #include "proplist.h"  // todo like uvars
@@ -73,6 +74,15 @@ void PolConfig::read_pol_config( bool initial_load )
     Plib::systemstate.config.pidfile_path =
         Clib::normalized_dir_form( Plib::systemstate.config.pidfile_path );
 
+    // empty: config files are always parsed
+    Plib::systemstate.config.config_cache_path = elem.remove_string( "ConfigCachePath", "" );
+    if ( !Plib::systemstate.config.config_cache_path.empty() )
+    {
+      Plib::systemstate.config.config_cache_path =
+          Clib::normalized_dir_form( Plib::systemstate.config.config_cache_path );
+      Clib::MakeDirectory( Plib::systemstate.config.config_cache_path.c_str() );
+    }
+
     Plib::systemstate.config.check_integrity = true;  // elem.remove_bool( "CheckIntegrity", true );
     Plib::systemstate.config.count_resource_tiles = elem.remove_bool( "CountResourceTiles", false );
     Plib::systemstate.config.web_server = elem.remove_bool( "WebServer", false );
@@ -92,9 +102,23 @@ void PolConfig::read_pol_config( bool initial_load )
       Plib::systemstate.config.max_objtype = max_obj;
 
     Plib::systemstate.config.ignore_load_errors = elem.remove_bool( "IgnoreLoadErrors", false );
+    Plib::systemstate.config.parallel_world_load = elem.remove_bool( "ParallelWorldLoad", true );
 
     Plib::systemstate.config.debug_port = elem.remove_ushort( "DebugPort", 0 );
 
+    Plib::systemstate.config.network_event_loop_threads =
+        elem.remove_ushort( "NetworkEventLoopThreads", 0 );
+    if ( Plib::systemstate.config.network_event_loop_threads &&
+         !Network::ClientEventLoop::supported() )
+    {
+      POLLOG_ERROR << "pol.cfg NetworkEventLoopThreads is not supported on this platform, "
+                      "using one thread per client\n";
+      Plib::systemstate.config.network_event_loop_threads = 0;
+    }
+
+    Plib::systemstate.config.batched_packet_dispatch =
+        elem.remove_bool( "BatchedPacketDispatch", false );
+
     Plib::systemstate.config.account_save = elem.remove_int( "AccountDataSave", -1 );
     if ( Plib::systemstate.config.account_save > 0 )
     {
@@ -112,12 +136,31 @@ void PolConfig::read_pol_config( bool initial_load )
   Plib::systemstate.config.watch_sysload = elem.remove_bool( "WatchSysLoad", false );
   Plib::systemstate.config.log_sysload = elem.remove_bool( "LogSysLoad", false );
   Plib::systemstate.config.inhibit_saves = elem.remove_bool( "InhibitSaves", false );
+  Plib::systemstate.config.binary_world_save = elem.remove_bool( "BinaryWorldSave", false );
+  Plib::systemstate.config.fork_world_save = elem.remove_bool( "ForkWorldSave", false );
+#ifndef __linux__
+  if ( Plib::systemstate.config.fork_world_save )
+  {
+    POLLOG_ERROR << "pol.cfg ForkWorldSave is only supported on Linux, saving in threads\n";
+    Plib::systemstate.config.fork_world_save = false;
+  }
+#endif
+  Plib::systemstate.config.fork_world_save_timeout =
+      elem.remove_ulong( "ForkWorldSaveTimeout", 600 );
+  Plib::systemstate.config.datastore_fsync = elem.remove_ushort( "DatastoreFsync", 0 );
+  Plib::systemstate.config.incremental_save_journal =
+      elem.remove_bool( "IncrementalSaveJournal", false );
+  Plib::systemstate.config.journal_sync_interval =
+      elem.remove_ulong( "JournalSyncInterval", 1000 );
+  Plib::systemstate.config.journal_compact_size = elem.remove_ulong( "JournalCompactSize", 64 );
   Plib::systemstate.config.log_script_cycles = elem.remove_bool( "LogScriptCycles", false );
   Plib::systemstate.config.web_server_local_only = elem.remove_bool( "WebServerLocalOnly", true );
   Plib::systemstate.config.web_server_debug = elem.remove_ushort( "WebServerDebug", 0 );
   Plib::systemstate.config.web_server_password = elem.remove_string( "WebServerPassword", "" );
 
   Plib::systemstate.config.profile_cprops = elem.remove_bool( "ProfileCProps", false );
+  Plib::systemstate.config.cache_decoded_cprops =
+      elem.remove_bool( "CacheDecodedCProps", false );
 
   Plib::systemstate.config.cache_interactive_scripts =
       elem.remove_bool( "CacheInteractiveScripts", true );
@@ -127,6 +170,8 @@ void PolConfig::read_pol_config( bool initial_load )
   Plib::systemstate.config.enable_secure_trading = elem.remove_bool( "EnableSecureTrading", false );
   Plib::systemstate.config.runaway_script_threshold =
       elem.remove_ulong( "RunawayScriptThreshold", 5000 );
+  Plib::systemstate.config.max_detached_script_instructions =
+      elem.remove_ulong( "MaxDetachedScriptInstructions", 100000000 );
 
   Plib::systemstate.config.min_cmdlvl_ignore_inactivity =
       elem.remove_ushort( "MinCmdLvlToIgnoreInactivity", 1 );
@@ -138,6 +183,7 @@ void PolConfig::read_pol_config( bool initial_load )
   Plib::systemstate.config.min_cmdlevel_to_login = elem.remove_ushort( "MinCmdlevelToLogin", 0 );
 
   Bscript::escript_config.max_call_depth = elem.remove_ulong( "MaxCallDepth", 100 );
+  Bscript::escript_config.threaded_code = elem.remove_bool( "ThreadedScriptCode", true );
   Clib::passert_dump_stack = elem.remove_bool( "DumpStackOnAssertionFailure", false );
 
   std::string tmp = elem.remove_string( "AssertionFailureAction", "abort" );
@@ -221,6 +267,8 @@ void PolConfig::read_pol_config( bool initial_load )
   Plib::systemstate.config.display_unknown_packets =
       elem.remove_bool( "DisplayUnknownPackets", false );
   Plib::systemstate.config.exp_los_checks_map = elem.remove_bool( "ExpLosChecksMap", true );
+  Plib::systemstate.config.los_cache_size = elem.remove_ulong( "LosCacheSize", 4096 );
+  Plib::systemstate.config.walk_cache_size = elem.remove_ulong( "WalkCacheSize", 65536 );
   Plib::systemstate.config.enable_debug_log = elem.remove_bool( "EnableDebugLog", false );
   Plib::systemstate.config.debug_password = elem.remove_string( "DebugPassword", "" );
   Plib::systemstate.config.debug_local_only = elem.remove_bool( "DebugLocalOnly", true );
@@ -29,6 +29,7 @@ struct PolConfig
   std::string world_data_path;
   std::string realm_data_path;
   std::string pidfile_path;
+  std::string config_cache_path;
   bool verbose;
   unsigned short loglevel;  // 0=nothing 10=lots
   unsigned short select_timeout_usecs;
@@ -39,6 +40,14 @@ struct PolConfig
   bool watch_mapcache;
   bool check_integrity;
   bool inhibit_saves;
+  bool binary_world_save;
+  bool parallel_world_load;
+  bool fork_world_save;
+  unsigned int fork_world_save_timeout;  // seconds
+  unsigned short datastore_fsync;
+  bool incremental_save_journal;
+  unsigned int journal_sync_interval;  // ms
+  unsigned int journal_compact_size;   // MB
   bool log_script_cycles;
   bool count_resource_tiles;
   Crypt::TCryptInfo client_encryption_version;
@@ -49,11 +58,13 @@ struct PolConfig
   unsigned short web_server_debug;
   std::string web_server_password;
   bool profile_cprops;
+  bool cache_decoded_cprops;
   bool cache_interactive_scripts;
   bool show_speech_colors;
   bool require_spellbooks;
   bool enable_secure_trading;
   unsigned int runaway_script_threshold;
+  unsigned int max_detached_script_instructions;
   bool ignore_load_errors;
   unsigned short min_cmdlvl_ignore_inactivity;
   unsigned short inactivity_warning_timeout;
@@ -68,6 +79,8 @@ struct PolConfig
   bool allow_multi_clients_per_account;
   bool display_unknown_packets;
   bool exp_los_checks_map;
+  unsigned int los_cache_size;  // per realm, 0 disables the los cache
+  unsigned int walk_cache_size;  // per realm, 0 disables the walk height cache
   bool enable_debug_log;
 
   unsigned short debug_port;
@@ -90,6 +103,8 @@ struct PolConfig
 
   int account_save;
   bool use_single_thread_login;
+  unsigned short network_event_loop_threads;
+  bool batched_packet_dispatch;
 
   bool disable_nagle;
   bool show_realm_info;
@@ -34,6 +34,16 @@ void polsem_lock()
   locker = tid;
 }
 
+bool polsem_try_lock()
+{
+  size_t tid = threadhelp::thread_pid();
+  if ( !TryEnterCriticalSection( &cs ) )
+    return false;
+  passert_always( locker == 0 );
+  locker = tid;
+  return true;
+}
+
 void polsem_unlock()
 {
   size_t tid = GetCurrentThreadId();
@@ -54,6 +64,15 @@ void polsem_lock()
   passert_always( locker == 0 );
   locker = tid;
 }
+bool polsem_try_lock()
+{
+  size_t tid = threadhelp::thread_pid();
+  if ( pthread_mutex_trylock( &polsem ) != 0 )
+    return false;
+  passert_always( locker == 0 );
+  locker = tid;
+  return true;
+}
 void polsem_unlock()
 {
   size_t tid = threadhelp::thread_pid();
@@ -38,6 +38,7 @@ extern pthread_mutex_t polsem;
 #endif  // not _WIN32
 
 void polsem_lock();
+bool polsem_try_lock();
 void polsem_unlock();
 
 class PolLock
@@ -9,6 +9,16 @@ namespace Pol
 {
 namespace Core
 {
-PolStats::PolStats() : bytes_received( 0 ), bytes_sent( 0 ) {}
+PolStats::PolStats()
+    : bytes_received( 0 ),
+      bytes_sent( 0 ),
+      worldsave_stall_ms( 0 ),
+      worldsave_duration_ms( 0 ),
+      los_cache_hits( 0 ),
+      los_cache_misses( 0 ),
+      walk_cache_hits( 0 ),
+      walk_cache_misses( 0 )
+{
+}
 }
 }
@@ -19,6 +19,14 @@ public:
   PolStats();
   std::atomic<u64> bytes_received;
   std::atomic<u64> bytes_sent;
+  // last full worldsave: how long the world was held and how long the save took altogether
+  std::atomic<u64> worldsave_stall_ms;
+  std::atomic<u64> worldsave_duration_ms;
+  // line of sight checks answered by / missing the los cache of the realms
+  std::atomic<u64> los_cache_hits;
+  std::atomic<u64> los_cache_misses;
+  std::atomic<u64> walk_cache_hits;
+  std::atomic<u64> walk_cache_misses;
 };
 // extern PolStats auxstats; (Not yet... -- Nando)
 // extern PolStats webstats;
@@ -20,6 +20,8 @@ namespace Core
 #define DEF_PROFILEVAR( counter ) \
   unsigned int prf_##counter, prf_last_##counter, prf_last_##counter##_per_min
 
+#define DEF_PROFILEMAX( value ) unsigned int prf_max_##value, prf_last_max_##value
+
 #define CLOCK_PROFILEVAR( timer ) \
   clock_t tmr_##timer##_clocks_this_min, tmr_##timer##_clocks_last_min, tmr_##timer##_clock_start
 
@@ -44,6 +46,12 @@ struct ProfileVars
   DEF_PROFILEVAR( npc_searches );
   DEF_PROFILEVAR( container_adds );
   DEF_PROFILEVAR( container_removes );
+  DEF_PROFILEVAR( packet_batches );
+  DEF_PROFILEVAR( packet_batch_msgs );
+  DEF_PROFILEVAR( packet_batch_lock_us );
+  // single batches, a spike of lock hold time gets lost in the sum per minute
+  DEF_PROFILEMAX( packet_batch_msgs );
+  DEF_PROFILEMAX( packet_batch_lock_us );
 
   CLOCK_PROFILEVAR( npc_search );
 
@@ -97,6 +105,21 @@ struct ProfileVars
 #define GET_PROFILEVAR_PER_MIN( counter ) \
   Core::stateManager.profilevars.prf_last_##counter##_per_min
 
+#define MAX_PROFILEVAR( value, amount )                                \
+  do                                                                   \
+  {                                                                    \
+    if ( Core::stateManager.profilevars.prf_max_##value < ( amount ) ) \
+      Core::stateManager.profilevars.prf_max_##value = ( amount );     \
+  } while ( 0 )
+#define ROLL_PROFILEMAX( value )                          \
+  do                                                      \
+  {                                                       \
+    Core::stateManager.profilevars.prf_last_max_##value = \
+        Core::stateManager.profilevars.prf_max_##value;   \
+    Core::stateManager.profilevars.prf_max_##value = 0;   \
+  } while ( 0 )
+#define GET_PROFILEMAX( value ) Core::stateManager.profilevars.prf_last_max_##value
+
 #define START_PROFILECLOCK( timer ) \
   Core::stateManager.profilevars.tmr_##timer##_clock_start = clock()
 #define STOP_PROFILECLOCK( timer )                                \
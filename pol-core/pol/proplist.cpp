@@ -11,6 +11,8 @@
 
 #include "../bscript/berror.h"
 #include "../bscript/bobject.h"
+#include "../bscript/bstruct.h"
+#include "../bscript/dict.h"
 #include "../bscript/executor.h"
 #include "../bscript/impstr.h"
 #include "../bscript/objmethods.h"
@@ -18,6 +20,7 @@
 #include "../clib/logfacility.h"
 #include "../clib/streamsaver.h"
 #include "../clib/strutil.h"
+#include "../clib/timer.h"
 #include "../plib/systemstate.h"
 #include "baseobject.h"
 #include "polcfg.h"
@@ -74,7 +77,12 @@ CPropProfiler& CPropProfiler::instance()
   return instance;
 }
 
-CPropProfiler::CPropProfiler() : _proplists( new PropLists() ), _hits( new Hits() ) {}
+CPropProfiler::CPropProfiler() : _proplists( new PropLists() ), _hits( new Hits() ), _cache() {}
+
+CPropProfiler::CacheStats::CacheStats()
+    : unpacks( 0 ), unpack_us( 0 ), copies( 0 ), copy_us( 0 ), stores( 0 ), packs( 0 ), pack_us( 0 )
+{
+}
 
 /**
  * Returns proplist type, internal usage
@@ -140,6 +148,44 @@ void CPropProfiler::cpropErase( const PropertyList* proplist, const std::string&
   cpropAction( proplist, name, HitsCounter::ERASE );
 }
 
+/**
+ * Register a read which had to unpack the CProp
+ *
+ * @param us Time of the unpacking
+ */
+void CPropProfiler::cacheUnpack( u64 us )
+{
+  ++_cache.unpacks;
+  _cache.unpack_us += us;
+}
+/**
+ * Register a read which copied the decoded CProp
+ *
+ * @param us Time of the copy
+ */
+void CPropProfiler::cacheCopy( u64 us )
+{
+  ++_cache.copies;
+  _cache.copy_us += us;
+}
+/**
+ * Register a write which stored the object instead of packing it
+ */
+void CPropProfiler::cacheStore()
+{
+  ++_cache.stores;
+}
+/**
+ * Register the packing of a stored object (worldsave)
+ *
+ * @param us Time of the packing
+ */
+void CPropProfiler::cachePack( u64 us )
+{
+  ++_cache.packs;
+  _cache.pack_us += us;
+}
+
 /**
  * Registers a property list address
  *
@@ -204,6 +250,9 @@ void CPropProfiler::clear()
 
   _proplists->clear();
   _hits->clear();
+  _cache.unpacks = _cache.unpack_us = 0;
+  _cache.copies = _cache.copy_us = 0;
+  _cache.stores = _cache.packs = _cache.pack_us = 0;
 }
 
 /**
@@ -295,6 +344,24 @@ void CPropProfiler::dumpProfile( std::ostream& os ) const
 
     os << std::endl;
   }
+
+  // The reads from the decoded objects would have been unpacks of the same CProps, estimate
+  // the time they saved from the average unpack
+  u64 unpacks = _cache.unpacks, unpack_us = _cache.unpack_us;
+  u64 copies = _cache.copies, copy_us = _cache.copy_us;
+  os << std::string( 15, '-' ) << " DECODED CPROPS " << std::string( 15, '-' ) << std::endl;
+  os << "reads unpacked: " << unpacks << " (" << unpack_us << " us)" << std::endl;
+  os << "reads copied from the decoded object: " << copies << " (" << copy_us << " us)"
+     << std::endl;
+  os << "writes stored without packing: " << _cache.stores << std::endl;
+  os << "stored objects packed: " << _cache.packs << " (" << _cache.pack_us << " us)" << std::endl;
+  if ( unpacks > 0 && copies > 0 )
+  {
+    double saved = static_cast<double>( unpack_us ) / unpacks * copies - copy_us;
+    os << "estimated time saved by the reads: " << static_cast<s64>( saved ) << " us"
+       << std::endl;
+  }
+  os << std::endl;
 }
 
 /**
@@ -328,6 +395,128 @@ size_t CPropProfiler::estimateSize() const
   return ret;
 }
 
+/**
+ * Returns true if unpacking the packed value gives the same value again. Only these objects can
+ * be stored without packing, references to game objects or doubles (packed with 6 digits) can't.
+ */
+static bool is_plain_data( const Bscript::BObjectImp& imp )
+{
+  using namespace Bscript;
+  switch ( imp.type() )
+  {
+  case BObjectImp::OTUninit:
+  case BObjectImp::OTString:
+  case BObjectImp::OTLong:
+  case BObjectImp::OTBoolean:
+    return true;
+  case BObjectImp::OTArray:
+    for ( const auto& elem : static_cast<const ObjArray&>( imp ).ref_arr )
+    {
+      if ( elem != nullptr && !is_plain_data( elem->impref() ) )
+        return false;
+    }
+    return true;
+  case BObjectImp::OTStruct:
+    for ( const auto& member : static_cast<const BStruct&>( imp ).contents() )
+    {
+      if ( !is_plain_data( member.second->impref() ) )
+        return false;
+    }
+    return true;
+  case BObjectImp::OTDictionary:
+    for ( const auto& elem : static_cast<const BDictionary&>( imp ).contents() )
+    {
+      if ( !is_plain_data( elem.first.impref() ) || !is_plain_data( elem.second->impref() ) )
+        return false;
+    }
+    return true;
+  default:
+    return false;
+  }
+}
+
+CPropValue::CPropValue() : _packed(), _has_packed( true ), _imp() {}
+
+CPropValue::CPropValue( const std::string& packed )
+    : _packed( packed ), _has_packed( true ), _imp()
+{
+}
+
+CPropValue::CPropValue( Bscript::BObjectImp* imp ) : _packed(), _has_packed( false ), _imp( imp )
+{
+}
+
+CPropValue::CPropValue( const CPropValue& other )
+    : _packed( other._packed ), _has_packed( other._has_packed ), _imp( other._imp )
+{
+}
+
+CPropValue& CPropValue::operator=( const CPropValue& other )
+{
+  _packed = other._packed;
+  _has_packed = other._has_packed;
+  _imp = other._imp;
+  return *this;
+}
+
+CPropValue::~CPropValue() = default;
+
+std::string CPropValue::packed() const
+{
+  if ( _has_packed )
+    return _packed;
+  if ( !Plib::systemstate.config.profile_cprops )
+    return _imp->pack();
+
+  Tools::HighPerfTimer timer;
+  std::string packed = _imp->pack();
+  CPropProfiler::instance().cachePack( timer.ellapsed().count() );
+  return packed;
+}
+
+Bscript::BObjectImp* CPropValue::decode( bool cache ) const
+{
+  bool profile = Plib::systemstate.config.profile_cprops;
+  Tools::HighPerfTimer timer;
+  if ( _imp != nullptr )
+  {
+    Bscript::BObjectImp* imp = _imp->copy();
+    if ( profile )
+      CPropProfiler::instance().cacheCopy( timer.ellapsed().count() );
+    return imp;
+  }
+
+  Bscript::BObjectImp* imp = Bscript::BObjectImp::unpack( _packed.get().c_str() );
+  if ( profile )
+    CPropProfiler::instance().cacheUnpack( timer.ellapsed().count() );
+  if ( !cache )
+    return imp;
+  _imp.set( imp->copy() );
+  return imp;
+}
+
+bool CPropValue::is_decoded() const
+{
+  return _imp != nullptr;
+}
+
+bool CPropValue::operator==( const CPropValue& other ) const
+{
+  if ( _has_packed && other._has_packed )
+    return _packed == other._packed;
+  if ( _imp == other._imp )
+    return true;
+  return packed() == other.packed();
+}
+
+size_t CPropValue::estimatedSize() const
+{
+  size_t size = sizeof( CPropValue );
+  if ( _imp != nullptr )
+    size += _imp->sizeEstimate();
+  return size;
+}
+
 /**
  * Initialize and register this property list based on a given type
  * register only if the profile_cprops flag is set
@@ -363,8 +552,9 @@ size_t PropertyList::estimatedSize() const
 {
   size_t size = sizeof( PropertyList );
   size += properties.size() *
-          ( sizeof( boost_utils::cprop_name_flystring ) +
-            sizeof( boost_utils::cprop_value_flystring ) + ( sizeof( void* ) * 3 + 1 ) / 2 );
+          ( sizeof( boost_utils::cprop_name_flystring ) + ( sizeof( void* ) * 3 + 1 ) / 2 );
+  for ( const auto& prop : properties )
+    size += prop.second.estimatedSize();
   return size;
 }
 
@@ -380,7 +570,7 @@ bool PropertyList::getprop( const std::string& propname, std::string& propval )
   }
   else
   {
-    propval = ( *itr ).second;
+    propval = ( *itr ).second.packed();
     return true;
   }
 }
@@ -389,7 +579,34 @@ void PropertyList::setprop( const std::string& propname, const std::string& prop
   if ( Plib::systemstate.config.profile_cprops )
     CPropProfiler::instance().cpropWrite( this, propname );
 
-  properties[boost_utils::cprop_name_flystring( propname )] = propvalue;
+  properties[boost_utils::cprop_name_flystring( propname )] = CPropValue( propvalue );
+}
+
+Bscript::BObjectImp* PropertyList::getpropimp( const std::string& propname ) const
+{
+  if ( Plib::systemstate.config.profile_cprops )
+    CPropProfiler::instance().cpropRead( this, propname );
+
+  Properties::const_iterator itr = properties.find( boost_utils::cprop_name_flystring( propname ) );
+  if ( itr == properties.end() )
+    return nullptr;
+  return itr->second.decode( Plib::systemstate.config.cache_decoded_cprops );
+}
+
+void PropertyList::setpropimp( const std::string& propname, const Bscript::BObjectImp& propvalue )
+{
+  if ( Plib::systemstate.config.profile_cprops )
+    CPropProfiler::instance().cpropWrite( this, propname );
+
+  CPropValue& value = properties[boost_utils::cprop_name_flystring( propname )];
+  if ( Plib::systemstate.config.cache_decoded_cprops && is_plain_data( propvalue ) )
+  {
+    value = CPropValue( propvalue.copy() );
+    if ( Plib::systemstate.config.profile_cprops )
+      CPropProfiler::instance().cacheStore();
+  }
+  else
+    value = CPropValue( propvalue.pack() );
 }
 
 void PropertyList::eraseprop( const std::string& propname )
@@ -433,7 +650,7 @@ void PropertyList::printProperties( Clib::StreamWriter& sw ) const
     const std::string& first = prop.first;
     if ( first[0] != '#' )
     {
-      sw() << "\tCProp\t" << first << " " << prop.second.get() << pf_endl;
+      sw() << "\tCProp\t" << first << " " << prop.second.packed() << pf_endl;
     }
   }
 }
@@ -444,7 +661,7 @@ void PropertyList::printProperties( Clib::ConfigElem& elem ) const
     const std::string& first = prop.first;
     if ( first[0] != '#' )
     {
-      elem.add_prop( "CProp", ( first + "\t" + prop.second.get() ) );
+      elem.add_prop( "CProp", ( first + "\t" + prop.second.packed() ) );
     }
   }
 }
@@ -456,7 +673,7 @@ void PropertyList::printPropertiesAsStrings( Clib::StreamWriter& sw ) const
     const std::string& first = prop.first;
     if ( first[0] != '#' )
     {
-      sw() << "\t" << first << " " << prop.second.get() << pf_endl;
+      sw() << "\t" << first << " " << prop.second.packed() << pf_endl;
     }
   }
 }
@@ -530,11 +747,11 @@ Bscript::BObjectImp* CallPropertyListMethod_id( PropertyList& proplist, const in
     const String* propname_str;
     if ( !ex.getStringParam( 0, propname_str ) )
       return new BError( "Invalid parameter type" );
-    std::string val;
-    if ( !proplist.getprop( propname_str->value(), val ) )
+    Bscript::BObjectImp* imp = proplist.getpropimp( propname_str->value() );
+    if ( imp == nullptr )
       return new BError( "Property not found" );
 
-    return Bscript::BObjectImp::unpack( val.c_str() );
+    return imp;
   }
 
   case MTH_SETPROP:
@@ -551,7 +768,7 @@ Bscript::BObjectImp* CallPropertyListMethod_id( PropertyList& proplist, const in
       POLLOG.Format( "wtf, setprop w/ an error '{}' PC:{}\n" ) << ex.scriptname().c_str() << ex.PC;
     }
     std::string propname = propname_str->value();
-    proplist.setprop( propname, propval->pack() );
+    proplist.setpropimp( propname, *propval );
     if ( propname[0] != '#' )
       changed = true;
     return new BLong( 1 );
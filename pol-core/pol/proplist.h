@@ -10,6 +10,7 @@
 #define PROPLIST_H
 
 #include <array>
+#include <atomic>
 #include <boost/flyweight.hpp>
 #include <iosfwd>
 #include <map>
@@ -19,6 +20,7 @@
 
 #include "../clib/boostutils.h"
 #include "../clib/rawtypes.h"
+#include "../clib/refptr.h"
 #include "../clib/spinlock.h"
 
 namespace Pol
@@ -119,10 +121,57 @@ private:
   mutable Clib::SpinLock _proplistsLock;
   mutable Clib::SpinLock _hitsLock;
 
+  /// Usage of the decoded CProps (pol.cfg CacheDecodedCProps), counts and microseconds
+  struct CacheStats
+  {
+    CacheStats();
+    std::atomic<u64> unpacks, unpack_us;
+    std::atomic<u64> copies, copy_us;
+    std::atomic<u64> stores, packs, pack_us;
+  };
+  CacheStats _cache;
+
 public:
   void cpropRead( const PropertyList* proplist, const std::string& name );
   void cpropWrite( const PropertyList* proplist, const std::string& name );
   void cpropErase( const PropertyList* proplist, const std::string& name );
+
+  void cacheUnpack( u64 us );
+  void cacheCopy( u64 us );
+  void cacheStore();
+  void cachePack( u64 us );
+};
+
+/**
+ * Value of a CProp: the packed string as stored in the data files and/or the decoded object.
+ *
+ * With pol.cfg CacheDecodedCProps the value gets decoded on the first read and keeps the object,
+ * writes store a copy of the object and the packing happens when the worldsave needs it.
+ * The object is never modified, readers get a copy of it and writers replace it, so copies of
+ * the value share it.
+ */
+class CPropValue
+{
+public:
+  CPropValue();
+  explicit CPropValue( const std::string& packed );
+  explicit CPropValue( Bscript::BObjectImp* imp );  // takes ownership
+  CPropValue( const CPropValue& other );
+  CPropValue& operator=( const CPropValue& other );
+  ~CPropValue();
+
+  std::string packed() const;
+  /// new object of the value, decodes and keeps it if cache is set
+  Bscript::BObjectImp* decode( bool cache ) const;
+  bool is_decoded() const;
+
+  bool operator==( const CPropValue& other ) const;
+  size_t estimatedSize() const;
+
+private:
+  boost_utils::cprop_value_flystring _packed;
+  bool _has_packed;
+  mutable ref_ptr<Bscript::BObjectImp> _imp;
 };
 
 
@@ -138,6 +187,9 @@ public:
   PropertyList( const PropertyList& );  // dave added 1/26/3
   bool getprop( const std::string& propname, std::string& propvalue ) const;
   void setprop( const std::string& propname, const std::string& propvalue );
+  /// the value as new object, nullptr if there's no such CProp
+  Bscript::BObjectImp* getpropimp( const std::string& propname ) const;
+  void setpropimp( const std::string& propname, const Bscript::BObjectImp& propvalue );
   void eraseprop( const std::string& propname );
   void copyprops( const PropertyList& proplist );
   void getpropnames( std::vector<std::string>& propnames ) const;
@@ -155,8 +207,7 @@ public:
   PropertyList& operator-( const std::set<std::string>& );  // dave added 1/26/3
   void operator-=( const std::set<std::string>& );          // dave added 1/26/3
 protected:
-  typedef std::map<boost_utils::cprop_name_flystring, boost_utils::cprop_value_flystring>
-      Properties;
+  typedef std::map<boost_utils::cprop_name_flystring, CPropValue> Properties;
 
   Properties properties;
 
@@ -35,20 +35,19 @@ Realm::Realm( const std::string& realm_name, const std::string& realm_path )
       _multi_count( 0 ),
       _mapserver( Plib::MapServer::Create( _descriptor ) ),
       _staticserver( new Plib::StaticServer( _descriptor ) ),
-      _maptileserver( new Plib::MapTileServer( _descriptor ) )
+      _maptileserver( new Plib::MapTileServer( _descriptor ) ),
+      _los_generation( 0 ),
+      _los_multi_generation( 0 ),
+      _los_results(),
+      _walk_results(),
+      _walk_results_char_height( 0 )
 {
   _area = Core::Range2d( Core::Pos2d( 0, 0 ),
                          Core::Pos2d( _descriptor.width - 1, _descriptor.height - 1 ), nullptr );
   _gridarea = Core::Range2d( Core::Pos2d( 0, 0 ),
                              Core::Pos2d( _descriptor.grid_width - 1, _descriptor.grid_height - 1 ),
                              nullptr );
-  size_t gridwidth = grid_width();
-  size_t gridheight = grid_height();
-
-  zone = new Core::Zone*[gridheight];
-
-  for ( size_t i = 0; i < gridheight; i++ )
-    zone[i] = new Core::Zone[gridwidth];
+  _zones.reset( new Core::Zone[static_cast<size_t>( grid_width() ) * grid_height()] );
 }
 
 Realm::Realm( const std::string& realm_name, Realm* realm )
@@ -60,44 +59,37 @@ Realm::Realm( const std::string& realm_name, Realm* realm )
       _mobile_count( 0 ),
       _offline_count( 0 ),
       _toplevel_item_count( 0 ),
-      _multi_count( 0 )
+      _multi_count( 0 ),
+      _los_generation( 0 ),
+      _los_multi_generation( 0 ),
+      _los_results(),
+      _walk_results(),
+      _walk_results_char_height( 0 )
 {
   _area = Core::Range2d( Core::Pos2d( 0, 0 ),
                          Core::Pos2d( _descriptor.width - 1, _descriptor.height - 1 ), nullptr );
   _gridarea = Core::Range2d( Core::Pos2d( 0, 0 ),
                              Core::Pos2d( _descriptor.grid_width - 1, _descriptor.grid_height - 1 ),
                              nullptr );
-  size_t gridwidth = grid_width();
-  size_t gridheight = grid_height();
-
-  zone = new Core::Zone*[gridheight];
-
-  for ( size_t i = 0; i < gridheight; i++ )
-    zone[i] = new Core::Zone[gridwidth];
+  _zones.reset( new Core::Zone[static_cast<size_t>( grid_width() ) * grid_height()] );
 }
 
-Realm::~Realm()
-{
-  size_t gridheight = grid_height();
-  for ( size_t i = 0; i < gridheight; i++ )
-    delete[] zone[i];
-  delete[] zone;
-}
+Realm::~Realm() = default;
 
 size_t Realm::sizeEstimate() const
 {
   size_t size = sizeof( *this );
   size += shadowname.capacity();
-  // zone **
   for ( const auto& p : gridarea() )
   {
     const auto& gzone = getzone_grid( p );
-    size += 3 * sizeof( void** ) + gzone.characters.capacity() * sizeof( void* );
-    size += 3 * sizeof( void** ) + gzone.npcs.capacity() * sizeof( void* );
-    size += 3 * sizeof( void** ) + gzone.items.capacity() * sizeof( void* );
-    size += 3 * sizeof( void** ) + gzone.multis.capacity() * sizeof( void* );
+    size += gzone.characters.sizeEstimate() + gzone.npcs.sizeEstimate() +
+            gzone.items.sizeEstimate() + gzone.multis.sizeEstimate();
   }
 
+  size += _los_results.size() * ( sizeof( LosKey ) + sizeof( LosResult ) + 2 * sizeof( void* ) );
+  size += _walk_results.capacity() * sizeof( WalkResult );
+
   // estimated set footprint
   size +=
       3 * sizeof( void* ) + global_hulls.size() * ( sizeof( unsigned int ) + 3 * sizeof( void* ) );
@@ -14,6 +14,7 @@
 #include <set>
 #include <stddef.h>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "plib/mapshape.h"
@@ -149,6 +150,10 @@ public:
   bool dropheight( const Core::Pos3d& drop, short chrz, short* newz, Multi::UMulti** pmulti );
 
   bool has_los( const Core::ULWObject& att, const Core::ULWObject& tgt ) const;
+  // results of has_los are cached (pol.cfg LosCacheSize) until a sight blocking change happens:
+  // an item in one of the zones of the line appears, moves or changes, or any multi changes
+  void invalidate_los( const Core::Pos2d& pos );
+  void invalidate_los_multis();
 
   bool navigable( unsigned short x, unsigned short y, short z, short height ) const  // TODO Pos
   {
@@ -241,6 +246,43 @@ protected:
   void readdynamics( Plib::MapShapeList& vec, const Core::Pos2d& pos,
                      Core::ItemsVector& walkon_items, bool doors_block );
 
+  // standheight over the statics only, the results are cached (pol.cfg WalkCacheSize)
+  void static_standheight( Plib::MOVEMODE movemode, const Core::Pos2d& pos, short oldz,
+                           bool* result, short* newz, short* gradual_boost ) const;
+  struct WalkResult
+  {
+    u64 key;  // x/y/oldz/movemode/boost, 0 for an unused slot
+    short newz;
+    u8 gradual_boost;
+    bool result;
+  };
+
+  // endpoints of a cached los result, x/y/z/height/look height of both and their serials
+  struct LosKey
+  {
+    u64 att;
+    u64 tgt;
+    u32 att_serial;
+    u32 tgt_serial;
+    bool operator==( const LosKey& other ) const
+    {
+      return att == other.att && tgt == other.tgt && att_serial == other.att_serial &&
+             tgt_serial == other.tgt_serial;
+    }
+  };
+  struct LosKeyHash
+  {
+    size_t operator()( const LosKey& key ) const;
+  };
+  struct LosResult
+  {
+    bool los;
+    u64 generation;  // _los_generation when it was computed
+  };
+
+  bool los_path( const Core::ULWObject& att, const Core::ULWObject& tgt ) const;
+  bool los_result_valid( const LosResult& result, const Core::Range2d& area ) const;
+  bool custom_house_near( const Core::Range2d& area ) const;
   static bool dynamic_item_blocks_los( const Core::Pos3d& pos, LosCache& cache );
   bool static_item_blocks_los( const Core::Pos3d& pos, LosCache& cache ) const;
   bool los_blocked( const Core::ULWObject& att, const Core::ULWObject& target,
@@ -257,7 +299,12 @@ private:
   std::unique_ptr<Plib::MapServer> _mapserver;
   std::unique_ptr<Plib::StaticServer> _staticserver;
   std::unique_ptr<Plib::MapTileServer> _maptileserver;
-  Core::Zone** zone;  // y first
+  std::unique_ptr<Core::Zone[]> _zones;  // one block, row by row
+  u64 _los_generation;                    // counts the sight blocking changes
+  u64 _los_multi_generation;              // last change of a multi
+  mutable std::unordered_map<LosKey, LosResult, LosKeyHash> _los_results;
+  mutable std::vector<WalkResult> _walk_results;  // direct mapped by key
+  mutable u8 _walk_results_char_height;           // ssopt they were computed with
   Core::Range2d _area;
   Core::Range2d _gridarea;
 
@@ -343,11 +390,11 @@ inline Core::Range2d Realm::gridarea() const
 
 inline Core::Zone& Realm::getzone_grid( unsigned short x, unsigned short y ) const
 {
-  return zone[y][x];
+  return _zones[static_cast<size_t>( y ) * _descriptor.grid_width + x];
 }
 inline Core::Zone& Realm::getzone_grid( const Core::Pos2d& p ) const
 {
-  return zone[p.y()][p.x()];
+  return getzone_grid( p.x(), p.y() );
 }
 inline Core::Zone& Realm::getzone( unsigned short x, unsigned short y ) const
 {
@@ -32,6 +32,7 @@
 
 #include "core.h"
 #include "fnsearch.h"
+#include "globals/network.h"
 #include "globals/uvars.h"
 #include "item/itemdesc.h"
 #include "landtile.h"
@@ -304,29 +305,85 @@ void Realm::lowest_standheight( Plib::MOVEMODE movemode, Plib::MapShapeList& sha
 void Realm::readdynamics( Plib::MapShapeList& vec, const Core::Pos2d& pos,
                           Core::ItemsVector& walkon_items, bool doors_block )
 {
-  Core::ZoneItems& witems = getzone( pos ).items;
-  for ( const auto& item : witems )
-  {
-    if ( item->pos() == pos )
-    {
-      if ( Plib::tile_flags( item->graphic ) & Plib::FLAG::WALKBLOCK )
+  getzone( pos ).items.for_each_in(
+      Core::Range2d( pos, pos, nullptr ),
+      [&]( Items::Item* item )
       {
-        if ( doors_block || item->itemdesc().type != Items::ItemDesc::DOORDESC )
+        if ( Plib::tile_flags( item->graphic ) & Plib::FLAG::WALKBLOCK )
         {
-          Plib::MapShape shape;
-          shape.z = item->z();
-          shape.height = item->height;
-          shape.flags = Plib::systemstate.tile[item->graphic].flags;
-          vec.push_back( shape );
+          if ( doors_block || item->itemdesc().type != Items::ItemDesc::DOORDESC )
+          {
+            Plib::MapShape shape;
+            shape.z = item->z();
+            shape.height = item->height;
+            shape.flags = Plib::systemstate.tile[item->graphic].flags;
+            vec.push_back( shape );
+          }
         }
-      }
 
-      if ( !item->itemdesc().walk_on_script.empty() )
-      {
-        walkon_items.push_back( item );
-      }
-    }
+        if ( !item->itemdesc().walk_on_script.empty() )
+        {
+          walkon_items.push_back( item );
+        }
+      } );
+}
+
+void Realm::static_standheight( Plib::MOVEMODE movemode, const Core::Pos2d& pos, short oldz,
+                                bool* result_out, short* newz_out, short* gradual_boost ) const
+{
+  static Plib::MapShapeList shapes;
+  unsigned int flags = Plib::FLAG::MOVE_FLAGS;
+  if ( movemode & Plib::MOVEMODE_FLY )
+    flags |= Plib::FLAG::OVERFLIGHT;
+
+  // standheight treats every boost below 5 as 5
+  short boost = 5;
+  if ( gradual_boost != nullptr && *gradual_boost > boost )
+    boost = *gradual_boost;
+  const size_t cache_size = Plib::systemstate.config.walk_cache_size;
+  if ( cache_size == 0 || boost > 0xFF )
+  {
+    shapes.clear();
+    getmapshapes( shapes, pos, flags );
+    standheight( movemode, shapes, oldz, result_out, newz_out, gradual_boost );
+    return;
+  }
+
+  const u8 char_height = Core::settingsManager.ssopt.default_character_height;
+  if ( _walk_results.size() != cache_size || _walk_results_char_height != char_height )
+  {
+    _walk_results.assign( cache_size, WalkResult() );
+    _walk_results_char_height = char_height;
+  }
+  // never 0, boost is at least 5
+  u64 key = ( static_cast<u64>( pos.x() ) << 48 ) | ( static_cast<u64>( pos.y() ) << 32 ) |
+            ( static_cast<u64>( static_cast<u16>( oldz ) ) << 16 ) |
+            ( static_cast<u64>( movemode & 0xFF ) << 8 ) | static_cast<u64>( boost );
+  // fold the position into the low half, the upper bits of the product depend only on those
+  u64 h = ( key ^ ( key >> 32 ) ) * 0x9E3779B97F4A7C15ull;
+  WalkResult& slot = _walk_results[( h >> 32 ) % cache_size];
+  if ( slot.key == key )
+  {
+    ++Core::networkManager.polstats.walk_cache_hits;
+  }
+  else
+  {
+    ++Core::networkManager.polstats.walk_cache_misses;
+    shapes.clear();
+    getmapshapes( shapes, pos, flags );
+    bool result;
+    short newz;
+    short new_boost = boost;
+    standheight( movemode, shapes, oldz, &result, &newz, &new_boost );
+    slot.key = key;
+    slot.newz = newz;
+    slot.gradual_boost = static_cast<u8>( new_boost );
+    slot.result = result;
   }
+  *result_out = slot.result;
+  *newz_out = slot.newz;
+  if ( slot.result && gradual_boost != nullptr )
+    *gradual_boost = slot.gradual_boost;
 }
 
 
@@ -352,10 +409,15 @@ bool Realm::walkheight( const Core::Pos2d& pos, short oldz, short* newz, Multi::
   if ( movemode & Plib::MOVEMODE_FLY )
     flags |= Plib::FLAG::OVERFLIGHT;
   readmultis( shapes, pos, flags, mvec );
-  getmapshapes( shapes, pos, flags );
 
   bool result;
-  standheight( movemode, shapes, oldz, &result, newz, gradual_boost );
+  if ( shapes.empty() )  // nothing but statics
+    static_standheight( movemode, pos, oldz, &result, newz, gradual_boost );
+  else
+  {
+    getmapshapes( shapes, pos, flags );
+    standheight( movemode, shapes, oldz, &result, newz, gradual_boost );
+  }
 
   if ( result && ( pwalkon != nullptr ) )
   {
@@ -405,10 +467,15 @@ bool Realm::walkheight( const Mobile::Character* chr, const Core::Pos2d& pos, sh
   if ( chr->movemode & Plib::MOVEMODE_FLY )
     flags |= Plib::FLAG::OVERFLIGHT;
   readmultis( shapes, pos, flags, mvec );
-  getmapshapes( shapes, pos, flags );
 
   bool result;
-  standheight( chr->movemode, shapes, oldz, &result, newz, gradual_boost );
+  if ( shapes.empty() )  // nothing but statics
+    static_standheight( chr->movemode, pos, oldz, &result, newz, gradual_boost );
+  else
+  {
+    getmapshapes( shapes, pos, flags );
+    standheight( chr->movemode, shapes, oldz, &result, newz, gradual_boost );
+  }
 
   if ( result && ( pwalkon != nullptr ) )
   {
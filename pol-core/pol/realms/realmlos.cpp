@@ -7,9 +7,13 @@
 #include "clib/rawtypes.h"
 #include "plib/mapcell.h"
 
+#include "plib/systemstate.h"
+
 #include "baseobject.h"
+#include "globals/network.h"
 #include "item/item.h"
 #include "mobile/charactr.h"
+#include "multi/house.h"
 #include "realms/realm.h"
 #include "uworld.h"
 
@@ -144,6 +148,55 @@ s8 clip_s8( int v )
 /// take sign of a, either -1, 0, or 1
 #define ZSGN( a ) ( ( ( a ) < 0 ) ? -1 : ( a ) > 0 ? 1 : 0 )
 
+size_t Realm::LosKeyHash::operator()( const LosKey& key ) const
+{
+  u64 h = key.att * 0x9E3779B97F4A7C15ull;
+  h ^= key.tgt + 0x7F4A7C159E3779B9ull + ( h << 6 ) + ( h >> 2 );
+  h ^= ( static_cast<u64>( key.att_serial ) << 32 | key.tgt_serial ) + ( h << 6 ) + ( h >> 2 );
+  return static_cast<size_t>( h );
+}
+
+void Realm::invalidate_los( const Core::Pos2d& pos )
+{
+  getzone( pos ).los_generation = ++_los_generation;
+}
+
+void Realm::invalidate_los_multis()
+{
+  _los_multi_generation = ++_los_generation;
+}
+
+bool Realm::los_result_valid( const LosResult& result, const Core::Range2d& area ) const
+{
+  if ( _los_multi_generation > result.generation )
+    return false;
+  // the line stays inside of the area, so only the items of its zones matter
+  const Core::Pos2d nw = Core::zone_convert( area.nw() );
+  const Core::Pos2d se = Core::zone_convert( area.se() );
+  for ( const auto& p : Core::Range2d( nw, se, nullptr ) )
+  {
+    if ( getzone_grid( p ).los_generation > result.generation )
+      return false;
+  }
+  return true;
+}
+
+bool Realm::custom_house_near( const Core::Range2d& area ) const
+{
+  // readmultis looks at the multis in a range of 64 around each position
+  const Core::Vec2d range( 64, 64 );
+  bool found = false;
+  Core::WorldIterator<Core::MultiFilter>::InBox(
+      Core::Range2d( area.nw() - range, area.se() + range, this ), this,
+      [&]( Multi::UMulti* multi )
+      {
+        Multi::UHouse* house = multi->as_house();
+        if ( house != nullptr && house->IsCustom() )
+          found = true;
+      } );
+  return found;
+}
+
 /**
  * @ingroup los3d
  */
@@ -169,6 +222,50 @@ bool Realm::has_los( const Core::ULWObject& att, const Core::ULWObject& tgt ) co
     if ( att.realm() != tgt.realm() )
       return false;
   }
+
+  const size_t cache_size = Plib::systemstate.config.los_cache_size;
+  if ( !cache_size || abs( att.x() - tgt.x() ) > los_range ||
+       abs( att.y() - tgt.y() ) > los_range )
+    return los_path( att, tgt );
+
+  auto pack = []( const Core::ULWObject& obj ) -> u64
+  {
+    return ( static_cast<u64>( obj.x() ) << 48 ) | ( static_cast<u64>( obj.y() ) << 32 ) |
+           ( static_cast<u64>( static_cast<u8>( obj.z() ) ) << 24 ) |
+           ( static_cast<u64>( obj.height ) << 16 ) | ( static_cast<u64>( obj.look_height() ) << 8 );
+  };
+  const LosKey key{ pack( att ), pack( tgt ), att.serial, tgt.serial };
+  const Core::Range2d area( att.pos(), tgt.pos() );
+  auto& stats = Core::networkManager.polstats;
+
+  auto itr = _los_results.find( key );
+  if ( itr != _los_results.end() && los_result_valid( itr->second, area ) )
+  {
+    ++stats.los_cache_hits;
+    return itr->second.los;
+  }
+  ++stats.los_cache_misses;
+  bool result = los_path( att, tgt );
+  // the working designs of custom houses change without notice
+  if ( !custom_house_near( area ) )
+  {
+    if ( itr != _los_results.end() )
+      itr->second = LosResult{ result, _los_generation };
+    else
+    {
+      if ( _los_results.size() >= cache_size )
+        _los_results.clear();
+      _los_results.emplace( key, LosResult{ result, _los_generation } );
+    }
+  }
+  return result;
+}
+
+/**
+ * @ingroup los3d
+ */
+bool Realm::los_path( const Core::ULWObject& att, const Core::ULWObject& tgt ) const
+{
   // due to the nature of los check the same x,y coordinates get checked, cache the last used
   // coords to reduce the expensive map/multi read per coordinate
   static thread_local LosCache cache;
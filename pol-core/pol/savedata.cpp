@@ -10,6 +10,7 @@
 #include <cerrno>
 #include <exception>
 #include <fstream>
+#include <sstream>
 
 #include "../clib/clib_endian.h"
 #include "../clib/fileutil.h"
@@ -26,6 +27,7 @@
 #include "item/itemdesc.h"
 #include "objecthash.h"
 #include "storage.h"
+#include "uimport.h"
 #include "uobject.h"
 
 namespace Pol
@@ -226,6 +228,58 @@ bool commit_incremental( const std::string& basename )
   return any;
 }
 
+// the classic format, an incr-data-N/incr-index-N file pair per save
+void write_incremental_files()
+{
+  std::ofstream ofs_data;
+  std::ofstream ofs_index;
+
+  ofs_data.exceptions( std::ios_base::failbit | std::ios_base::badbit );
+  ofs_index.exceptions( std::ios_base::failbit | std::ios_base::badbit );
+
+  unsigned save_index = objStorageManager.incremental_save_count + 1;
+  std::string data_basename = "incr-data-" + Clib::tostring( save_index );
+  std::string index_basename = "incr-index-" + Clib::tostring( save_index );
+  std::string data_pathname = Plib::systemstate.config.world_data_path + data_basename + ".ndt";
+  std::string index_pathname = Plib::systemstate.config.world_data_path + index_basename + ".ndt";
+  Clib::open_file( ofs_data, data_pathname, std::ios::out );
+  Clib::open_file( ofs_index, index_pathname, std::ios::out );
+  Clib::OFStreamWriter sw_data( &ofs_data );
+  write_system_data( sw_data );
+  write_global_properties( sw_data );
+
+  // TODO:
+  //  guilds
+  //  resources
+  //  datastore
+
+  write_dirty_storage( sw_data );
+  write_dirty_data( sw_data );
+
+  write_index( ofs_index );
+
+  ofs_data.close();
+  ofs_index.close();
+
+  commit_incremental( data_basename );
+  commit_incremental( index_basename );
+}
+
+// pol.cfg IncrementalSaveJournal: the same content as one record of the journal
+void write_incremental_journal()
+{
+  std::ostringstream os_data;
+  Clib::OStreamWriter sw_data( &os_data );
+  write_system_data( sw_data );
+  write_global_properties( sw_data );
+  write_dirty_storage( sw_data );
+  write_dirty_data( sw_data );
+  sw_data.flush_file();
+
+  objStorageManager.journal.append( objStorageManager.modified_serials,
+                                    objStorageManager.deleted_serials, os_data.str() );
+}
+
 int save_incremental( unsigned int& dirty, unsigned int& clean, long long& elapsed_ms )
 {
   if ( !should_write_data() )
@@ -240,6 +294,20 @@ int save_incremental( unsigned int& dirty, unsigned int& clean, long long& elaps
         "Incremental saves are disabled until the next full save, due to a previous incremental "
         "save failure (dirty flags are inconsistent)" );
 
+  // the journal stays in use till the next full save, since it's loaded after the incr-data files
+  bool use_journal = Plib::systemstate.config.incremental_save_journal ||
+                     objStorageManager.journal.record_count() > 0;
+  if ( use_journal && Plib::systemstate.config.journal_compact_size &&
+       objStorageManager.journal.size() >=
+           Plib::systemstate.config.journal_compact_size * 1024ull * 1024ull )
+  {
+    // a full save is written in the background and replaces the journal
+    POLLOG_INFO.Format( "Save journal has {} records ({} MB), folding it into a full save.\n" )
+        << objStorageManager.journal.record_count()
+        << objStorageManager.journal.size() / ( 1024 * 1024 );
+    return write_data( dirty, clean, elapsed_ms );
+  }
+
   try
   {
     Tools::Timer<> timer;
@@ -248,41 +316,13 @@ int save_incremental( unsigned int& dirty, unsigned int& clean, long long& elaps
     objStorageManager.modified_serials.clear();
     objStorageManager.deleted_serials.clear();
 
-    std::ofstream ofs_data;
-    std::ofstream ofs_index;
-
-    ofs_data.exceptions( std::ios_base::failbit | std::ios_base::badbit );
-    ofs_index.exceptions( std::ios_base::failbit | std::ios_base::badbit );
-
-    unsigned save_index = objStorageManager.incremental_save_count + 1;
-    std::string data_basename = "incr-data-" + Clib::tostring( save_index );
-    std::string index_basename = "incr-index-" + Clib::tostring( save_index );
-    std::string data_pathname = Plib::systemstate.config.world_data_path + data_basename + ".ndt";
-    std::string index_pathname = Plib::systemstate.config.world_data_path + index_basename + ".ndt";
-    Clib::open_file( ofs_data, data_pathname, std::ios::out );
-    Clib::open_file( ofs_index, index_pathname, std::ios::out );
-    Clib::OFStreamWriter sw_data( &ofs_data );
-    write_system_data( sw_data );
-    write_global_properties( sw_data );
-
-    // TODO:
-    //  guilds
-    //  resources
-    //  datastore
-
-    write_dirty_storage( sw_data );
-    write_dirty_data( sw_data );
-
-    write_index( ofs_index );
-
-    ofs_data.close();
-    ofs_index.close();
+    if ( use_journal )
+      write_incremental_journal();
+    else
+      write_incremental_files();
 
     objStorageManager.modified_serials.clear();
     objStorageManager.deleted_serials.clear();
-
-    commit_incremental( data_basename );
-    commit_incremental( index_basename );
     ++objStorageManager.incremental_save_count;
 
     timer.stop();
@@ -9,6 +9,7 @@
 
 #include <fstream>
 #include <future>
+#include <memory>
 #include <string>
 
 #include "../clib/streamsaver.h"
@@ -31,6 +32,13 @@ private:
   std::ofstream _npcequip;
   std::ofstream _items;
   std::ofstream _multis;
+  // object files, text or binary snapshot depending on pol.cfg BinaryWorldSave
+  std::unique_ptr<Clib::StreamWriter> _pcs_writer;
+  std::unique_ptr<Clib::StreamWriter> _pcequip_writer;
+  std::unique_ptr<Clib::StreamWriter> _npcs_writer;
+  std::unique_ptr<Clib::StreamWriter> _npcequip_writer;
+  std::unique_ptr<Clib::StreamWriter> _items_writer;
+  std::unique_ptr<Clib::StreamWriter> _multis_writer;
   std::ofstream _storage;
   std::ofstream _resource;
   std::ofstream _guilds;
@@ -38,18 +46,18 @@ private:
   std::ofstream _party;
 
 public:
-  SaveContext();
+  explicit SaveContext( bool binary_objects = false );
   ~SaveContext();
   SaveContext( const SaveContext& ) = delete;
   SaveContext& operator=( const SaveContext& ) = delete;
   SaveStrategy pol;
   SaveStrategy objects;
-  SaveStrategy pcs;
-  SaveStrategy pcequip;
-  SaveStrategy npcs;
-  SaveStrategy npcequip;
-  SaveStrategy items;
-  SaveStrategy multis;
+  Clib::StreamWriter& pcs;
+  Clib::StreamWriter& pcequip;
+  Clib::StreamWriter& npcs;
+  Clib::StreamWriter& npcequip;
+  Clib::StreamWriter& items;
+  Clib::StreamWriter& multis;
   SaveStrategy storage;
   SaveStrategy resource;
   SaveStrategy guilds;
@@ -66,7 +74,10 @@ void write_system_data( Clib::StreamWriter& sw );
 void write_global_properties( Clib::StreamWriter& sw );
 void write_shadow_realms( Clib::StreamWriter& sw );
 
+bool commit_files( const std::string& bakfile, const std::string& datfile,
+                   const std::string& ndtfile );
 bool commit( const std::string& basename );
+bool commit_object_file( const std::string& basename, bool binary );
 void commit_incremental_saves();
 bool should_write_data();
 }  // namespace Core
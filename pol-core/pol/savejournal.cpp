@@ -0,0 +1,388 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "savejournal.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <zlib.h>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <share.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "../clib/fileutil.h"
+#include "../clib/logfacility.h"
+#include "../clib/mappedfile.h"
+#include "../plib/systemstate.h"
+#include "savedata.h"
+
+namespace Pol
+{
+namespace Core
+{
+namespace
+{
+const char JOURNAL_MAGIC[8] = {'P', 'O', 'L', 'J', 'R', 'N', 'L', '\0'};
+const u32 JOURNAL_VERSION = 1;
+const size_t JOURNAL_HEADER_SIZE = sizeof JOURNAL_MAGIC + 4;
+const u32 RECORD_MAGIC = 0x4345524A;  // "JREC"
+const size_t RECORD_HEADER_SIZE = 5 * 4;
+
+void put_u32( std::string& buf, u32 value )
+{
+  buf.push_back( static_cast<char>( value & 0xFF ) );
+  buf.push_back( static_cast<char>( ( value >> 8 ) & 0xFF ) );
+  buf.push_back( static_cast<char>( ( value >> 16 ) & 0xFF ) );
+  buf.push_back( static_cast<char>( ( value >> 24 ) & 0xFF ) );
+}
+
+u32 get_u32( const char* data )
+{
+  const unsigned char* p = reinterpret_cast<const unsigned char*>( data );
+  return p[0] | ( p[1] << 8 ) | ( p[2] << 16 ) | ( static_cast<u32>( p[3] ) << 24 );
+}
+
+u32 record_crc( const char* header, const char* payload, size_t payload_size )
+{
+  // sequence and sizes, without magic and the crc itself
+  uLong crc = crc32( 0L, Z_NULL, 0 );
+  crc = crc32( crc, reinterpret_cast<const Bytef*>( header + 4 ), 12 );
+  crc = crc32( crc, reinterpret_cast<const Bytef*>( payload ), static_cast<uInt>( payload_size ) );
+  return static_cast<u32>( crc );
+}
+
+bool sync_fd( int fd )
+{
+#ifdef _WIN32
+  return _commit( fd ) == 0;
+#else
+  return fsync( fd ) == 0;
+#endif
+}
+
+bool truncate_file( const std::string& filename, u64 size )
+{
+#ifdef _WIN32
+  int fd;
+  if ( _sopen_s( &fd, filename.c_str(), _O_RDWR | _O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE ) )
+    return false;
+  bool res = _chsize_s( fd, static_cast<__int64>( size ) ) == 0;
+  _close( fd );
+  return res;
+#else
+  return truncate( filename.c_str(), static_cast<off_t>( size ) ) == 0;
+#endif
+}
+
+// reads the serial lists of a record, false if they don't fit into the index
+bool parse_index( const char* index, size_t size, SaveJournal::Record& rec )
+{
+  size_t pos = 0;
+  for ( auto* serials : {&rec.modified, &rec.deleted} )
+  {
+    if ( pos + 4 > size )
+      return false;
+    u32 count = get_u32( index + pos );
+    pos += 4;
+    if ( count > ( size - pos ) / 4 )
+      return false;
+    serials->reserve( count );
+    for ( u32 i = 0; i < count; ++i, pos += 4 )
+      serials->push_back( get_u32( index + pos ) );
+  }
+  return pos == size;
+}
+}  // namespace
+
+SaveJournal::SaveJournal()
+    : _mutex(),
+      _cond(),
+      _file( nullptr ),
+      _sync_thread(),
+      _unsynced( false ),
+      _stop( false ),
+      _next_sequence( 1 ),
+      _records( 0 ),
+      _size( 0 ),
+      _recovered()
+{
+}
+
+SaveJournal::~SaveJournal()
+{
+  close();
+}
+
+std::string SaveJournal::filename()
+{
+  return Plib::systemstate.config.world_data_path + "journal.dat";
+}
+
+const std::vector<SaveJournal::Record>& SaveJournal::recover()
+{
+  _recovered.clear();
+  std::string fname = filename();
+  if ( !Clib::FileExists( fname ) )
+    return _recovered;
+
+  size_t file_size;
+  size_t valid = 0;
+  {
+    Clib::MappedFile file( fname );
+    const char* data = file.data();
+    file_size = file.size();
+    if ( file_size >= JOURNAL_HEADER_SIZE )
+    {
+      if ( std::memcmp( data, JOURNAL_MAGIC, sizeof JOURNAL_MAGIC ) != 0 )
+        throw std::runtime_error( fname + " is not a save journal" );
+      u32 version = get_u32( data + sizeof JOURNAL_MAGIC );
+      if ( version != JOURNAL_VERSION )
+        throw std::runtime_error( "Unsupported save journal version " +
+                                  std::to_string( version ) );
+      valid = JOURNAL_HEADER_SIZE;
+    }
+
+    while ( valid && valid + RECORD_HEADER_SIZE <= file_size )
+    {
+      const char* header = data + valid;
+      if ( get_u32( header ) != RECORD_MAGIC )
+        break;
+      Record rec;
+      rec.sequence = get_u32( header + 4 );
+      size_t index_size = get_u32( header + 8 );
+      size_t data_size = get_u32( header + 12 );
+      if ( rec.sequence != _recovered.size() + 1 ||
+           index_size + data_size > file_size - valid - RECORD_HEADER_SIZE )
+        break;
+      const char* payload = header + RECORD_HEADER_SIZE;
+      if ( record_crc( header, payload, index_size + data_size ) != get_u32( header + 16 ) ||
+           !parse_index( payload, index_size, rec ) )
+        break;
+      rec.data_offset = valid + RECORD_HEADER_SIZE + index_size;
+      rec.data_size = data_size;
+      _recovered.push_back( std::move( rec ) );
+      valid += RECORD_HEADER_SIZE + index_size + data_size;
+    }
+  }
+
+  if ( valid < file_size )
+  {
+    POLLOG_ERROR.Format(
+        "{}: {} bytes after record {} are incomplete or damaged (crash while saving?), they get "
+        "cut off\n" )
+        << fname << file_size - valid << _recovered.size();
+    if ( !truncate_file( fname, valid ) )
+    {
+      int err = errno;
+      ERROR_PRINT.Format( "Unable to truncate {}: {} ({})\n" ) << fname << strerror( err ) << err;
+      throw std::runtime_error( "Human intervention required." );
+    }
+  }
+  _next_sequence = static_cast<u32>( _recovered.size() + 1 );
+  _records = _recovered.size();
+  _size = valid;
+  return _recovered;
+}
+
+const std::vector<SaveJournal::Record>& SaveJournal::recovered() const
+{
+  return _recovered;
+}
+
+void SaveJournal::clear_recovered()
+{
+  _recovered.clear();
+  _recovered.shrink_to_fit();
+}
+
+void SaveJournal::open()
+{
+  std::string fname = filename();
+  _file = std::fopen( fname.c_str(), "ab" );
+  if ( _file == nullptr )
+  {
+    int err = errno;
+    throw std::runtime_error( "Unable to open " + fname + ": " + strerror( err ) );
+  }
+  std::fseek( _file, 0, SEEK_END );
+  long existing = std::ftell( _file );
+  if ( existing < 0 || static_cast<u64>( existing ) != _size )
+  {
+    std::fclose( _file );
+    _file = nullptr;
+    throw std::runtime_error( fname + " was changed while the server is running" );
+  }
+  if ( _size == 0 )
+  {
+    std::string header( JOURNAL_MAGIC, sizeof JOURNAL_MAGIC );
+    put_u32( header, JOURNAL_VERSION );
+    if ( std::fwrite( header.data(), 1, header.size(), _file ) != header.size() ||
+         std::fflush( _file ) != 0 )
+    {
+      int err = errno;
+      std::fclose( _file );
+      _file = nullptr;
+      throw std::runtime_error( "Unable to write " + fname + ": " + strerror( err ) );
+    }
+    _size = header.size();
+  }
+
+  unsigned int interval_ms = Plib::systemstate.config.journal_sync_interval;
+  if ( interval_ms )
+    _sync_thread = std::thread( [this, interval_ms]() { sync_thread( interval_ms ); } );
+}
+
+void SaveJournal::append( const std::vector<u32>& modified, const std::vector<u32>& deleted,
+                          const std::string& data )
+{
+  std::string index;
+  index.reserve( 8 + 4 * ( modified.size() + deleted.size() ) );
+  put_u32( index, static_cast<u32>( modified.size() ) );
+  for ( u32 serial : modified )
+    put_u32( index, serial );
+  put_u32( index, static_cast<u32>( deleted.size() ) );
+  for ( u32 serial : deleted )
+    put_u32( index, serial );
+  if ( index.size() + data.size() > 0xFFFFFFFF - RECORD_HEADER_SIZE )
+    throw std::runtime_error( "Save journal record is too large" );
+
+  int err = 0;
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    if ( _file == nullptr )
+      open();
+
+    std::string header;
+    put_u32( header, RECORD_MAGIC );
+    put_u32( header, _next_sequence );
+    put_u32( header, static_cast<u32>( index.size() ) );
+    put_u32( header, static_cast<u32>( data.size() ) );
+    uLong crc = crc32( 0L, Z_NULL, 0 );
+    crc = crc32( crc, reinterpret_cast<const Bytef*>( header.data() + 4 ), 12 );
+    crc = crc32( crc, reinterpret_cast<const Bytef*>( index.data() ),
+                 static_cast<uInt>( index.size() ) );
+    crc = crc32( crc, reinterpret_cast<const Bytef*>( data.data() ),
+                 static_cast<uInt>( data.size() ) );
+    put_u32( header, static_cast<u32>( crc ) );
+
+    if ( std::fwrite( header.data(), 1, header.size(), _file ) == header.size() &&
+         std::fwrite( index.data(), 1, index.size(), _file ) == index.size() &&
+         std::fwrite( data.data(), 1, data.size(), _file ) == data.size() &&
+         std::fflush( _file ) == 0 )
+    {
+      _size += header.size() + index.size() + data.size();
+      ++_records;
+      ++_next_sequence;
+      if ( _sync_thread.joinable() )
+      {
+        _unsynced = true;
+        _cond.notify_all();
+      }
+      else if ( !sync_fd( fileno( _file ) ) )
+      {
+        err = errno;
+        POLLOG_ERROR.Format( "Unable to sync {}: {} ({})\n" ) << filename() << strerror( err )
+                                                               << err;
+      }
+      return;
+    }
+    err = errno;
+  }
+
+  // a partial record would hide all following ones, remove it again
+  close();
+  std::string fname = filename();
+  if ( !truncate_file( fname, _size ) )
+  {
+    int trunc_err = errno;
+    POLLOG_ERROR.Format( "Unable to truncate {}: {} ({})\n" ) << fname << strerror( trunc_err )
+                                                              << trunc_err;
+  }
+  throw std::runtime_error( "Unable to write " + fname + ": " + strerror( err ) );
+}
+
+void SaveJournal::sync_thread( unsigned int interval_ms )
+{
+  std::unique_lock<std::mutex> lock( _mutex );
+  while ( !_stop )
+  {
+    _cond.wait( lock, [this]() { return _stop || _unsynced; } );
+    // records appended within the interval get synced together
+    _cond.wait_for( lock, std::chrono::milliseconds( interval_ms ), [this]() { return _stop; } );
+    if ( _stop )
+      break;  // close() syncs the rest
+    _unsynced = false;
+    // close() joins this thread before closing the file, so the fd stays valid
+    int fd = fileno( _file );
+    lock.unlock();
+    bool res = sync_fd( fd );
+    int err = errno;
+    lock.lock();
+    if ( !res )
+      POLLOG_ERROR.Format( "Unable to sync {}: {} ({})\n" ) << filename() << strerror( err ) << err;
+  }
+}
+
+void SaveJournal::stop_sync_thread()
+{
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    _stop = true;
+  }
+  _cond.notify_all();
+  if ( _sync_thread.joinable() )
+    _sync_thread.join();
+  _stop = false;
+}
+
+void SaveJournal::close()
+{
+  stop_sync_thread();
+  std::lock_guard<std::mutex> lock( _mutex );
+  if ( _file == nullptr )
+    return;
+  if ( std::fflush( _file ) != 0 || ( _unsynced && !sync_fd( fileno( _file ) ) ) )
+  {
+    int err = errno;
+    POLLOG_ERROR.Format( "Unable to sync {}: {} ({})\n" ) << filename() << strerror( err ) << err;
+  }
+  std::fclose( _file );
+  _file = nullptr;
+  _unsynced = false;
+}
+
+void SaveJournal::rotate()
+{
+  close();
+  std::string fname = filename();
+  commit_files( Plib::systemstate.config.world_data_path + "journal.bak", fname, "" );
+  std::lock_guard<std::mutex> lock( _mutex );
+  _next_sequence = 1;
+  _records = 0;
+  _size = 0;
+}
+
+size_t SaveJournal::record_count() const
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+  return _records;
+}
+
+u64 SaveJournal::size() const
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+  return _size;
+}
+}  // namespace Core
+}  // namespace Pol
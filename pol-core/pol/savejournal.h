@@ -0,0 +1,91 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef SAVEJOURNAL_H
+#define SAVEJOURNAL_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../clib/rawtypes.h"
+
+namespace Pol
+{
+namespace Core
+{
+// Append-only journal of the incremental saves (pol.cfg IncrementalSaveJournal). A record holds
+// the same as an incr-index-N.txt/incr-data-N.txt pair, instead of two new files per save
+// the record gets appended to journal.dat.
+//
+// Layout, all integers little endian:
+//   header  "POLJRNL\0", u32 version
+//   record  u32 magic "JREC", u32 sequence, u32 index size, u32 data size, u32 crc32
+//           index: u32 count, modified serials, u32 count, deleted serials
+//           data:  config text, the same as in incr-data-N.txt
+// The crc covers sequence, sizes, index and data. A record which is incomplete or has a wrong
+// crc ends the journal, it's what remains of a crash while appending.
+//
+// Appends only hand the record to the OS, a background thread syncs the file at most once per
+// pol.cfg JournalSyncInterval. A full save contains everything of the journal, so it moves
+// the journal to journal.bak.
+class SaveJournal
+{
+public:
+  struct Record
+  {
+    u32 sequence;
+    size_t data_offset;
+    size_t data_size;
+    std::vector<u32> modified;
+    std::vector<u32> deleted;
+  };
+
+  SaveJournal();
+  ~SaveJournal();
+  SaveJournal( const SaveJournal& ) = delete;
+  SaveJournal& operator=( const SaveJournal& ) = delete;
+
+  static std::string filename();
+
+  // reads the journal during startup, a damaged tail gets cut off
+  const std::vector<Record>& recover();
+  const std::vector<Record>& recovered() const;
+  void clear_recovered();
+
+  // throws if the record couldn't be written, the journal is unchanged then
+  void append( const std::vector<u32>& modified, const std::vector<u32>& deleted,
+               const std::string& data );
+  // after a full save: the records are part of the data files now
+  void rotate();
+  // syncs and closes the file, the next append opens it again
+  void close();
+
+  size_t record_count() const;
+  u64 size() const;
+
+private:
+  void open();
+  void sync_thread( unsigned int interval_ms );
+  void stop_sync_thread();
+
+  mutable std::mutex _mutex;
+  std::condition_variable _cond;
+  std::FILE* _file;
+  std::thread _sync_thread;
+  bool _unsynced;
+  bool _stop;
+  u32 _next_sequence;
+  size_t _records;
+  u64 _size;
+  std::vector<Record> _recovered;
+};
+}  // namespace Core
+}  // namespace Pol
+#endif
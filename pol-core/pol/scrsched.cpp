@@ -72,39 +72,28 @@ void check_blocked( polclock_t* pclocksleft )
   polclock_t now_clock = polclock();
   stateManager.profilevars.sleep_cycles +=
       scriptScheduler.getHoldlist().size() + scriptScheduler.getNoTimeoutHoldlist().size();
-  polclock_t clocksleft = POLCLOCKS_PER_SEC * 60;
   for ( ;; )
   {
     THREAD_CHECKPOINT( scripts, 131 );
 
-    auto itr = scriptScheduler.getHoldlist().cbegin();
-    if ( itr == scriptScheduler.getHoldlist().cend() )
+    UOExecutor* ex = scriptScheduler.next_expired( now_clock );
+    if ( ex == nullptr )
       break;
-
-    UOExecutor* ex = ( *itr ).second;
     // ++ex->sleep_cycles;
 
     passert( ex->blocked() );
     passert( ex->sleep_until_clock() != 0 );
-    clocksleft = ex->sleep_until_clock() - now_clock;
-    if ( clocksleft <= 0 )
-    {
-      if ( clocksleft == 0 )
-        INC_PROFILEVAR( scripts_ontime );
-      else
-        INC_PROFILEVAR( scripts_late );
-      // wakey-wakey
-      // read comment above to understand what goes on here.
-      // the return value is already on the stack.
-      THREAD_CHECKPOINT( scripts, 132 );
-      ex->revive();
-    }
+    if ( ex->sleep_until_clock() == now_clock )
+      INC_PROFILEVAR( scripts_ontime );
     else
-    {
-      break;
-    }
-  }
-  *pclocksleft = clocksleft;
+      INC_PROFILEVAR( scripts_late );
+    // wakey-wakey
+    // read comment above to understand what goes on here.
+    // the return value is already on the stack.
+    THREAD_CHECKPOINT( scripts, 132 );
+    ex->revive();
+  }
+  *pclocksleft = scriptScheduler.getHoldlist().clocks_left( now_clock, POLCLOCKS_PER_SEC * 60 );
 }
 
 void step_scripts( polclock_t* clocksleft, bool* pactivity )
@@ -166,24 +166,27 @@ void log_all_script_cycle_counts( bool clear_counters )
       << ( GET_PROFILEVAR( scheduler_passes ) ) << stateManager.profilevars.script_passes;
 
   fmt::Writer tmp;
-  tmp.Format( "{:<38} {:>12} {:>6} {:>12} {:>6}\n" ) << "Script"
-                                                     << "cycles"
-                                                     << "incov"
-                                                     << "cyc/invoc"
-                                                     << "%";
+  tmp.Format( "{:<38} {:>12} {:>6} {:>12} {:>6} {:>12}\n" ) << "Script"
+                                                            << "cycles"
+                                                            << "incov"
+                                                            << "cyc/invoc"
+                                                            << "%"
+                                                            << "detached";
   for ( const auto& scr : scriptScheduler.scrstore )
   {
     Bscript::EScriptProgram* eprog = scr.second.get();
     double cycle_percent =
         total_instr != 0 ? ( static_cast<double>( eprog->instr_cycles ) / total_instr * 100.0 ) : 0;
-    tmp.Format( "{:<38} {:>12} {:>6} {:>12} {:>6}\n" )
+    tmp.Format( "{:<38} {:>12} {:>6} {:>12} {:>6} {:>12}\n" )
         << eprog->name << eprog->instr_cycles << eprog->invocations
         << ( eprog->instr_cycles / ( eprog->invocations ? eprog->invocations : 1 ) )
-        << cycle_percent;
+        << cycle_percent << eprog->detached_instr_cycles;
     if ( clear_counters )
     {
       eprog->instr_cycles = 0;
       eprog->invocations = eprog->count() - 1;  // 1 count is the scrstore's
+      eprog->detached_instr_cycles = 0;
+      eprog->detached_invocations = 0;
     }
   }
   POLLOG << tmp.str();
@@ -199,6 +202,8 @@ void clear_script_profile_counters()
     Bscript::EScriptProgram* eprog = scr.second.get();
     eprog->instr_cycles = 0;
     eprog->invocations = eprog->count() - 1;  // 1 count is the scrstore's
+    eprog->detached_instr_cycles = 0;
+    eprog->detached_invocations = 0;
   }
 
   POLLOG << "Profiling counters cleared.\n";
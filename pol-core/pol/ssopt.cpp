@@ -72,6 +72,7 @@ void ServSpecOpt::read_servspecopt()
   settingsManager.ssopt.event_visibility_core_checks =
       elem.remove_bool( "EventVisibilityCoreChecks", false );
   settingsManager.ssopt.max_pathfind_range = elem.remove_ulong( "MaxPathFindRange", 50 );
+  settingsManager.ssopt.max_pathfind_nodes = elem.remove_ulong( "MaxPathFindNodes", 1000 );
   settingsManager.ssopt.movement_uses_stamina = elem.remove_bool( "MovementUsesStamina", false );
   settingsManager.ssopt.use_tile_flag_prefix = elem.remove_bool( "UseTileFlagPrefix", true );
   settingsManager.ssopt.default_container_max_items =
@@ -49,6 +49,7 @@ struct ServSpecOpt
   unsigned short default_light_level;
   bool event_visibility_core_checks;
   unsigned int max_pathfind_range;
+  unsigned int max_pathfind_nodes;
   bool movement_uses_stamina;
   bool use_tile_flag_prefix;
   unsigned short default_container_max_items;
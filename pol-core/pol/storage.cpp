@@ -9,7 +9,6 @@
 
 #include <exception>
 #include <string>
-#include <time.h>
 
 #include "../bscript/berror.h"
 #include "../bscript/bobject.h"
@@ -17,10 +16,12 @@
 #include "../bscript/impstr.h"
 #include "../clib/cfgelem.h"
 #include "../clib/cfgfile.h"
+#include "../clib/cfgsnapshot.h"
 #include "../clib/clib.h"
 #include "../clib/logfacility.h"
 #include "../clib/rawtypes.h"
 #include "../clib/streamsaver.h"
+#include "../clib/timer.h"
 #include "../plib/poltype.h"
 #include "../plib/systemstate.h"
 #include "containr.h"
@@ -206,6 +207,17 @@ void Storage::on_delete_realm( Realms::Realm* realm )
 }
 
 void Storage::read( Clib::ConfigFile& cf )
+{
+  read_elements( cf );
+}
+
+void Storage::read( Clib::ChunkedConfigReader& cf )
+{
+  read_elements( cf );
+}
+
+template <class Reader>
+void Storage::read_elements( Reader& cf )
 {
   static int num_until_dot = 1000;
   unsigned int nobjects = 0;
@@ -213,7 +225,7 @@ void Storage::read( Clib::ConfigFile& cf )
   StorageArea* area = nullptr;
   Clib::ConfigElem elem;
 
-  clock_t start = clock();
+  Tools::Timer<> timer;
 
   while ( cf.read( elem ) )
   {
@@ -254,10 +266,9 @@ void Storage::read( Clib::ConfigFile& cf )
     ++nobjects;
   }
 
-  clock_t end = clock();
-  int ms = static_cast<int>( ( end - start ) * 1000.0 / CLOCKS_PER_SEC );
+  timer.stop();
 
-  INFO_PRINT << " " << nobjects << " elements in " << ms << " ms.\n";
+  INFO_PRINT << " " << nobjects << " elements in " << timer.ellapsed() << " ms.\n";
 }
 
 void Storage::print( Clib::StreamWriter& sw ) const
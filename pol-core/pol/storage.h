@@ -24,6 +24,7 @@ class Realm;
 }
 namespace Clib
 {
+class ChunkedConfigReader;
 class ConfigFile;
 class ConfigElem;
 class StreamWriter;
@@ -67,10 +68,14 @@ public:
 
   void print( Clib::StreamWriter& sw ) const;
   void read( Clib::ConfigFile& cf );
+  void read( Clib::ChunkedConfigReader& cf );
   void clear();
   size_t estimateSize() const;
 
 private:
+  template <class Reader>
+  void read_elements( Reader& cf );
+
   // TODO: investigate if this could store objects. Does find()
   // return object copies, or references?
   typedef std::map<std::string, StorageArea*> AreaCont;
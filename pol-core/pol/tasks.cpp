@@ -190,6 +190,12 @@ void update_rpm( void )
   TICK_PROFILEVAR( container_adds );
   TICK_PROFILEVAR( container_removes );
 
+  TICK_PROFILEVAR( packet_batches );
+  TICK_PROFILEVAR( packet_batch_msgs );
+  TICK_PROFILEVAR( packet_batch_lock_us );
+  ROLL_PROFILEMAX( packet_batch_msgs );
+  ROLL_PROFILEMAX( packet_batch_lock_us );
+
 #ifdef _WIN32
   FILETIME d1, d2, k, u;
   GetProcessTimes( m_CurrentProcessHandle, &d1, &d2, &k, &u );
@@ -27,7 +27,7 @@ bool run_pol_tests()
 
 #ifdef ENABLE_BENCHMARK
   benchmark::RunSpecifiedBenchmarks();
-  return;
+  return true;
 #endif
   RUNTEST( test_splitnamevalue )
   RUNTEST( test_convertquotedstring )
@@ -49,6 +49,15 @@ bool run_pol_tests()
   RUNTEST( pos4d_test )
   RUNTEST( range2d_test )
   RUNTEST( range3d_test )
+  RUNTEST( zone_test )
+  RUNTEST( walk_cache_test )
+  RUNTEST( pathfind_test )
+  RUNTEST( huffman_test )
+  RUNTEST( holdlist_test )
+  RUNTEST( datastore_test )
+  RUNTEST( savejournal_test )
+  RUNTEST( cfgsnapshot_test )
+  RUNTEST( cfgcache_test )
 //  RUNTEST( dummy )
 
   UnitTest::display_test_results();
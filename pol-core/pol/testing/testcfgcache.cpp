@@ -0,0 +1,100 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "testenv.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <sys/stat.h>
+
+#include "../../bscript/bobject.h"
+#include "../../clib/fileutil.h"
+#include "../../clib/rawtypes.h"
+#include "../../plib/systemstate.h"
+#include "../cfgcache.h"
+#include "../cfgrepos.h"
+
+namespace Pol
+{
+namespace Testing
+{
+using namespace Core;
+
+namespace
+{
+// the images of the tests live in a directory of their own
+class CacheDir
+{
+public:
+  CacheDir() : _cache_path( Plib::systemstate.config.config_cache_path )
+  {
+    Clib::MakeDirectory( "cfgcachetest" );
+    Plib::systemstate.config.config_cache_path = "cfgcachetest/";
+  }
+  ~CacheDir()
+  {
+    Clib::RemoveFile( CompiledConfig::image_filename( "cfgcachetest.cfg" ) );
+    Clib::RemoveFile( "cfgcachetest.cfg" );
+    Plib::systemstate.config.config_cache_path = _cache_path;
+  }
+
+private:
+  std::string _cache_path;
+};
+
+std::string file_bytes( const std::string& filename )
+{
+  std::ifstream ifs( filename, std::ios::binary );
+  return std::string( std::istreambuf_iterator<char>( ifs ), std::istreambuf_iterator<char>() );
+}
+
+void write_bytes( const std::string& filename, const std::string& bytes )
+{
+  std::ofstream ofs( filename, std::ios::binary | std::ios::trunc );
+  ofs.write( bytes.data(), static_cast<std::streamsize>( bytes.size() ) );
+}
+
+// Value of element "test", loaded the way ReadConfigFile does
+std::string loaded_value()
+{
+  ref_ptr<StoredConfigFile> file( new StoredConfigFile() );
+  file->load_file( "cfgcachetest.cfg" );
+  auto elem = file->findelem( "test" );
+  if ( elem.get() == nullptr )
+    return "";
+  Bscript::BObjectImp* imp = elem->getimp( "Value" );
+  return imp != nullptr ? imp->getStringRep() : "";
+}
+}  // namespace
+
+void cfgcache_test()
+{
+  UnitTest(
+      []()
+      {
+        CacheDir dir;
+        write_bytes( "cfgcachetest.cfg", "Elem test\n{\n\tValue\tfirst\n}\n" );
+        bool ok = loaded_value() == "first" &&
+                  Clib::FileExists( CompiledConfig::image_filename( "cfgcachetest.cfg" ) ) &&
+                  loaded_value() == "first";
+
+        // same size, and the image claims the mtime of the new content
+        write_bytes( "cfgcachetest.cfg", "Elem test\n{\n\tValue\tsecnd\n}\n" );
+        struct stat source_stat;
+        stat( "cfgcachetest.cfg", &source_stat );
+        const std::string image = CompiledConfig::image_filename( "cfgcachetest.cfg" );
+        std::string bytes = file_bytes( image );
+        // header: magic, version, element count, u64 source mtime
+        u64 mtime = static_cast<u64>( source_stat.st_mtime );
+        bytes.replace( 16, sizeof mtime, reinterpret_cast<const char*>( &mtime ), sizeof mtime );
+        write_bytes( image, bytes );
+        return ok && loaded_value() == "secnd";
+      },
+      true, "changed content with same mtime and size" );
+}
+}  // namespace Testing
+}  // namespace Pol
@@ -0,0 +1,168 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "testenv.h"
+
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "../../clib/cfgelem.h"
+#include "../../clib/cfgfile.h"
+#include "../../clib/cfgsnapshot.h"
+#include "../../clib/fileutil.h"
+#include "../../clib/rawtypes.h"
+
+namespace Pol
+{
+namespace Testing
+{
+namespace
+{
+std::string file_bytes( const std::string& filename )
+{
+  std::ifstream ifs( filename, std::ios::binary );
+  return std::string( std::istreambuf_iterator<char>( ifs ), std::istreambuf_iterator<char>() );
+}
+
+void write_bytes( const std::string& filename, const std::string& bytes )
+{
+  std::ofstream ofs( filename, std::ios::binary | std::ios::trunc );
+  ofs.write( bytes.data(), static_cast<std::streamsize>( bytes.size() ) );
+}
+
+void set_u32( std::string& bytes, size_t pos, u32 value )
+{
+  for ( size_t i = 0; i < 4; ++i )
+    bytes[pos + i] = static_cast<char>( ( value >> ( 8 * i ) ) & 0xFF );
+}
+
+u32 get_u32( const std::string& bytes, size_t pos )
+{
+  u32 value = 0;
+  for ( size_t i = 0; i < 4; ++i )
+    value |= static_cast<u32>( static_cast<unsigned char>( bytes[pos + i] ) ) << ( 8 * i );
+  return value;
+}
+
+// the multi-line value of the test text, quoted as snapshot2text writes it
+const char* const MULTILINE_VALUE = "first line\nsecond \"quoted\" \\ line";
+
+// text in the format snapshot2text writes, so the round trip has to give the same bytes
+std::string snapshot_text( unsigned int items )
+{
+  std::string text =
+      "Empty\n{\n}\n\n"
+      "Global\n{\n"
+      "\tDesc\t\"first line\\nsecond \\\"quoted\\\" \\\\ line\"\n"
+      "\tPadded\t\" leading space\"\n"
+      "\tEmptyValue\t\n"
+      "\tCProp\tsimple i17\n"
+      "\tCProp\tspecial S{\"a\": [1, 2]}\\ \t=# // ü\n"
+      "\tCProp\t\"multi a\\nb\"\n"
+      "\tCProp\tnovalue\n"
+      "}\n\n";
+  // a single element bigger than a chunk
+  text += "Large\n{\n\tValue\t" + std::string( 1536 * 1024, 'x' ) + "\n}\n\n";
+  // several chunks by element count
+  for ( unsigned int i = 0; i < items; ++i )
+  {
+    text += "Item 0x" + std::to_string( 0x40000000 + i ) + "\n{\n\tObjType\t0x" +
+            std::to_string( i % 100 ) + "\n\tCProp\tindex i" + std::to_string( i ) + "\n}\n\n";
+  }
+  return text;
+}
+
+// all elements of the snapshot read with ChunkedConfigReader match the text read by ConfigFile
+bool same_elements( const std::string& textfile, const std::string& snapshotfile,
+                    size_t& chunks )
+{
+  Clib::ConfigFile cf( textfile );
+  Clib::SnapshotReader reader( snapshotfile );
+  chunks = reader.chunk_count();
+  Clib::ConfigElem text_elem, snap_elem;
+  size_t count = 0;
+  while ( cf.read( text_elem ) )
+  {
+    if ( !reader.read( snap_elem ) || text_elem.type_is( snap_elem.type() ) == false ||
+         std::string( text_elem.rest() ) != snap_elem.rest() )
+      return false;
+    if ( text_elem.type_is( "Global" ) &&
+         snap_elem.remove_string( "Desc" ) != std::string( MULTILINE_VALUE ) )
+      return false;
+    ++count;
+  }
+  return !reader.read( snap_elem ) && count > 0;
+}
+
+bool rejected( const std::string& filename, const std::string& bytes )
+{
+  write_bytes( filename, bytes );
+  try
+  {
+    Clib::SnapshotReader reader( filename );
+    return false;
+  }
+  catch ( std::exception& )
+  {
+    return true;
+  }
+}
+}  // namespace
+
+void cfgsnapshot_test()
+{
+  UnitTest(
+      []()
+      {
+        std::string text = snapshot_text( 10000 );
+        write_bytes( "snaptest.txt", text );
+        size_t count = Clib::convert_text_to_snapshot( "snaptest.txt", "snaptest.bin" );
+        bool ok = count == 10003 &&
+                  Clib::convert_snapshot_to_text( "snaptest.bin", "snaptest2.txt" ) == count &&
+                  file_bytes( "snaptest2.txt" ) == text;
+        size_t chunks = 0;
+        ok = ok && same_elements( "snaptest.txt", "snaptest.bin", chunks ) && chunks >= 4;
+        Clib::RemoveFile( "snaptest.txt" );
+        Clib::RemoveFile( "snaptest.bin" );
+        Clib::RemoveFile( "snaptest2.txt" );
+        return ok;
+      },
+      true, "text snapshot round trip" );
+  UnitTest(
+      []()
+      {
+        write_bytes( "snaptest.txt", snapshot_text( 3 ) );
+        Clib::convert_text_to_snapshot( "snaptest.txt", "snaptest.bin" );
+        const std::string bytes = file_bytes( "snaptest.bin" );
+        // header: magic, version, reserved, u64 index offset; the index ends with the chunks
+        const u32 index_offset = get_u32( bytes, 16 );
+        bool ok = !rejected( "snaptest.bin", bytes );
+
+        ok = ok && rejected( "snaptest.bin", bytes.substr( 0, bytes.size() - 6 ) );
+        ok = ok && rejected( "snaptest.bin", bytes.substr( 0, index_offset + 2 ) );
+
+        std::string corrupt = bytes;
+        set_u32( corrupt, 16, static_cast<u32>( bytes.size() + 1 ) );
+        ok = ok && rejected( "snaptest.bin", corrupt );
+
+        corrupt = bytes;
+        set_u32( corrupt, corrupt.size() - 12, index_offset );
+        ok = ok && rejected( "snaptest.bin", corrupt );
+
+        corrupt = bytes;
+        set_u32( corrupt, index_offset, 0x7FFFFFFF );  // string count
+        ok = ok && rejected( "snaptest.bin", corrupt );
+
+        Clib::RemoveFile( "snaptest.txt" );
+        Clib::RemoveFile( "snaptest.bin" );
+        return ok;
+      },
+      true, "corrupt index rejected" );
+}
+}  // namespace Testing
+}  // namespace Pol
@@ -0,0 +1,104 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "testenv.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#include "../../bscript/bobject.h"
+#include "../../bscript/dict.h"
+#include "../../bscript/impstr.h"
+#include "../../clib/fileutil.h"
+#include "../../plib/systemstate.h"
+#include "../module/datastore.h"
+#include "../module/datastoreimp.h"
+
+namespace Pol
+{
+namespace Testing
+{
+using namespace Module;
+
+namespace
+{
+void set_value( DataStoreFile& dsf, int value )
+{
+  Bscript::BDictionary values;
+  values.addMember( new Bscript::String( "entry" ), new Bscript::BLong( value ) );
+  delete dsf.dfcontents->methodSetProps( "value", values );
+}
+
+std::string file_text( const std::string& filename )
+{
+  std::ifstream ifs( filename );
+  return std::string( std::istreambuf_iterator<char>( ifs ), std::istreambuf_iterator<char>() );
+}
+
+// one worldsave of the file, false if the snapshot could not be written
+bool save( DataStoreFile& dsf )
+{
+  auto snapshot = dsf.take_snapshot();
+  dsf.commit();
+  return !snapshot || snapshot->write();
+}
+}  // namespace
+
+void datastore_test()
+{
+  UnitTest(
+      []()
+      {
+        Clib::MakeDirectory( ( Plib::systemstate.config.world_data_path + "ds" ).c_str() );
+        DataStoreFile dsf( "::unittest_failed_write", nullptr, "unittest_failed_write", 0 );
+        dsf.dfcontents.set( new DataFileContents( &dsf ) );
+        set_value( dsf, 1 );
+        bool ok = save( dsf );
+        const std::string good = dsf.filename();
+
+        // a directory in place of the temporary file lets the write of the next version fail
+        set_value( dsf, 2 );
+        const std::string blocker = dsf.filename( dsf.version + 1 ) + ".tmp";
+        Clib::MakeDirectory( blocker.c_str() );
+        ok = ok && !save( dsf );
+        std::remove( blocker.c_str() );
+        // the failed version is not the current one, and the last good one is kept
+        ok = ok && Clib::FileExists( good );
+
+        // the next save writes the contents again, without another change
+        ok = ok && save( dsf ) && Clib::FileExists( good ) &&
+             file_text( dsf.filename() ).find( "value i2" ) != std::string::npos;
+        for ( unsigned ver = 0; ver < 10; ++ver )
+          Clib::RemoveFile( dsf.filename( ver ) );
+        return ok;
+      },
+      true, "failed write is repeated" );
+  UnitTest(
+      []()
+      {
+        DataStoreFile dsf( "::unittest_copy_on_write", nullptr, "unittest_copy_on_write", 0 );
+        dsf.dfcontents.set( new DataFileContents( &dsf ) );
+        set_value( dsf, 1 );
+        auto snapshot = dsf.take_snapshot();
+        dsf.commit();
+        // changed after the snapshot, before it got written
+        set_value( dsf, 2 );
+        bool ok = snapshot->write() &&
+                  file_text( dsf.filename() ).find( "value i1" ) != std::string::npos &&
+                  dsf.dfcontents->dirty;
+        ok = ok && save( dsf ) &&
+             file_text( dsf.filename() ).find( "value i2" ) != std::string::npos;
+        for ( unsigned ver = 0; ver < 10; ++ver )
+          Clib::RemoveFile( dsf.filename( ver ) );
+        return ok;
+      },
+      true, "snapshot keeps the saved state" );
+}
+}  // namespace Testing
+}  // namespace Pol
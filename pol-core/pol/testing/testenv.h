@@ -99,6 +99,16 @@ void pos3d_test();
 void pos4d_test();
 void range2d_test();
 void range3d_test();
+
+void zone_test();
+void walk_cache_test();
+void pathfind_test();
+void huffman_test();
+void holdlist_test();
+void datastore_test();
+void savejournal_test();
+void cfgsnapshot_test();
+void cfgcache_test();
 }  // namespace Testing
 }  // namespace Pol
 #endif
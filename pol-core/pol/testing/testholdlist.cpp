@@ -0,0 +1,217 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "testenv.h"
+
+#include "pol_global_config.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+#ifdef ENABLE_BENCHMARK
+#include <benchmark/benchmark.h>
+#endif
+
+#include "../holdlist.h"
+
+namespace Pol
+{
+namespace Testing
+{
+using namespace Core;
+
+namespace
+{
+// removes every due link, returns false if one was not due yet
+bool pop_expired( HoldList& holdlist, polclock_t now, std::vector<HoldListLink*>& popped )
+{
+  while ( HoldListLink* link = holdlist.front_expired( now ) )
+  {
+    if ( link->until > now )
+      return false;
+    holdlist.erase( *link );
+    popped.push_back( link );
+  }
+  return true;
+}
+
+// runs random sleeps and cancels against a multimap, returns the step of the first difference
+int compare_with_multimap( unsigned seed, polclock_t max_delay )
+{
+  std::mt19937 gen( seed );
+  std::uniform_int_distribution<polclock_t> delay( 0, max_delay );
+  std::uniform_int_distribution<polclock_t> step( 0, 300 );
+  std::uniform_int_distribution<int> action( 0, 9 );
+
+  const size_t count = 500;
+  std::vector<std::unique_ptr<HoldListLink>> links;
+  for ( size_t i = 0; i < count; ++i )
+    links.emplace_back( new HoldListLink );
+  HoldList holdlist;
+  std::multimap<polclock_t, HoldListLink*> reference;
+  polclock_t now = 1000;
+  for ( int i = 0; i < 20000; ++i )
+  {
+    HoldListLink* link = links[gen() % count].get();
+    if ( !link->linked() )
+    {
+      const polclock_t until = now + delay( gen ) - 5;  // some are already due
+      holdlist.insert( *link, nullptr, until );
+      reference.emplace( until, link );
+    }
+    else if ( action( gen ) == 0 )
+    {
+      holdlist.erase( *link );
+      for ( auto itr = reference.lower_bound( link->until ); itr != reference.end(); ++itr )
+      {
+        if ( itr->second == link )
+        {
+          reference.erase( itr );
+          break;
+        }
+      }
+    }
+    if ( action( gen ) < 3 )
+      continue;
+
+    now += step( gen );
+    std::vector<HoldListLink*> popped;
+    if ( !pop_expired( holdlist, now, popped ) )
+      return i;
+    std::vector<HoldListLink*> expected;
+    while ( !reference.empty() && reference.begin()->first <= now )
+    {
+      expected.push_back( reference.begin()->second );
+      reference.erase( reference.begin() );
+    }
+    std::sort( popped.begin(), popped.end() );
+    std::sort( expected.begin(), expected.end() );
+    if ( popped != expected || holdlist.size() != reference.size() )
+      return i;
+    // the scripts thread may wake up too early but never too late
+    const polclock_t left = holdlist.clocks_left( now, 6000 );
+    if ( left <= 0 || ( !reference.empty() && reference.begin()->first < now + left ) )
+      return i;
+  }
+  return -1;
+}
+}  // namespace
+
+void holdlist_test()
+{
+  UnitTest(
+      []()
+      {
+        HoldList holdlist;
+        HoldListLink link;
+        holdlist.insert( link, nullptr, 10 );
+        return holdlist.front_expired( 9 ) == nullptr && holdlist.front_expired( 10 ) == &link;
+      },
+      true, "due on time" );
+  UnitTest(
+      []()
+      {
+        HoldList holdlist;
+        HoldListLink first, second, third;
+        holdlist.insert( first, nullptr, 300 );
+        holdlist.insert( second, nullptr, 20000 );
+        holdlist.insert( third, nullptr, 20000 );
+        holdlist.erase( second );
+        std::vector<HoldListLink*> popped;
+        pop_expired( holdlist, 30000, popped );
+        return popped == std::vector<HoldListLink*>{ &first, &third } && holdlist.empty();
+      },
+      true, "cascaded and erased" );
+  UnitTest(
+      []()
+      {
+        HoldList holdlist;
+        HoldListLink link;
+        const polclock_t until = polclock_t( 1 ) << 40;  // beyond the last level
+        holdlist.insert( link, nullptr, until );
+        return holdlist.front_expired( until / 2 ) == nullptr &&
+               holdlist.front_expired( until ) == &link;
+      },
+      true, "beyond the wheel" );
+  UnitTest(
+      []()
+      {
+        HoldList holdlist;
+        HoldListLink link;
+        holdlist.front_expired( 1000 );
+        holdlist.insert( link, nullptr, 1010 );
+        return holdlist.clocks_left( 1000, 6000 );
+      },
+      polclock_t( 10 ), "clocks left" );
+  UnitTest( []() { return compare_with_multimap( 4711, 200 ); }, -1, "short sleeps" );
+  UnitTest( []() { return compare_with_multimap( 4712, 100000 ); }, -1, "long sleeps" );
+}
+
+#ifdef ENABLE_BENCHMARK
+// sleep and wake up of many scripts with short delays
+template <typename Schedule>
+static void run_sleeps( benchmark::State& state, Schedule schedule )
+{
+  std::mt19937 gen( 4711 );
+  std::uniform_int_distribution<polclock_t> delay( 1, 100 );
+  const size_t count = static_cast<size_t>( state.range( 0 ) );
+  polclock_t now = 0;
+  std::vector<polclock_t> delays( 1024 );
+  for ( auto& d : delays )
+    d = delay( gen );
+  while ( state.KeepRunning() )
+    schedule( count, delays, ++now );
+}
+
+static void BM_holdlist_wheel( benchmark::State& state )
+{
+  HoldList holdlist;
+  std::vector<HoldListLink> links( static_cast<size_t>( state.range( 0 ) ) );
+  size_t next_delay = 0;
+  run_sleeps( state,
+              [&]( size_t count, const std::vector<polclock_t>& delays, polclock_t now )
+              {
+                if ( holdlist.empty() )
+                {
+                  for ( size_t i = 0; i < count; ++i )
+                    holdlist.insert( links[i], nullptr, now + delays[i % delays.size()] );
+                }
+                while ( HoldListLink* link = holdlist.front_expired( now ) )
+                {
+                  holdlist.erase( *link );
+                  holdlist.insert( *link, nullptr,
+                                   now + delays[++next_delay % delays.size()] );
+                }
+              } );
+}
+BENCHMARK( BM_holdlist_wheel )->Arg( 1000 )->Arg( 40000 );
+
+static void BM_holdlist_multimap( benchmark::State& state )
+{
+  std::multimap<polclock_t, size_t> holdlist;
+  size_t next_delay = 0;
+  run_sleeps( state,
+              [&]( size_t count, const std::vector<polclock_t>& delays, polclock_t now )
+              {
+                if ( holdlist.empty() )
+                {
+                  for ( size_t i = 0; i < count; ++i )
+                    holdlist.emplace( now + delays[i % delays.size()], i );
+                }
+                while ( holdlist.begin()->first <= now )
+                {
+                  size_t i = holdlist.begin()->second;
+                  holdlist.erase( holdlist.begin() );
+                  holdlist.emplace( now + delays[++next_delay % delays.size()], i );
+                }
+              } );
+}
+BENCHMARK( BM_holdlist_multimap )->Arg( 1000 )->Arg( 40000 );
+#endif
+}  // namespace Testing
+}  // namespace Pol
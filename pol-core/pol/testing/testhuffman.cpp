@@ -0,0 +1,144 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "testenv.h"
+
+#include "pol_global_config.h"
+
+#include <random>
+#include <vector>
+#ifdef ENABLE_BENCHMARK
+#include <benchmark/benchmark.h>
+#endif
+
+#include "../ctable.h"
+
+namespace Pol
+{
+namespace Testing
+{
+namespace
+{
+// the former bit by bit encoder of ThreadedClient::transmit_encrypted
+std::vector<unsigned char> huffman_compress_bitwise( const std::vector<unsigned char>& data )
+{
+  std::vector<unsigned char> out( data.size() * 2 + 4 );
+  unsigned char* pch = out.data();
+  int bidx = 0;
+  for ( size_t i = 0; i <= data.size(); i++ )
+  {
+    const Core::SVR_KEYDESC& code = Core::keydesc[i < data.size() ? data[i] : 0x100];
+    int nbits = code.nbits;
+    unsigned short inval = code.bits_reversed;
+    while ( nbits-- )
+    {
+      *pch <<= 1;
+      if ( inval & 1 )
+        *pch |= 1;
+      bidx++;
+      if ( bidx == 8 )
+      {
+        pch++;
+        bidx = 0;
+      }
+      inval >>= 1;
+    }
+  }
+  if ( bidx == 0 )
+    pch--;
+  else
+    *pch <<= ( 8 - bidx );
+  out.resize( pch - out.data() + 1 );
+  return out;
+}
+
+std::vector<unsigned char> huffman_compress( const std::vector<unsigned char>& data )
+{
+  std::vector<unsigned char> out( data.size() * 2 + 4 );
+  out.resize( Core::huffman_compress( data.data(), data.size(), out.data(), out.size() ) );
+  return out;
+}
+
+std::vector<unsigned char> random_data( std::mt19937& gen, size_t len )
+{
+  std::uniform_int_distribution<int> dist( 0, 0xFF );
+  std::vector<unsigned char> data( len );
+  for ( auto& c : data )
+    c = static_cast<unsigned char>( dist( gen ) );
+  return data;
+}
+}  // namespace
+
+void huffman_test()
+{
+  UnitTest( []() { return huffman_compress( {} ) == huffman_compress_bitwise( {} ); }, true,
+            "empty" );
+  UnitTest(
+      []()
+      {
+        for ( int c = 0; c <= 0xFF; ++c )
+        {
+          std::vector<unsigned char> data( 1, static_cast<unsigned char>( c ) );
+          if ( huffman_compress( data ) != huffman_compress_bitwise( data ) )
+            return c;
+        }
+        return -1;
+      },
+      -1, "single bytes" );
+  UnitTest(
+      []()
+      {
+        std::mt19937 gen( 4711 );
+        std::uniform_int_distribution<size_t> len( 0, 2048 );
+        for ( int i = 0; i < 2000; ++i )
+        {
+          auto data = random_data( gen, len( gen ) );
+          if ( huffman_compress( data ) != huffman_compress_bitwise( data ) )
+            return i;
+        }
+        return -1;
+      },
+      -1, "random packets" );
+  // pause/restart in client.cpp send these pre-encrypted
+  UnitTest(
+      []()
+      {
+        return huffman_compress( { 0x33, 0x01 } ) == std::vector<unsigned char>{ 0x4f, 0xfa };
+      },
+      true, "pause" );
+  UnitTest(
+      []()
+      {
+        return huffman_compress( { 0x33, 0x00 } ) == std::vector<unsigned char>{ 0x4c, 0xd0 };
+      },
+      true, "restart" );
+}
+
+#ifdef ENABLE_BENCHMARK
+static void BM_huffman_compress( benchmark::State& state )
+{
+  std::mt19937 gen( 4711 );
+  auto data = random_data( gen, static_cast<size_t>( state.range( 0 ) ) );
+  std::vector<unsigned char> out( data.size() * 2 + 4 );
+  while ( state.KeepRunning() )
+    benchmark::DoNotOptimize(
+        Core::huffman_compress( data.data(), data.size(), out.data(), out.size() ) );
+  state.SetBytesProcessed( state.iterations() * state.range( 0 ) );
+}
+BENCHMARK( BM_huffman_compress )->Arg( 16 )->Arg( 256 )->Arg( 4096 );
+
+static void BM_huffman_compress_bitwise( benchmark::State& state )
+{
+  std::mt19937 gen( 4711 );
+  auto data = random_data( gen, static_cast<size_t>( state.range( 0 ) ) );
+  while ( state.KeepRunning() )
+    benchmark::DoNotOptimize( huffman_compress_bitwise( data ) );
+  state.SetBytesProcessed( state.iterations() * state.range( 0 ) );
+}
+BENCHMARK( BM_huffman_compress_bitwise )->Arg( 16 )->Arg( 256 )->Arg( 4096 );
+#endif
+}  // namespace Testing
+}  // namespace Pol
@@ -164,6 +164,28 @@ void packet_test()
     std::array<s8, 10> a{ { 0x2f, 0x31, 0x32, 0x33, 0x34, 0x12, 0x34, 0x43, 0x21, 0 } };
     test( p, a );
   }
+  {
+    PacketOut<PktOut_2F> p;  // size 10
+    p->Write<u32>( 0x12344321u );
+    auto full = p.GetShared( 5 );
+    auto part = p.GetShared( 3 );
+    // alternating lengths reuse their copies
+    bool ok = full->size() == 5 && part->size() == 3 && p.GetShared( 5 ) == full &&
+              p.GetShared( 3 ) == part && p.GetShared() == full;
+    // a write after sending needs a new copy, the queued one keeps its content
+    p->offset = 1;
+    p->Write<u8>( 0x99u );
+    auto changed = p.GetShared( 5 );
+    ok = ok && changed != full && ( *changed )[1] == 0x99 && ( *full )[1] == 0x21 &&
+         p.GetShared( 3 ) != part;
+    if ( ok )
+      UnitTest::inc_successes();
+    else
+    {
+      UnitTest::inc_failures();
+      INFO_PRINT << "shared packet buffer not renewed after a write\n";
+    }
+  }
 }
 
 void test_splitnamevalue( const std::string& istr, const std::string& exp_pn,
@@ -0,0 +1,125 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "testenv.h"
+
+#include "pol_global_config.h"
+
+#include <algorithm>
+#include <vector>
+#ifdef ENABLE_BENCHMARK
+#include <benchmark/benchmark.h>
+#endif
+
+#include "../../clib/rawtypes.h"
+#include "../base/position.h"
+#include "../globals/settings.h"
+#include "../globals/uvars.h"
+#include "../item/item.h"
+#include "../ufunc.h"
+#include "../uopathnode.h"
+
+namespace Pol
+{
+namespace Testing
+{
+using namespace Core;
+
+namespace
+{
+const unsigned int SUCCEEDED = UOSearch::SEARCH_STATE_SUCCEEDED;
+const unsigned int FAILED = UOSearch::SEARCH_STATE_FAILED;
+const unsigned int OUT_OF_MEMORY = UOSearch::SEARCH_STATE_OUT_OF_MEMORY;
+
+unsigned int path_between( const Pos3d& start, const Pos3d& end, std::vector<Pos3d>& path,
+                           AStarBlockers* blockers = nullptr )
+{
+  AStarBlockers area( std::min( start.x(), end.x() ) - 5, std::max( start.x(), end.x() ) + 5,
+                      std::min( start.y(), end.y() ) - 5, std::max( start.y(), end.y() ) + 5 );
+  if ( blockers == nullptr )
+    blockers = &area;
+  return find_path( gamestate.main_realm, start, end, *blockers, true, path );
+}
+
+bool path_touches( const std::vector<Pos3d>& path, u16 x, u16 y )
+{
+  for ( const auto& step : path )
+  {
+    if ( step.x() == x && step.y() == y )
+      return true;
+  }
+  return false;
+}
+}  // namespace
+
+void pathfind_test()
+{
+  std::vector<Pos3d> path;
+  UnitTest( [&]() { return path_between( Pos3d( 40, 40, 0 ), Pos3d( 45, 40, 0 ), path ); },
+            SUCCEEDED, "straight path" );
+  UnitTest( [&]() { return path.size(); }, 5u, "straight path steps" );
+  UnitTest( [&]() { return path.back() == Pos3d( 45, 40, 0 ); }, true, "straight path end" );
+
+  // a wall in the way, the pooled nodes have to be reusable
+  std::vector<Items::Item*> wall;
+  for ( u16 y = 38; y <= 42; ++y )
+    wall.push_back( add_item( 0x6, 43, y, 0 ) );
+  for ( int i = 0; i < 3; ++i )
+  {
+    UnitTest( [&]() { return path_between( Pos3d( 40, 40, 0 ), Pos3d( 45, 40, 0 ), path ); },
+              SUCCEEDED, "path around the wall" );
+    UnitTest( [&]() { return path_touches( path, 43, 40 ); }, false, "wall avoided" );
+    UnitTest( [&]() { return path.size() > 5; }, true, "detour steps" );
+  }
+  UnitTest( [&]() { return path.back() == Pos3d( 45, 40, 0 ); }, true, "detour end" );
+
+  // closed wall inside of the searched area
+  AStarBlockers area( 38, 47, 38, 42 );
+  UnitTest(
+      [&]() { return path_between( Pos3d( 40, 40, 0 ), Pos3d( 45, 40, 0 ), path, &area ); },
+      FAILED, "wall closes the area" );
+  for ( auto& item : wall )
+    destroy_item( item );
+
+  // mobiles in the way
+  AStarBlockers blockers( 38, 47, 38, 42 );
+  for ( short y = 38; y <= 42; ++y )
+    blockers.AddBlocker( 43, y, 0 );
+  UnitTest(
+      [&]() { return path_between( Pos3d( 40, 40, 0 ), Pos3d( 45, 40, 0 ), path, &blockers ); },
+      FAILED, "blockers close the area" );
+
+  // node budget
+  auto& max_nodes = settingsManager.ssopt.max_pathfind_nodes;
+  const auto orig_max_nodes = max_nodes;
+  max_nodes = 20;
+  UnitTest( [&]() { return path_between( Pos3d( 40, 40, 0 ), Pos3d( 80, 80, 0 ), path ); },
+            OUT_OF_MEMORY, "node budget exceeded" );
+  max_nodes = orig_max_nodes;
+  UnitTest( [&]() { return path_between( Pos3d( 40, 40, 0 ), Pos3d( 80, 80, 0 ), path ); },
+            SUCCEEDED, "node budget restored" );
+  UnitTest( [&]() { return path.size(); }, 40u, "diagonal path steps" );
+}
+
+#ifdef ENABLE_BENCHMARK
+static void BM_find_path( benchmark::State& state )
+{
+  const u16 dist = static_cast<u16>( state.range( 0 ) );
+  // a wall across the direct way
+  std::vector<Items::Item*> wall;
+  for ( u16 y = 58; y <= 62; ++y )
+    wall.push_back( add_item( 0x6, 60 + dist / 2, y, 0 ) );
+  std::vector<Pos3d> path;
+  while ( state.KeepRunning() )
+    path_between( Pos3d( 60, 60, 0 ), Pos3d( 60 + dist, 60, 0 ), path );
+  benchmark::DoNotOptimize( path );
+  for ( auto& item : wall )
+    destroy_item( item );
+}
+BENCHMARK( BM_find_path )->Arg( 10 )->Arg( 25 )->Arg( 50 );
+#endif
+}  // namespace Testing
+}  // namespace Pol
@@ -0,0 +1,187 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "testenv.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+#include "../../clib/fileutil.h"
+#include "../../clib/rawtypes.h"
+#include "../../plib/systemstate.h"
+#include "../savejournal.h"
+
+namespace Pol
+{
+namespace Testing
+{
+using Core::SaveJournal;
+
+namespace
+{
+// the journal of the tests lives in a directory of its own, synced on each append
+class JournalDir
+{
+public:
+  JournalDir()
+      : _world_data_path( Plib::systemstate.config.world_data_path ),
+        _sync_interval( Plib::systemstate.config.journal_sync_interval )
+  {
+    Clib::MakeDirectory( "journaltest" );
+    Plib::systemstate.config.world_data_path = "journaltest/";
+    Plib::systemstate.config.journal_sync_interval = 0;
+    Clib::RemoveFile( SaveJournal::filename() );
+  }
+  ~JournalDir()
+  {
+    Clib::RemoveFile( SaveJournal::filename() );
+    Plib::systemstate.config.world_data_path = _world_data_path;
+    Plib::systemstate.config.journal_sync_interval = _sync_interval;
+  }
+
+private:
+  std::string _world_data_path;
+  unsigned int _sync_interval;
+};
+
+std::string file_bytes( const std::string& filename )
+{
+  std::ifstream ifs( filename, std::ios::binary );
+  return std::string( std::istreambuf_iterator<char>( ifs ), std::istreambuf_iterator<char>() );
+}
+
+void write_bytes( const std::string& filename, const std::string& bytes )
+{
+  std::ofstream ofs( filename, std::ios::binary | std::ios::trunc );
+  ofs.write( bytes.data(), static_cast<std::streamsize>( bytes.size() ) );
+}
+
+void set_u32( std::string& bytes, size_t pos, u32 value )
+{
+  for ( size_t i = 0; i < 4; ++i )
+    bytes[pos + i] = static_cast<char>( ( value >> ( 8 * i ) ) & 0xFF );
+}
+
+std::string record_text( u32 sequence )
+{
+  return "Item\n{\n\tSerial 0x" + std::to_string( sequence ) + "\n}\n";
+}
+
+// appends count records, record i modifies 100+i and 200+i and deletes 300+i
+void write_records( u32 count )
+{
+  SaveJournal journal;
+  for ( u32 i = 1; i <= count; ++i )
+    journal.append( {100 + i, 200 + i}, {300 + i}, record_text( i ) );
+}
+
+bool record_ok( const SaveJournal::Record& rec, u32 sequence, const std::string& bytes )
+{
+  return rec.sequence == sequence &&
+         rec.modified == std::vector<u32>( {100 + sequence, 200 + sequence} ) &&
+         rec.deleted == std::vector<u32>( {300 + sequence} ) &&
+         bytes.substr( rec.data_offset, rec.data_size ) == record_text( sequence );
+}
+
+size_t record_end( const SaveJournal::Record& rec )
+{
+  return rec.data_offset + rec.data_size;
+}
+
+// offsets of the records of an intact journal, recover() doesn't change it
+std::vector<SaveJournal::Record> intact_records( u32 count )
+{
+  write_records( count );
+  SaveJournal journal;
+  return journal.recover();
+}
+
+// recovers the journal after it got damaged, true if only the first count records remain and
+// the file ends after them
+bool recovers( u32 count, size_t end )
+{
+  SaveJournal journal;
+  const auto& records = journal.recover();
+  std::string bytes = file_bytes( SaveJournal::filename() );
+  if ( records.size() != count || bytes.size() != end || journal.size() != end )
+    return false;
+  for ( u32 i = 0; i < count; ++i )
+  {
+    if ( !record_ok( records[i], i + 1, bytes ) )
+      return false;
+  }
+  return true;
+}
+}  // namespace
+
+void savejournal_test()
+{
+  UnitTest(
+      []()
+      {
+        JournalDir dir;
+        write_records( 3 );
+        bool ok;
+        {
+          SaveJournal journal;
+          const auto& records = journal.recover();
+          std::string bytes = file_bytes( SaveJournal::filename() );
+          ok = records.size() == 3 && journal.record_count() == 3;
+          for ( u32 i = 0; ok && i < 3; ++i )
+            ok = record_ok( records[i], i + 1, bytes );
+          // appending goes on after the recovered records
+          journal.append( {104, 204}, {304}, record_text( 4 ) );
+        }
+        return ok && recovers( 4, file_bytes( SaveJournal::filename() ).size() );
+      },
+      true, "records replayed" );
+  UnitTest(
+      []()
+      {
+        JournalDir dir;
+        auto records = intact_records( 3 );
+        std::string bytes = file_bytes( SaveJournal::filename() );
+        write_bytes( SaveJournal::filename(), bytes.substr( 0, bytes.size() - 5 ) );
+        return recovers( 2, record_end( records[1] ) );
+      },
+      true, "torn tail cut off" );
+  UnitTest(
+      []()
+      {
+        JournalDir dir;
+        auto records = intact_records( 3 );
+        std::string bytes = file_bytes( SaveJournal::filename() );
+        bytes[records[1].data_offset] ^= 0x20;
+        write_bytes( SaveJournal::filename(), bytes );
+        // the following records are cut off as well
+        return recovers( 1, record_end( records[0] ) );
+      },
+      true, "crc mismatch" );
+  UnitTest(
+      []()
+      {
+        JournalDir dir;
+        auto records = intact_records( 3 );
+        std::string bytes = file_bytes( SaveJournal::filename() );
+        // the second record claims to be the third, with a matching crc
+        size_t header = record_end( records[0] );
+        size_t payload = header + 20;
+        set_u32( bytes, header + 4, 3 );
+        uLong crc = crc32( 0L, Z_NULL, 0 );
+        crc = crc32( crc, reinterpret_cast<const Bytef*>( bytes.data() + header + 4 ), 12 );
+        crc = crc32( crc, reinterpret_cast<const Bytef*>( bytes.data() + payload ),
+                     static_cast<uInt>( record_end( records[1] ) - payload ) );
+        set_u32( bytes, header + 16, static_cast<u32>( crc ) );
+        write_bytes( SaveJournal::filename(), bytes );
+        return recovers( 1, record_end( records[0] ) );
+      },
+      true, "sequence gap" );
+}
+}  // namespace Testing
+}  // namespace Pol
@@ -3,10 +3,16 @@
  * @par History
  */
 
+#include <vector>
+
 #include "../../clib/logfacility.h"
+#include "../../plib/systemstate.h"
 #include "../../plib/uconst.h"
+#include "../globals/network.h"
 #include "../globals/uvars.h"
+#include "../item/item.h"
 #include "../realms/realm.h"
+#include "../ufunc.h"
 #include "testenv.h"
 
 namespace Pol
@@ -317,5 +323,67 @@ void multiwalk_test()
   // try walking on a long boat, next to its plank
   test_walk( 1496, 1817, -2, 1495, 1817, true, -2 );
 }
+
+namespace
+{
+// walks onto every tile of the realm from a few heights with a few movemodes
+std::vector<int> walk_everywhere( Realms::Realm* realm )
+{
+  const short oldzs[] = { -5, 0, 10 };
+  const Plib::MOVEMODE movemodes[] = {
+      Plib::MOVEMODE_LAND, Plib::MOVEMODE_SEA,
+      static_cast<Plib::MOVEMODE>( Plib::MOVEMODE_LAND | Plib::MOVEMODE_FLY ) };
+  std::vector<int> results;
+  for ( const auto& pos : realm->area() )
+  {
+    for ( auto oldz : oldzs )
+    {
+      for ( auto movemode : movemodes )
+      {
+        short newz = 0;
+        short boost = 0;
+        UMulti* multi;
+        Item* itm;
+        bool res = realm->walkheight( pos, oldz, &newz, &multi, &itm, true, movemode, &boost );
+        results.push_back( res ? newz * 16 + boost : -10000 );
+      }
+    }
+  }
+  return results;
+}
+}  // namespace
+
+void walk_cache_test()
+{
+  auto& cache_size = Plib::systemstate.config.walk_cache_size;
+  const auto orig_cache_size = cache_size;
+  Realms::Realm* realm = gamestate.main_realm;
+
+  cache_size = 0;
+  std::vector<int> expected = walk_everywhere( realm );
+  cache_size = 1 << 20;
+  UnitTest( [&]() { return walk_everywhere( realm ) == expected; }, true, "computed results" );
+  u64 hits = networkManager.polstats.walk_cache_hits;
+  UnitTest( [&]() { return walk_everywhere( realm ) == expected; }, true, "cached results" );
+  UnitTest( [&]() { return networkManager.polstats.walk_cache_hits > hits; }, true,
+            "results were cached" );
+
+  // an item on the tile has to be seen, even if statics only result is cached
+  auto walk = [&]()
+  {
+    short newz;
+    UMulti* multi;
+    Item* itm;
+    return realm->walkheight( Pos2d( 50, 50 ), 0, &newz, &multi, &itm, true,
+                              Plib::MOVEMODE_LAND );
+  };
+  UnitTest( walk, true, "free tile" );
+  Item* wall = add_item( 0x6, 50, 50, 0 );
+  UnitTest( walk, false, "wall on the tile" );
+  destroy_item( wall );
+  UnitTest( walk, true, "wall removed" );
+
+  cache_size = orig_cache_size;
+}
 }  // namespace Testing
 }  // namespace Pol
@@ -0,0 +1,130 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "testenv.h"
+
+#include "pol_global_config.h"
+
+#ifdef ENABLE_BENCHMARK
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#endif
+
+#include "../../clib/rawtypes.h"
+#include "../base/position.h"
+#include "../globals/uvars.h"
+#include "../item/item.h"
+#include "../realms/realm.h"
+#include "../ufunc.h"
+#include "../uworld.h"
+
+namespace Pol
+{
+namespace Testing
+{
+using namespace Core;
+
+namespace
+{
+bool item_in_range( Items::Item* item, u16 x, u16 y, unsigned range )
+{
+  bool found = false;
+  WorldIterator<ItemFilter>::InRange( Pos2d( x, y ), gamestate.main_realm, range,
+                                      [&]( Items::Item* zoneitem )
+                                      {
+                                        if ( zoneitem == item )
+                                          found = true;
+                                      } );
+  return found;
+}
+}  // namespace
+
+void zone_test()
+{
+  Items::Item* item = add_item( 0x0eed, 10, 10, 0 );
+  UnitTest( [&]() { return item_in_range( item, 10, 10, 0 ); }, true, "added (10,10)" );
+  UnitTest( [&]() { return item_in_range( item, 12, 10, 1 ); }, false, "not in range (12,10)" );
+
+  // moves inside of the zone only update the packed position
+  item->setposition( Pos4d( item->pos() ).x( 20 ) );
+  UnitTest( [&]() { return item_in_range( item, 20, 10, 0 ); }, true, "zone move (20,10)" );
+  UnitTest( [&]() { return item_in_range( item, 10, 10, 0 ); }, false,
+            "zone move old pos (10,10)" );
+
+  move_item( item, Pos4d( item->pos() ).x( 100 ) );
+  UnitTest( [&]() { return item_in_range( item, 100, 10, 0 ); }, true, "world move (100,10)" );
+
+  // leaving the zone for a moment without moving in the world
+  item->setposition( Pos4d( item->pos() ).x( 10 ).y( 150 ) );
+  item->setposition( Pos4d( item->pos() ).x( 101 ).y( 10 ) );
+  UnitTest( [&]() { return item_in_range( item, 101, 10, 0 ); }, true,
+            "zone round trip (101,10)" );
+
+  destroy_item( item );
+
+  // the zone slots of the following objects move down when an object leaves the zone
+  Items::Item* first = add_item( 0x0eed, 10, 10, 0 );
+  Items::Item* second = add_item( 0x0eed, 11, 10, 0 );
+  Items::Item* third = add_item( 0x0eed, 12, 10, 0 );
+  destroy_item( first );
+  third->setposition( Pos4d( third->pos() ).x( 13 ) );
+  second->setposition( Pos4d( second->pos() ).x( 14 ) );
+  UnitTest( [&]() { return item_in_range( third, 13, 10, 0 ); }, true, "slot after erase (13,10)" );
+  UnitTest( [&]() { return item_in_range( second, 14, 10, 0 ); }, true,
+            "slot after erase (14,10)" );
+  destroy_item( second );
+  destroy_item( third );
+}
+
+#ifdef ENABLE_BENCHMARK
+namespace
+{
+// items uniformly placed in the 3x3 zones of the test realm
+std::vector<Items::Item*> add_zone_items( int count )
+{
+  std::mt19937 gen( 4711 );
+  std::uniform_int_distribution<int> dist( 0, 3 * 64 - 1 );
+  std::vector<Items::Item*> items;
+  for ( int i = 0; i < count; ++i )
+    items.push_back( add_item( 0x0eed, static_cast<u16>( dist( gen ) ),
+                               static_cast<u16>( dist( gen ) ), 0 ) );
+  return items;
+}
+}  // namespace
+
+static void BM_zone_items_in_range( benchmark::State& state )
+{
+  auto items = add_zone_items( static_cast<int>( state.range( 0 ) ) );
+  size_t count = 0;
+  while ( state.KeepRunning() )
+  {
+    WorldIterator<ItemFilter>::InRange( Pos2d( 96, 96 ), gamestate.main_realm, 4,
+                                        [&]( Items::Item* ) { ++count; } );
+  }
+  benchmark::DoNotOptimize( count );
+  for ( auto& item : items )
+    destroy_item( item );
+}
+BENCHMARK( BM_zone_items_in_range )->Arg( 100 )->Arg( 1000 )->Arg( 10000 );
+
+static void BM_zone_items_in_visual_range( benchmark::State& state )
+{
+  auto items = add_zone_items( static_cast<int>( state.range( 0 ) ) );
+  size_t count = 0;
+  while ( state.KeepRunning() )
+  {
+    WorldIterator<ItemFilter>::InVisualRange( Pos2d( 96, 96 ), gamestate.main_realm,
+                                              [&]( Items::Item* ) { ++count; } );
+  }
+  benchmark::DoNotOptimize( count );
+  for ( auto& item : items )
+    destroy_item( item );
+}
+BENCHMARK( BM_zone_items_in_visual_range )->Arg( 100 )->Arg( 1000 )->Arg( 10000 );
+#endif
+}  // namespace Testing
+}  // namespace Pol
@@ -12,8 +12,10 @@
 
 #include "tooltips.h"
 
+#include <memory>
 #include <stddef.h>
 #include <string>
+#include <vector>
 
 #include "../bscript/impstr.h"
 #include "../clib/clib_endian.h"
@@ -22,6 +24,7 @@
 #include "item/itemdesc.h"
 #include "mobile/charactr.h"
 #include "network/client.h"
+#include "network/clientio.h"
 #include "network/packetdefs.h"
 #include "network/packethelper.h"
 #include "network/packets.h"
@@ -88,7 +91,12 @@ void send_object_cache_to_inrange( const UObject* obj )
 }
 
 
-void SendAOSTooltip( Network::Client* client, UObject* obj, bool vendor_content )
+namespace
+{
+// increased by invalidate_aos_tooltips(), cached packets of an older generation are stale
+u32 aos_tooltip_generation = 0;
+
+void build_aos_tooltip( UObject* obj, bool vendor_content, std::vector<u8>& pkt )
 {
   std::string desc;
   if ( obj->isa( UOBJ_CLASS::CLASS_CHARACTER ) )
@@ -133,7 +141,33 @@ void SendAOSTooltip( Network::Client* client, UObject* obj, bool vendor_content
   u16 len = msg->offset;
   msg->offset = 1;
   msg->WriteFlipped<u16>( len );
-  msg.Send( client, len );
+  pkt.assign( msg->buffer, msg->buffer + len );
+}
+}  // namespace
+
+void SendAOSTooltip( Network::Client* client, UObject* obj, bool vendor_content )
+{
+  // clients request the tooltip of every object they get to see, so the packet is only build
+  // again after the revision changed
+  std::shared_ptr<AOSTooltipCache> cache = obj->aos_tooltip_cache();
+  if ( !cache )
+  {
+    cache = std::make_shared<AOSTooltipCache>();
+    obj->aos_tooltip_cache( cache );
+  }
+  AOSTooltipCache::Entry& entry = vendor_content ? cache->vendor : cache->normal;
+  if ( entry.pkt.empty() || entry.rev != obj->rev() || entry.generation != aos_tooltip_generation )
+  {
+    build_aos_tooltip( obj, vendor_content, entry.pkt );
+    entry.rev = obj->rev();
+    entry.generation = aos_tooltip_generation;
+  }
+  Network::transmit( client, entry.pkt.data(), static_cast<int>( entry.pkt.size() ) );
+}
+
+void invalidate_aos_tooltips()
+{
+  ++aos_tooltip_generation;
 }
 }  // namespace Core
 }  // namespace Pol
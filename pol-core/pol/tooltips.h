@@ -9,6 +9,10 @@
 #ifndef __TOOLTIPS_H
 #define __TOOLTIPS_H
 
+#include <vector>
+
+#include "../clib/rawtypes.h"
+
 namespace Pol
 {
 namespace Network
@@ -18,9 +22,26 @@ class Client;
 namespace Core
 {
 class UObject;
+
+// encoded 0xD6 packets of an object, valid as long as its revision did not change and no
+// configuration got reloaded
+struct AOSTooltipCache
+{
+  struct Entry
+  {
+    u32 rev = 0;
+    u32 generation = 0;
+    std::vector<u8> pkt;
+  };
+  Entry normal;
+  Entry vendor;  // merchant description
+};
+
 void send_object_cache( Network::Client* client, const UObject* obj );
 void send_object_cache_to_inrange( const UObject* obj );
 void SendAOSTooltip( Network::Client* client, UObject* item, bool vendor_content = false );
+// the descriptions may have changed without a revision change (config reload)
+void invalidate_aos_tooltips();
 }
 }
 #endif
@@ -1504,19 +1504,33 @@ void send_death_message( Character* chr_died, Item* corpse )
                                                     {
                                                       if ( zonechr == chr_died )
                                                         return;
-                                                      msg.Send( zonechr->client );
+                                                      msg.SendShared( zonechr->client );
                                                     } );
 }
 
+// copies the packet once on the first recipient, all recipients share the copy
+static void transmit_shared( Client* client, const void* msg, unsigned msglen,
+                             Network::SharedPacketData& shared )
+{
+  if ( !shared )
+  {
+    const u8* data = static_cast<const u8*>( msg );
+    shared = std::make_shared<const std::vector<u8>>( data, data + msglen );
+  }
+  Core::networkManager.clientTransmit->AddToQueue( client, shared );
+}
+
 void transmit_to_inrange( const UObject* center, const void* msg, unsigned msglen )
 {
+  Network::SharedPacketData shared;
   WorldIterator<OnlinePlayerFilter>::InVisualRange(
-      center, [&]( Character* zonechr )
-      { Core::networkManager.clientTransmit->AddToQueue( zonechr->client, msg, msglen ); } );
+      center,
+      [&]( Character* zonechr ) { transmit_shared( zonechr->client, msg, msglen, shared ); } );
 }
 
 void transmit_to_others_inrange( Character* center, const void* msg, unsigned msglen )
 {
+  Network::SharedPacketData shared;
   WorldIterator<OnlinePlayerFilter>::InVisualRange(
       center,
       [&]( Character* zonechr )
@@ -1524,7 +1538,7 @@ void transmit_to_others_inrange( Character* center, const void* msg, unsigned ms
         Client* client = zonechr->client;
         if ( zonechr == center )
           return;
-        Core::networkManager.clientTransmit->AddToQueue( client, msg, msglen );
+        transmit_shared( client, msg, msglen, shared );
       } );
 }
 
@@ -18,13 +18,26 @@
 #include <cstdio>
 #include <cstring>
 #include <exception>
+#include <functional>
 #include <future>
+#include <sstream>
 #include <string>
 #include <time.h>
+#ifdef __linux__
+#include <chrono>
+#include <dirent.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#endif
 
 #include "../clib/Program/ProgramConfig.h"
 #include "../clib/cfgelem.h"
 #include "../clib/cfgfile.h"
+#include "../clib/cfgsnapshot.h"
 #include "../clib/clib.h"
 #include "../clib/clib_endian.h"
 #include "../clib/esignal.h"
@@ -32,6 +45,7 @@
 #include "../clib/logfacility.h"
 #include "../clib/passert.h"
 #include "../clib/rawtypes.h"
+#include "../clib/streamsaver.h"
 #include "../clib/threadhelp.h"
 #include "../clib/timer.h"
 #include "../plib/poltype.h"
@@ -53,6 +67,7 @@
 #include "multi/house.h"
 #include "multi/multi.h"
 #include "objecthash.h"
+#include "polsem.h"
 #include "polvar.h"
 #include "regions/resource.h"
 #include "savedata.h"
@@ -68,6 +83,7 @@ namespace Pol
 namespace Module
 {
 void commit_datastore();
+bool flush_datastore();
 void read_datastore_dat();
 void write_datastore( Clib::StreamWriter& sw );
 }  // namespace Module
@@ -84,6 +100,8 @@ void read_guilds_dat();
 void write_guilds( Clib::StreamWriter& sw );
 
 std::shared_future<bool> SaveContext::finished;
+// set while a thread waits in SaveContext::ready()
+static std::atomic<bool> save_waiting( false );
 
 /****************** POL Native Files *******************/
 // Dave changed 3/8/3 to use objecthash
@@ -370,64 +388,132 @@ std::string elapsed( clock_t start, clock_t end )
   return Clib::tostring( ms ) + " ms";
 }
 
-void slurp( const char* filename, const char* tags, int sysfind_flags )
+// Reader is Clib::ConfigFile or Clib::SnapshotReader
+template <class Reader>
+unsigned int slurp_elements( Reader& cf, int sysfind_flags )
 {
   static int num_until_dot = 1000;
 
-  if ( Clib::FileExists( filename ) )
+  Clib::ConfigElem elem;
+  unsigned int nobjects = 0;
+  while ( cf.read( elem ) )
   {
-    INFO_PRINT << "  " << filename << ":";
-    Clib::ConfigFile cf( filename, tags );
-    Clib::ConfigElem elem;
-
-    Tools::Timer<> timer;
-
-    unsigned int nobjects = 0;
-    while ( cf.read( elem ) )
+    if ( --num_until_dot == 0 )
     {
-      if ( --num_until_dot == 0 )
-      {
-        INFO_PRINT << ".";
-        num_until_dot = 1000;
-      }
-      try
+      INFO_PRINT << ".";
+      num_until_dot = 1000;
+    }
+    try
+    {
+      if ( stricmp( elem.type(), "CHARACTER" ) == 0 )
+        read_character( elem );
+      else if ( stricmp( elem.type(), "NPC" ) == 0 )
+        read_npc( elem );
+      else if ( stricmp( elem.type(), "ITEM" ) == 0 )
+        read_global_item( elem, sysfind_flags );
+      else if ( stricmp( elem.type(), "GLOBALPROPERTIES" ) == 0 )
+        gamestate.global_properties->readProperties( elem );
+      else if ( elem.type_is( "SYSTEM" ) )
+        read_system_vars( elem );
+      else if ( elem.type_is( "MULTI" ) )
+        read_multi( elem );
+      else if ( elem.type_is( "STORAGEAREA" ) )
       {
-        if ( stricmp( elem.type(), "CHARACTER" ) == 0 )
-          read_character( elem );
-        else if ( stricmp( elem.type(), "NPC" ) == 0 )
-          read_npc( elem );
-        else if ( stricmp( elem.type(), "ITEM" ) == 0 )
-          read_global_item( elem, sysfind_flags );
-        else if ( stricmp( elem.type(), "GLOBALPROPERTIES" ) == 0 )
-          gamestate.global_properties->readProperties( elem );
-        else if ( elem.type_is( "SYSTEM" ) )
-          read_system_vars( elem );
-        else if ( elem.type_is( "MULTI" ) )
-          read_multi( elem );
-        else if ( elem.type_is( "STORAGEAREA" ) )
-        {
-          StorageArea* storage_area = gamestate.storage.create_area( elem );
-          // this will be followed by an item
-          if ( !cf.read( elem ) )
-            throw std::runtime_error( "Expected an item to exist after the storagearea." );
+        StorageArea* storage_area = gamestate.storage.create_area( elem );
+        // this will be followed by an item
+        if ( !cf.read( elem ) )
+          throw std::runtime_error( "Expected an item to exist after the storagearea." );
 
-          storage_area->load_item( elem );
-        }
-        else if ( elem.type_is( "REALM" ) )
-          read_shadow_realms( elem );
-      }
-      catch ( std::exception& )
-      {
-        if ( !Plib::systemstate.config.ignore_load_errors )
-          throw;
+        storage_area->load_item( elem );
       }
-      ++nobjects;
+      else if ( elem.type_is( "REALM" ) )
+        read_shadow_realms( elem );
     }
+    catch ( std::exception& )
+    {
+      if ( !Plib::systemstate.config.ignore_load_errors )
+        throw;
+    }
+    ++nobjects;
+  }
+  return nobjects;
+}
+
+// Snapshots are always decoded in the background, text files only with pol.cfg
+// ParallelWorldLoad. Returns nullptr if the file has to be read with ConfigFile.
+std::unique_ptr<Clib::ChunkedConfigReader> open_chunked_reader( const std::string& filename,
+                                                                const char* tags )
+{
+  std::unique_ptr<Clib::ChunkedConfigReader> reader;
+  if ( !Clib::FileExists( filename ) )
+    return reader;
+  if ( Clib::SnapshotReader::is_snapshot( filename ) )
+    reader.reset( new Clib::SnapshotReader( filename, tags, &gamestate.task_thread_pool ) );
+  else if ( Plib::systemstate.config.parallel_world_load )
+    reader.reset( new Clib::ParallelTextReader( filename, tags, &gamestate.task_thread_pool ) );
+  return reader;
+}
+
+void slurp( const char* filename, const char* tags, int sysfind_flags,
+            std::unique_ptr<Clib::ChunkedConfigReader> reader )
+{
+  if ( reader == nullptr )
+    reader = open_chunked_reader( filename, tags );
+  if ( reader == nullptr && !Clib::FileExists( filename ) )
+    return;
+
+  INFO_PRINT << "  " << filename << ":";
+  Tools::Timer<> timer;
+
+  unsigned int nobjects;
+  if ( reader != nullptr )
+  {
+    nobjects = slurp_elements( *reader, sysfind_flags );
+  }
+  else
+  {
+    Clib::ConfigFile cf( filename, tags );
+    nobjects = slurp_elements( cf, sysfind_flags );
+  }
 
-    timer.stop();
+  timer.stop();
 
-    INFO_PRINT << " " << nobjects << " elements in " << timer.ellapsed() << " ms.\n";
+  INFO_PRINT << " " << nobjects << " elements in " << timer.ellapsed() << " ms";
+  if ( reader != nullptr )
+  {
+    // parse time is summed up over all pool threads, wait is the part the main thread noticed
+    INFO_PRINT << " (parsed in " << reader->decode_us() / 1000 << " ms, waited "
+               << reader->wait_us() / 1000 << " ms)";
   }
+  INFO_PRINT << ".\n";
+}
+
+void slurp( const char* filename, const char* tags, int sysfind_flags )
+{
+  slurp( filename, tags, sysfind_flags, nullptr );
+}
+
+unsigned int slurp_range( const std::string& filename, size_t begin, size_t end, const char* tags )
+{
+  Clib::ParallelTextReader reader( filename, begin, end, tags, &gamestate.task_thread_pool );
+  return slurp_elements( reader, 0 );
+}
+
+// pcs, items & co. are either stored as text (name.txt) or as binary snapshot (name.bin)
+std::string object_file( const std::string& basename )
+{
+  std::string txtfile = Plib::systemstate.config.world_data_path + basename + ".txt";
+  std::string binfile = Plib::systemstate.config.world_data_path + basename + ".bin";
+  if ( !Clib::FileExists( binfile ) )
+    return txtfile;
+  if ( Clib::FileExists( txtfile ) )
+  {
+    ERROR_PRINT << "Error!\n"
+                << "Both '" << txtfile << "' and '" << binfile << "' exist.\n"
+                << "Remove the outdated one to avoid loading old data.\n";
+    throw std::runtime_error( "Human intervention required." );
+  }
+  return binfile;
 }
 
 void read_pol_dat()
@@ -456,59 +542,16 @@ void read_objects_dat()
          "CHARACTER NPC ITEM GLOBALPROPERTIES" );
 }
 
-void read_pcs_dat()
-{
-  slurp( ( Plib::systemstate.config.world_data_path + "pcs.txt" ).c_str(), "CHARACTER ITEM",
-         SYSFIND_SKIP_WORLD );
-}
-
-void read_pcequip_dat()
-{
-  slurp( ( Plib::systemstate.config.world_data_path + "pcequip.txt" ).c_str(), "ITEM",
-         SYSFIND_SKIP_WORLD );
-}
-
-void read_npcs_dat()
-{
-  slurp( ( Plib::systemstate.config.world_data_path + "npcs.txt" ).c_str(), "NPC ITEM",
-         SYSFIND_SKIP_WORLD );
-}
-
-void read_npcequip_dat()
-{
-  slurp( ( Plib::systemstate.config.world_data_path + "npcequip.txt" ).c_str(), "ITEM",
-         SYSFIND_SKIP_WORLD );
-}
-
-void read_items_dat()
-{
-  slurp( ( Plib::systemstate.config.world_data_path + "items.txt" ).c_str(), "ITEM" );
-}
-
-void read_multis_dat()
-{
-  slurp( ( Plib::systemstate.config.world_data_path + "multis.txt" ).c_str(), "MULTI" );
-  //  string multisfile = config.world_data_path + "multis.txt";
-  //  if (FileExists( multisfile ))
-  //  {
-  //    cout << multisfile << ":";
-  //    ConfigFile cf( multisfile, "MULTI" );
-  //    ConfigElem elem;
-  //    while( cf.read( elem ))
-  //    {
-  //      UMulti* multi = read_multi( elem );
-  //      if (multi == nullptr) throw runtime_error( "multi creation returned nullptr!" );
-  //
-  //      add_multi_to_world( multi );
-  //    }
-  //  }
-}
-
-void read_storage_dat()
+void read_storage_dat( std::unique_ptr<Clib::ChunkedConfigReader> reader )
 {
   std::string storagefile = Plib::systemstate.config.world_data_path + "storage.txt";
 
-  if ( Clib::FileExists( storagefile ) )
+  if ( reader != nullptr )
+  {
+    INFO_PRINT << "  " << storagefile << ":";
+    gamestate.storage.read( *reader );
+  }
+  else if ( Clib::FileExists( storagefile ) )
   {
     INFO_PRINT << "  " << storagefile << ":";
     Clib::ConfigFile cf2( storagefile );
@@ -516,6 +559,43 @@ void read_storage_dat()
   }
 }
 
+struct ObjectFile
+{
+  const char* basename;
+  const char* tags;
+  int sysfind_flags;
+};
+
+// in load order, containers and owners have to exist before the items in them
+const ObjectFile object_files[] = {
+    {"pcs", "CHARACTER ITEM", SYSFIND_SKIP_WORLD},   {"pcequip", "ITEM", SYSFIND_SKIP_WORLD},
+    {"npcs", "NPC ITEM", SYSFIND_SKIP_WORLD},         {"npcequip", "ITEM", SYSFIND_SKIP_WORLD},
+    {"items", "ITEM", 0},                            {"multis", "MULTI", 0}};
+
+// The readers of all files get opened first, so the pool starts parsing every file right away.
+// Inserting the objects stays on this thread and in file order, parsing of the later files
+// overlaps with inserting the objects of the earlier ones.
+void read_object_files()
+{
+  std::vector<std::string> filenames;
+  std::vector<std::unique_ptr<Clib::ChunkedConfigReader>> readers;
+  for ( const auto& file : object_files )
+  {
+    filenames.push_back( object_file( file.basename ) );
+    readers.push_back( open_chunked_reader( filenames.back(), file.tags ) );
+  }
+  std::unique_ptr<Clib::ChunkedConfigReader> storage_reader =
+      open_chunked_reader( Plib::systemstate.config.world_data_path + "storage.txt", nullptr );
+
+  Tools::Timer<> timer;
+  for ( size_t i = 0; i < filenames.size(); ++i )
+    slurp( filenames[i].c_str(), object_files[i].tags, object_files[i].sysfind_flags,
+           std::move( readers[i] ) );
+  read_storage_dat( std::move( storage_reader ) );
+  timer.stop();
+  INFO_PRINT << "  objects read in " << timer.ellapsed() << " ms.\n";
+}
+
 Items::Item* find_existing_item( u32 objtype, const Pos4d& pos )
 {
   Pos2d gridp = zone_convert( pos );
@@ -649,13 +729,7 @@ int read_data()
   start_gameclock();
 
   read_objects_dat();
-  read_pcs_dat();
-  read_pcequip_dat();
-  read_npcs_dat();
-  read_npcequip_dat();
-  read_items_dat();
-  read_multis_dat();
-  read_storage_dat();
+  read_object_files();
   read_resources_dat();
   read_guilds_dat();
   Module::read_datastore_dat();
@@ -698,7 +772,17 @@ int read_data()
 }
 
 
-SaveContext::SaveContext()
+namespace
+{
+std::unique_ptr<Clib::StreamWriter> object_file_writer( std::ofstream* stream, bool binary )
+{
+  if ( binary )
+    return std::unique_ptr<Clib::StreamWriter>( new Clib::SnapshotStreamWriter );
+  return std::unique_ptr<Clib::StreamWriter>( new Clib::OFStreamWriter( stream ) );
+}
+}  // namespace
+
+SaveContext::SaveContext( bool binary_objects )
     : _pol(),
       _objects(),
       _pcs(),
@@ -707,6 +791,12 @@ SaveContext::SaveContext()
       _npcequip(),
       _items(),
       _multis(),
+      _pcs_writer( object_file_writer( &_pcs, binary_objects ) ),
+      _pcequip_writer( object_file_writer( &_pcequip, binary_objects ) ),
+      _npcs_writer( object_file_writer( &_npcs, binary_objects ) ),
+      _npcequip_writer( object_file_writer( &_npcequip, binary_objects ) ),
+      _items_writer( object_file_writer( &_items, binary_objects ) ),
+      _multis_writer( object_file_writer( &_multis, binary_objects ) ),
       _storage(),
       _resource(),
       _guilds(),
@@ -714,12 +804,12 @@ SaveContext::SaveContext()
       _party(),
       pol( &_pol ),
       objects( &_objects ),
-      pcs( &_pcs ),
-      pcequip( &_pcequip ),
-      npcs( &_npcs ),
-      npcequip( &_npcequip ),
-      items( &_items ),
-      multis( &_multis ),
+      pcs( *_pcs_writer ),
+      pcequip( *_pcequip_writer ),
+      npcs( *_npcs_writer ),
+      npcequip( *_npcequip_writer ),
+      items( *_items_writer ),
+      multis( *_multis_writer ),
       storage( &_storage ),
       resource( &_resource ),
       guilds( &_guilds ),
@@ -728,12 +818,13 @@ SaveContext::SaveContext()
 {
   pol.init( Plib::systemstate.config.world_data_path + "pol.ndt" );
   objects.init( Plib::systemstate.config.world_data_path + "objects.ndt" );
-  pcs.init( Plib::systemstate.config.world_data_path + "pcs.ndt" );
-  pcequip.init( Plib::systemstate.config.world_data_path + "pcequip.ndt" );
-  npcs.init( Plib::systemstate.config.world_data_path + "npcs.ndt" );
-  npcequip.init( Plib::systemstate.config.world_data_path + "npcequip.ndt" );
-  items.init( Plib::systemstate.config.world_data_path + "items.ndt" );
-  multis.init( Plib::systemstate.config.world_data_path + "multis.ndt" );
+  const char* objext = binary_objects ? ".bin.ndt" : ".ndt";
+  pcs.init( Plib::systemstate.config.world_data_path + "pcs" + objext );
+  pcequip.init( Plib::systemstate.config.world_data_path + "pcequip" + objext );
+  npcs.init( Plib::systemstate.config.world_data_path + "npcs" + objext );
+  npcequip.init( Plib::systemstate.config.world_data_path + "npcequip" + objext );
+  items.init( Plib::systemstate.config.world_data_path + "items" + objext );
+  multis.init( Plib::systemstate.config.world_data_path + "multis" + objext );
   storage.init( Plib::systemstate.config.world_data_path + "storage.ndt" );
   resource.init( Plib::systemstate.config.world_data_path + "resource.ndt" );
   guilds.init( Plib::systemstate.config.world_data_path + "guilds.ndt" );
@@ -809,7 +900,9 @@ void SaveContext::ready()
   if ( SaveContext::finished.valid() )
   {
     // Tools::Timer<Tools::DebugT> t("future");
+    save_waiting = true;
     SaveContext::finished.wait();
+    save_waiting = false;
   }
 }
 
@@ -959,11 +1052,10 @@ void write_multis( Clib::StreamWriter& ofs )
   }
 }
 
-bool commit( const std::string& basename )
+// moves ndtfile to datfile and the previous datfile to bakfile
+bool commit_files( const std::string& bakfile, const std::string& datfile,
+                   const std::string& ndtfile )
 {
-  std::string bakfile = Plib::systemstate.config.world_data_path + basename + ".bak";
-  std::string datfile = Plib::systemstate.config.world_data_path + basename + ".txt";
-  std::string ndtfile = Plib::systemstate.config.world_data_path + basename + ".ndt";
   const char* bakfile_c = bakfile.c_str();
   const char* datfile_c = datfile.c_str();
   const char* ndtfile_c = ndtfile.c_str();
@@ -992,7 +1084,7 @@ bool commit( const std::string& basename )
     }
   }
 
-  if ( Clib::FileExists( ndtfile_c ) )
+  if ( !ndtfile.empty() && Clib::FileExists( ndtfile_c ) )
   {
     any = true;
     if ( rename( ndtfile_c, datfile_c ) )
@@ -1006,6 +1098,47 @@ bool commit( const std::string& basename )
   return any;
 }
 
+bool commit( const std::string& basename )
+{
+  std::string path = Plib::systemstate.config.world_data_path + basename;
+  return commit_files( path + ".bak", path + ".txt", path + ".ndt" );
+}
+
+// The file in the other format is an older save, it becomes the backup. Otherwise it would be
+// loaded instead (or together with) the new one.
+bool commit_object_file( const std::string& basename, bool binary )
+{
+  std::string path = Plib::systemstate.config.world_data_path + basename;
+  if ( binary )
+  {
+    bool any = commit_files( path + ".bin.bak", path + ".bin", path + ".bin.ndt" );
+    if ( Clib::FileExists( path + ".txt" ) )
+      any = commit_files( path + ".bak", path + ".txt", "" ) || any;
+    return any;
+  }
+  bool any = commit( basename );
+  if ( Clib::FileExists( path + ".bin" ) )
+    any = commit_files( path + ".bin.bak", path + ".bin", "" ) || any;
+  return any;
+}
+
+void commit_world_files( bool binary_objects )
+{
+  commit( "pol" );
+  commit( "objects" );
+  commit_object_file( "pcs", binary_objects );
+  commit_object_file( "pcequip", binary_objects );
+  commit_object_file( "npcs", binary_objects );
+  commit_object_file( "npcequip", binary_objects );
+  commit_object_file( "items", binary_objects );
+  commit_object_file( "multis", binary_objects );
+  commit( "storage" );
+  commit( "resource" );
+  commit( "guilds" );
+  commit( "datastore" );
+  commit( "parties" );
+}
+
 bool should_write_data()
 {
   if ( Plib::systemstate.config.inhibit_saves )
@@ -1016,6 +1149,494 @@ bool should_write_data()
   return true;
 }
 
+// the part after the world got written (or forked), the save itself may still run
+void finish_write_data( unsigned int& dirty_writes, unsigned int& clean_writes,
+                        long long& elapsed_ms, Tools::Timer<>& timer )
+{
+  if ( Plib::systemstate.accounts_txt_dirty )  // write accounts extra, since it uses extra thread
+                                               // for io operations would be to many threads working
+  {
+    Accounts::write_account_data();
+  }
+
+  commit_incremental_saves();
+  objStorageManager.journal.rotate();
+  objStorageManager.incremental_save_count = 0;
+  timer.stop();
+  objStorageManager.objecthash.ClearDeleted();
+  // optimize_zones(); // shrink zone vectors TODO this takes way to much time!
+
+  // cout << "Clean: " << UObject::clean_writes << " Dirty: " <<
+  // UObject::dirty_writes << endl;
+  clean_writes = UObject::clean_writes;
+  dirty_writes = UObject::dirty_writes;
+  elapsed_ms = timer.ellapsed();
+
+  objStorageManager.incremental_saves_disabled = false;
+}
+
+// The save in threads of this process: critical_promise gets set once the world has been
+// written into buffers, the caller holds the world until then.
+bool write_data_threaded( std::shared_ptr<std::promise<bool>> critical_promise )
+{
+  Tools::Timer<> save_timer;
+  std::atomic<bool> result( true );
+  bool binary_objects = Plib::systemstate.config.binary_world_save;
+  std::vector<std::future<bool>> critical_parts;
+  bool critical_done = false;
+  try
+  {
+    SaveContext sc( binary_objects );
+    critical_parts.push_back( gamestate.task_thread_pool.checked_push(
+        [&]()
+        {
+          try
+          {
+            sc.pol() << "#" << pf_endl << "#  Created by Version: " << POL_VERSION_ID
+                     << pf_endl << "#  Mobiles: " << get_mobile_count() << pf_endl
+                     << "#  Top-level Items: " << get_toplevel_item_count() << pf_endl << "#"
+                     << pf_endl << pf_endl;
+
+            write_system_data( sc.pol );
+            write_global_properties( sc.pol );
+            write_shadow_realms( sc.pol );
+          }
+          catch ( ... )
+          {
+            POLLOG_ERROR << "failed to store pol datafile!\n";
+            Clib::force_backtrace();
+            result = false;
+          }
+        } ) );
+    critical_parts.push_back( gamestate.task_thread_pool.checked_push(
+        [&]()
+        {
+          try
+          {
+            write_items( sc.items );
+          }
+          catch ( ... )
+          {
+            POLLOG_ERROR << "failed to store items datafile!\n";
+            Clib::force_backtrace();
+            result = false;
+          }
+        } ) );
+    critical_parts.push_back( gamestate.task_thread_pool.checked_push(
+        [&]()
+        {
+          try
+          {
+            write_characters( sc );
+          }
+          catch ( ... )
+          {
+            POLLOG_ERROR << "failed to store character datafile!\n";
+            Clib::force_backtrace();
+            result = false;
+          }
+        } ) );
+    critical_parts.push_back( gamestate.task_thread_pool.checked_push(
+        [&]()
+        {
+          try
+          {
+            write_npcs( sc );
+          }
+          catch ( ... )
+          {
+            POLLOG_ERROR << "failed to store npcs datafile!\n";
+            Clib::force_backtrace();
+            result = false;
+          }
+        } ) );
+    critical_parts.push_back( gamestate.task_thread_pool.checked_push(
+        [&]()
+        {
+          try
+          {
+            write_multis( sc.multis );
+          }
+          catch ( ... )
+          {
+            POLLOG_ERROR << "failed to store multis datafile!\n";
+            Clib::force_backtrace();
+            result = false;
+          }
+        } ) );
+    critical_parts.push_back( gamestate.task_thread_pool.checked_push(
+        [&]()
+        {
+          try
+          {
+            gamestate.storage.print( sc.storage );
+          }
+          catch ( ... )
+          {
+            POLLOG_ERROR << "failed to store storage datafile!\n";
+            Clib::force_backtrace();
+            result = false;
+          }
+        } ) );
+    critical_parts.push_back( gamestate.task_thread_pool.checked_push(
+        [&]()
+        {
+          try
+          {
+            write_resources_dat( sc.resource );
+          }
+          catch ( ... )
+          {
+            POLLOG_ERROR << "failed to store resource datafile!\n";
+            Clib::force_backtrace();
+            result = false;
+          }
+        } ) );
+    critical_parts.push_back( gamestate.task_thread_pool.checked_push(
+        [&]()
+        {
+          try
+          {
+            write_guilds( sc.guilds );
+          }
+          catch ( ... )
+          {
+            POLLOG_ERROR << "failed to store guilds datafile!\n";
+            Clib::force_backtrace();
+            result = false;
+          }
+        } ) );
+    critical_parts.push_back( gamestate.task_thread_pool.checked_push(
+        [&]()
+        {
+          try
+          {
+            Module::write_datastore( sc.datastore );
+            // Atomically (hopefully) perform the switch.
+            Module::commit_datastore();
+          }
+          catch ( ... )
+          {
+            POLLOG_ERROR << "failed to store datastore datafile!\n";
+            Clib::force_backtrace();
+            result = false;
+          }
+        } ) );
+    critical_parts.push_back( gamestate.task_thread_pool.checked_push(
+        [&]()
+        {
+          try
+          {
+            write_party( sc.party );
+          }
+          catch ( ... )
+          {
+            POLLOG_ERROR << "failed to store party datafile!\n";
+            Clib::force_backtrace();
+            result = false;
+          }
+        } ) );
+    for ( auto& task : critical_parts )
+      task.wait();
+
+    critical_promise->set_value( result );  // critical part end
+    critical_done = true;
+    // the datastore files get written from their snapshots while the world runs again
+    if ( !Module::flush_datastore() )
+      result = false;
+  }  // deconstructor of the SaveContext flushes and joins the queues
+  catch ( std::ios_base::failure& e )
+  {
+    POLLOG_ERROR << "failed to save datafiles! " << e.what() << ":" << std::strerror( errno )
+                 << "\n";
+    Clib::force_backtrace();
+    result = false;
+  }
+  catch ( ... )
+  {
+    POLLOG_ERROR << "failed to save datafiles!\n";
+    Clib::force_backtrace();
+    result = false;
+  }
+  if ( !critical_done )
+  {
+    // the main thread holds the world until the critical part ends
+    for ( auto& task : critical_parts )
+    {
+      if ( task.valid() )
+        task.wait();
+    }
+    critical_promise->set_value( false );
+  }
+  // reloads of the snapshotted datastore files wait for them to be written
+  if ( !Module::flush_datastore() )
+    result = false;
+  if ( result )
+    commit_world_files( binary_objects );
+  networkManager.polstats.worldsave_duration_ms = save_timer.ellapsed();
+  return result;
+}
+
+#ifdef __linux__
+namespace
+{
+void report_to_parent( int fd, const std::string& line )
+{
+  const char* data = line.c_str();
+  size_t left = line.size();
+  while ( left )
+  {
+    ssize_t res = ::write( fd, data, left );
+    if ( res < 0 && errno == EINTR )
+      continue;
+    if ( res <= 0 )
+      return;  // parent is gone, nobody to tell
+    data += res;
+    left -= static_cast<size_t>( res );
+  }
+}
+
+// sockets and files of the parent, otherwise e.g. a closed client connection stays open until
+// the save is done
+void close_inherited_fds( int keep_fd )
+{
+  std::vector<int> fds;
+  DIR* dir = opendir( "/proc/self/fd" );
+  if ( dir == nullptr )
+    return;
+  while ( dirent* entry = readdir( dir ) )
+  {
+    int fd = atoi( entry->d_name );
+    if ( fd > 2 && fd != keep_fd && fd != dirfd( dir ) )
+      fds.push_back( fd );
+  }
+  closedir( dir );
+  for ( int fd : fds )
+    close( fd );
+}
+
+// Runs in the forked child. Only the forking thread exists here: no task pool and no logging
+// (the logger thread is gone), progress and errors are sent through the pipe instead.
+int forked_save_child( int fd, bool binary_objects, const std::string& datastore_text )
+{
+  close_inherited_fds( fd );
+  UObject::dirty_writes = 0;
+  UObject::clean_writes = 0;
+  try
+  {
+    SaveContext sc( binary_objects );
+    auto part = [fd]( const char* name, const std::function<void()>& func ) {
+      Tools::Timer<> part_timer;
+      func();
+      report_to_parent( fd, std::string( "progress " ) + name + " " +
+                                std::to_string( part_timer.ellapsed() ) + "\n" );
+    };
+    part( "pol", [&]() {
+      sc.pol() << "#" << pf_endl << "#  Created by Version: " << POL_VERSION_ID << pf_endl
+               << "#  Mobiles: " << get_mobile_count() << pf_endl
+               << "#  Top-level Items: " << get_toplevel_item_count() << pf_endl << "#" << pf_endl
+               << pf_endl;
+      write_system_data( sc.pol );
+      write_global_properties( sc.pol );
+      write_shadow_realms( sc.pol );
+    } );
+    part( "items", [&]() { write_items( sc.items ); } );
+    part( "pcs", [&]() { write_characters( sc ); } );
+    part( "npcs", [&]() { write_npcs( sc ); } );
+    part( "multis", [&]() { write_multis( sc.multis ); } );
+    part( "storage", [&]() { gamestate.storage.print( sc.storage ); } );
+    part( "resource", [&]() { write_resources_dat( sc.resource ); } );
+    part( "guilds", [&]() { write_guilds( sc.guilds ); } );
+    part( "datastore", [&]() { sc.datastore() << datastore_text; } );
+    part( "parties", [&]() { write_party( sc.party ); } );
+  }  // deconstructor of the SaveContext flushes the files
+  catch ( std::exception& ex )
+  {
+    report_to_parent( fd, std::string( "error " ) + ex.what() + "\n" );
+    return 1;
+  }
+  catch ( ... )
+  {
+    report_to_parent( fd, "error unknown exception\n" );
+    return 1;
+  }
+  report_to_parent( fd, "counts " + std::to_string( UObject::dirty_writes ) + " " +
+                            std::to_string( UObject::clean_writes ) + "\n" );
+  return 0;
+}
+
+// set after a forked save got killed, the following saves run in threads
+std::atomic<bool> fork_save_disabled( false );
+
+// Runs the threaded save on the thread waiting for the failed child. The world is only taken
+// if no other save waits for this one, that one writes the world anyway.
+bool fallback_to_threaded_save()
+{
+  while ( !polsem_try_lock() )
+  {
+    if ( save_waiting || Clib::exit_signalled )
+      return false;
+    std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+  }
+  POLLOG_INFO << "Worldsave: saving in threads instead\n";
+  auto critical_promise = std::make_shared<std::promise<bool>>();
+  auto critical_future = critical_promise->get_future();
+  auto saving = std::async( std::launch::async, write_data_threaded, critical_promise );
+  critical_future.wait();
+  polsem_unlock();
+  return saving.get();
+}
+
+// Parent side: reports the child's progress and commits its files once it succeeded. Kills the
+// child if it takes longer than pol.cfg ForkWorldSaveTimeout (it may e.g. wait for a mutex some
+// other thread held while forking) and saves in threads then.
+bool wait_for_forked_save( pid_t pid, int fd, bool binary_objects, Tools::Timer<> save_timer,
+                           bool datastore_ok )
+{
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::seconds( Plib::systemstate.config.fork_world_save_timeout );
+  bool timed_out = false;
+  std::string pending;
+  char buf[512];
+  for ( ;; )
+  {
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now() );
+    if ( left.count() <= 0 )
+    {
+      timed_out = true;
+      break;
+    }
+    pollfd pfd = { fd, POLLIN, 0 };
+    int ready = ::poll( &pfd, 1, static_cast<int>( left.count() ) );
+    if ( ready < 0 && errno != EINTR )
+      break;
+    if ( ready <= 0 )
+      continue;  // checks the deadline
+    ssize_t res = ::read( fd, buf, sizeof buf );
+    if ( res < 0 && errno == EINTR )
+      continue;
+    if ( res <= 0 )
+      break;
+    pending.append( buf, static_cast<size_t>( res ) );
+    size_t nl;
+    while ( ( nl = pending.find( '\n' ) ) != std::string::npos )
+    {
+      std::string line = pending.substr( 0, nl );
+      pending.erase( 0, nl + 1 );
+      unsigned int dirty, clean;
+      if ( line.compare( 0, 9, "progress " ) == 0 )
+        POLLOG_INFO << "Worldsave: " << line.substr( 9 ) << " ms\n";
+      else if ( sscanf( line.c_str(), "counts %u %u", &dirty, &clean ) == 2 )
+      {
+        UObject::dirty_writes = dirty;
+        UObject::clean_writes = clean;
+      }
+      else
+        POLLOG_ERROR << "Worldsave process: " << line << "\n";
+    }
+  }
+  close( fd );
+
+  if ( timed_out )
+  {
+    POLLOG_ERROR << "Worldsave process did not finish within "
+                 << Plib::systemstate.config.fork_world_save_timeout
+                 << " seconds, killed it. Saving in threads from now on.\n";
+    fork_save_disabled = true;
+    kill( pid, SIGKILL );
+  }
+  int status = 0;
+  bool reaped = true;
+  while ( waitpid( pid, &status, 0 ) < 0 )
+  {
+    if ( errno != EINTR )
+    {
+      POLLOG_ERROR << "Worldsave process: waitpid failed: " << std::strerror( errno ) << "\n";
+      reaped = false;
+      break;
+    }
+  }
+  bool result =
+      reaped && !timed_out && WIFEXITED( status ) && WEXITSTATUS( status ) == 0 && datastore_ok;
+  if ( result )
+  {
+    commit_world_files( binary_objects );
+    networkManager.polstats.worldsave_duration_ms = save_timer.ellapsed();
+    POLLOG_INFO << "Worldsave process finished in " << save_timer.ellapsed() << " ms ("
+                << UObject::dirty_writes << " dirty, " << UObject::clean_writes
+                << " clean objects).\n";
+    return true;
+  }
+  POLLOG_ERROR.Format( "Worldsave process failed (status {}), data files not committed\n" )
+      << status;
+  return fallback_to_threaded_save();
+}
+}  // namespace
+
+// pol.cfg ForkWorldSave: the world only has to be held while fork() copies the page tables. The
+// child process writes the copy-on-write snapshot with the usual code while this process goes
+// on. Returns false if forking failed, the caller falls back to the threaded save then.
+bool write_data_forked()
+{
+  Tools::Timer<> stall_timer;
+  bool binary_objects = Plib::systemstate.config.binary_world_save;
+
+  // the datastore save updates file versions and snapshots the dirty datastore files, this
+  // has to happen in this process which also writes them while waiting for the child
+  std::ostringstream datastore_buffer;
+  {
+    Clib::OStreamWriter datastore_writer( &datastore_buffer );
+    Module::write_datastore( datastore_writer );
+    datastore_writer.flush_file();
+  }
+  Module::commit_datastore();
+
+  int fds[2];
+  if ( pipe( fds ) != 0 )
+  {
+    POLLOG_ERROR << "ForkWorldSave: pipe failed: " << std::strerror( errno ) << "\n";
+    Module::flush_datastore();  // the threaded save would not snapshot these files again
+    return false;
+  }
+  pid_t pid = fork();
+  if ( pid < 0 )
+  {
+    POLLOG_ERROR << "ForkWorldSave: fork failed: " << std::strerror( errno ) << "\n";
+    close( fds[0] );
+    close( fds[1] );
+    Module::flush_datastore();
+    return false;
+  }
+  if ( pid == 0 )
+  {
+    close( fds[0] );
+    int res = forked_save_child( fds[1], binary_objects, datastore_buffer.str() );
+    close( fds[1] );
+    _exit( res );  // no atexit handlers and destructors of the parent's state
+  }
+  close( fds[1] );
+
+  // what writing the objects would have done to the dirty flags, the child's changes stay in
+  // the child
+  for ( const auto& objitr : objStorageManager.objecthash )
+  {
+    if ( !objitr.second->orphan() )
+      objitr.second->clear_dirty();
+  }
+
+  networkManager.polstats.worldsave_stall_ms = stall_timer.ellapsed();
+  POLLOG_INFO << "Worldsave forked, world was held for " << stall_timer.ellapsed() << " ms.\n";
+  Tools::Timer<> save_timer = stall_timer;
+  int fd = fds[0];
+  SaveContext::finished = std::async( std::launch::async, [pid, fd, binary_objects, save_timer]() {
+    bool datastore_ok = Module::flush_datastore();
+    return wait_for_forked_save( pid, fd, binary_objects, save_timer, datastore_ok );
+  } );
+  return true;
+}
+#endif
+
 int write_data( unsigned int& dirty_writes, unsigned int& clean_writes, long long& elapsed_ms )
 {
   SaveContext::ready();  // allow only one active
@@ -1030,229 +1651,26 @@ int write_data( unsigned int& dirty_writes, unsigned int& clean_writes, long lon
   UObject::clean_writes = 0;
 
   Tools::Timer<> timer;
+#ifdef __linux__
+  // on shutdown the process ends anyway and write_multis has to drop pending house commits
+  if ( Plib::systemstate.config.fork_world_save && !fork_save_disabled && !Clib::exit_signalled &&
+       write_data_forked() )
+  {
+    finish_write_data( dirty_writes, clean_writes, elapsed_ms, timer );
+    return 0;
+  }
+#endif
   // launch complete save as seperate thread
   // but wait till the first critical part is finished
   // which means all objects got written into a format object
   // the remaining operations are only pure buffered i/o
   auto critical_promise = std::make_shared<std::promise<bool>>();
   auto critical_future = critical_promise->get_future();
-  SaveContext::finished = std::async(
-      std::launch::async,
-      [&, critical_promise]() -> bool
-      {
-        std::atomic<bool> result( true );
-        try
-        {
-          SaveContext sc;
-          std::vector<std::future<bool>> critical_parts;
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  sc.pol() << "#" << pf_endl << "#  Created by Version: " << POL_VERSION_ID
-                           << pf_endl << "#  Mobiles: " << get_mobile_count() << pf_endl
-                           << "#  Top-level Items: " << get_toplevel_item_count() << pf_endl << "#"
-                           << pf_endl << pf_endl;
-
-                  write_system_data( sc.pol );
-                  write_global_properties( sc.pol );
-                  write_shadow_realms( sc.pol );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERROR << "failed to store pol datafile!\n";
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  write_items( sc.items );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERROR << "failed to store items datafile!\n";
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  write_characters( sc );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERROR << "failed to store character datafile!\n";
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  write_npcs( sc );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERROR << "failed to store npcs datafile!\n";
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  write_multis( sc.multis );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERROR << "failed to store multis datafile!\n";
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  gamestate.storage.print( sc.storage );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERROR << "failed to store storage datafile!\n";
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  write_resources_dat( sc.resource );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERROR << "failed to store resource datafile!\n";
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  write_guilds( sc.guilds );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERROR << "failed to store guilds datafile!\n";
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  Module::write_datastore( sc.datastore );
-                  // Atomically (hopefully) perform the switch.
-                  Module::commit_datastore();
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERROR << "failed to store datastore datafile!\n";
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          critical_parts.push_back( gamestate.task_thread_pool.checked_push(
-              [&]()
-              {
-                try
-                {
-                  write_party( sc.party );
-                }
-                catch ( ... )
-                {
-                  POLLOG_ERROR << "failed to store party datafile!\n";
-                  Clib::force_backtrace();
-                  result = false;
-                }
-              } ) );
-          for ( auto& task : critical_parts )
-            task.wait();
-
-          critical_promise->set_value( result );  // critical part end
-          // TODO: since promise can only be set one time move it into a method with a dedicated try
-          // block, now when in theory an upper part fails the promise gets never set
-        }  // deconstructor of the SaveContext flushes and joins the queues
-        catch ( std::ios_base::failure& e )
-        {
-          POLLOG_ERROR << "failed to save datafiles! " << e.what() << ":" << std::strerror( errno )
-                       << "\n";
-          Clib::force_backtrace();
-          result = false;
-        }
-        catch ( ... )
-        {
-          POLLOG_ERROR << "failed to save datafiles!\n";
-          Clib::force_backtrace();
-          result = false;
-        }
-        if ( result )
-        {
-          commit( "pol" );
-          commit( "objects" );
-          commit( "pcs" );
-          commit( "pcequip" );
-          commit( "npcs" );
-          commit( "npcequip" );
-          commit( "items" );
-          commit( "multis" );
-          commit( "storage" );
-          commit( "resource" );
-          commit( "guilds" );
-          commit( "datastore" );
-          commit( "parties" );
-        }
-        return true;
-      } );
+  SaveContext::finished = std::async( std::launch::async, write_data_threaded, critical_promise );
   critical_future.wait();  // wait for end of critical part
+  networkManager.polstats.worldsave_stall_ms = timer.ellapsed();
 
-  if ( Plib::systemstate.accounts_txt_dirty )  // write accounts extra, since it uses extra thread
-                                               // for io operations would be to many threads working
-  {
-    Accounts::write_account_data();
-  }
-
-  commit_incremental_saves();
-  objStorageManager.incremental_save_count = 0;
-  timer.stop();
-  objStorageManager.objecthash.ClearDeleted();
-  // optimize_zones(); // shrink zone vectors TODO this takes way to much time!
-
-  // cout << "Clean: " << UObject::clean_writes << " Dirty: " <<
-  // UObject::dirty_writes << endl;
-  clean_writes = UObject::clean_writes;
-  dirty_writes = UObject::dirty_writes;
-  elapsed_ms = timer.ellapsed();
-
-  objStorageManager.incremental_saves_disabled = false;
+  finish_write_data( dirty_writes, clean_writes, elapsed_ms, timer );
   return 0;
 }
 
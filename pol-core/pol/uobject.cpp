@@ -29,6 +29,7 @@
 #include "globals/state.h"
 #include "globals/uvars.h"
 #include "item/itemdesc.h"
+#include "listenpt.h"
 #include "objtype.h"
 #include "polcfg.h"
 #include "proplist.h"
@@ -37,6 +38,7 @@
 #include "syshookscript.h"
 #include "tooltips.h"
 #include "uobjcnt.h"
+#include "uworld.h"
 
 namespace Pol
 {
@@ -81,6 +83,7 @@ UObject::UObject( u32 objtype, UOBJ_CLASS i_uobj_class )
       color( 0 ),
       facing( Core::FACING_N ),
       _rev( 0 ),
+      zone_slot_( 0 ),
       name_( "" ),
       flags_(),
       proplist_( CPropProfiler::class_to_type( i_uobj_class ) )
@@ -167,6 +170,18 @@ void UObject::setprop( const std::string& propname, const std::string& propvalue
   proplist_.setprop( propname, propvalue );  // VOID_RETURN
 }
 
+Bscript::BObjectImp* UObject::getpropimp( const std::string& propname ) const
+{
+  return proplist_.getpropimp( propname );
+}
+
+void UObject::setpropimp( const std::string& propname, const Bscript::BObjectImp& propvalue )
+{
+  if ( propname[0] != '#' )
+    set_dirty();
+  proplist_.setpropimp( propname, propvalue );
+}
+
 void UObject::eraseprop( const std::string& propname )
 {
   if ( propname[0] != '#' )
@@ -246,6 +261,8 @@ const UObject* UObject::toplevel_owner() const
 
 void UObject::setposition( Pos4d newpos )
 {
+  if ( in_zone() && newpos.realm() != nullptr && newpos != pos() )
+    update_zone_position( this, newpos );
   pos( std::move( newpos ) );
 }
 
@@ -566,6 +583,28 @@ void UObject::saveonexit( bool newvalue )
   flags_.change( OBJ_FLAGS::SAVE_ON_EXIT, newvalue );
 }
 
+bool UObject::in_zone() const
+{
+  return flags_.get( OBJ_FLAGS::IN_ZONE );
+}
+
+void UObject::in_zone( bool newvalue )
+{
+  flags_.change( OBJ_FLAGS::IN_ZONE, newvalue );
+  if ( listen_point() )
+    ListenPoint::zone_changed( this );
+}
+
+bool UObject::listen_point() const
+{
+  return flags_.get( OBJ_FLAGS::LISTEN_POINT );
+}
+
+void UObject::listen_point( bool newvalue )
+{
+  flags_.change( OBJ_FLAGS::LISTEN_POINT, newvalue );
+}
+
 const char* UObject::target_tag() const
 {
   return "object";
@@ -21,6 +21,7 @@
 #include <boost/flyweight.hpp>
 #include <iosfwd>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <type_traits>
@@ -67,6 +68,7 @@ class UContainer;
 class WornItemsContainer;
 class ExportScript;
 class UOExecutor;
+struct AOSTooltipCache;
 
 #pragma pack( push, 1 )
 struct Resistances
@@ -140,6 +142,8 @@ enum class OBJ_FLAGS : u16
   CONTENT_TO_GRAVE = 1 << 8,    // UCorpse flag
   NO_DROP = 1 << 9,             // Item flag
   NO_DROP_EXCEPTION = 1 << 10,  // Container/Character flag
+  IN_ZONE = 1 << 11,            // registered in a world zone
+  LISTEN_POINT = 1 << 12,       // has (had) a listen point
 };
 
 /**
@@ -156,6 +160,8 @@ public:
 
   bool getprop( const std::string& propname, std::string& propvalue ) const;
   void setprop( const std::string& propname, const std::string& propvalue );
+  Bscript::BObjectImp* getpropimp( const std::string& propname ) const;
+  void setpropimp( const std::string& propname, const Bscript::BObjectImp& propvalue );
   void eraseprop( const std::string& propname );
   void copyprops( const UObject& obj );
   void copyprops( const PropertyList& proplist );
@@ -195,6 +201,17 @@ public:
   bool saveonexit() const;
   void saveonexit( bool newvalue );
 
+  // set while the object is in the object lists of a world zone (uworld.h)
+  bool in_zone() const;
+  void in_zone( bool newvalue );
+  // index of the object in the object list of its zone, kept by ZoneObjects
+  u32 zone_slot() const;
+  void zone_slot( u32 slot );
+
+  // set once a listen point was registered for the object (listenpt.h)
+  bool listen_point() const;
+  void listen_point( bool newvalue );
+
   virtual void printOn( Clib::StreamWriter& ) const;
   virtual void printSelfOn( Clib::StreamWriter& sw ) const;
 
@@ -303,10 +320,13 @@ public:
   DYN_PROPERTY( luck, ValueModPack, PROP_EXT_STATBAR_LUCK, ValueModPack::DEFAULT );
   DYN_PROPERTY( swing_speed_increase, ValueModPack, PROP_SWING_SPEED_INCREASE,
                 ValueModPack::DEFAULT );
+  // encoded tooltip packets, see SendAOSTooltip
+  DYN_PROPERTY( aos_tooltip_cache, std::shared_ptr<AOSTooltipCache>, PROP_AOS_TOOLTIP, nullptr );
 
 
 private:
   u32 _rev;
+  u32 zone_slot_;
 
 protected:
   boost_utils::object_name_flystring name_;
@@ -328,6 +348,16 @@ inline bool UObject::specific_name() const
   return !name_.get().empty();
 }
 
+inline u32 UObject::zone_slot() const
+{
+  return zone_slot_;
+}
+
+inline void UObject::zone_slot( u32 slot )
+{
+  zone_slot_ = slot;
+}
+
 inline void UObject::set_dirty()
 {
   flags_.set( OBJ_FLAGS::DIRTY );
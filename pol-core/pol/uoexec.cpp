@@ -186,14 +186,9 @@ void UOExecutor::sleep_until_clock( Core::polclock_t sleep_until_clock )
   os_module->sleep_until_clock( sleep_until_clock );
 }
 
-Core::TimeoutHandle UOExecutor::hold_itr() const
+Core::HoldListLink& UOExecutor::hold_link()
 {
-  return os_module->hold_itr();
-}
-
-void UOExecutor::hold_itr( Core::TimeoutHandle hold_itr )
-{
-  os_module->hold_itr( hold_itr );
+  return os_module->hold_link();
 }
 
 Core::HoldListType UOExecutor::in_hold_list() const
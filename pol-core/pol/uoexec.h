@@ -131,8 +131,7 @@ public:
   Core::polclock_t sleep_until_clock() const;
   void sleep_until_clock( Core::polclock_t sleep_until_clock );
 
-  Core::TimeoutHandle hold_itr() const;
-  void hold_itr( Core::TimeoutHandle hold_itr );
+  Core::HoldListLink& hold_link();
 
   Core::HoldListType in_hold_list() const;
   void in_hold_list( Core::HoldListType in_hold_list );
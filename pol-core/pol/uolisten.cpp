@@ -20,6 +20,7 @@
 #include "core.h"
 #include "globals/network.h"
 #include "network/client.h"
+#include "network/clienteventloop.h"
 #include "network/clienttransmit.h"
 #include "network/cliface.h"
 #include "polsem.h"
@@ -120,7 +121,14 @@ void uo_client_listener_thread( void* arg )
     if ( SL.GetConnection( &newsck, timeout, mstimeout ) && newsck.connected() )
     {
       // create an appropriate Client object
-      if ( Plib::systemstate.config.use_single_thread_login )
+      if ( networkManager.clientEventLoop )
+      {
+        // the event loop handles login and game state, no thread of its own needed
+        std::unique_ptr<UoClientThread> thread( new UoClientThread( ls, std::move( newsck ) ) );
+        if ( thread->create() )
+          networkManager.clientEventLoop->add_client( thread->client );
+      }
+      else if ( Plib::systemstate.config.use_single_thread_login )
       {
         std::unique_ptr<UoClientThread> thread( new UoClientThread( ls, std::move( newsck ) ) );
         if ( thread->create() )
@@ -178,6 +186,14 @@ void uo_client_listener_thread( void* arg )
 
 void start_uo_client_listeners( void )
 {
+  if ( Plib::systemstate.config.network_event_loop_threads )
+  {
+    networkManager.clientEventLoop.reset(
+        new Network::ClientEventLoop( Plib::systemstate.config.network_event_loop_threads ) );
+    networkManager.clientEventLoop->start();
+    INFO_PRINT << "Using " << networkManager.clientEventLoop->thread_count()
+               << " network event loop threads for client i/o\n";
+  }
   for ( unsigned i = 0; i < networkManager.uoclient_listeners.size(); ++i )
   {
     UoClientListener* ls = &networkManager.uoclient_listeners[i];
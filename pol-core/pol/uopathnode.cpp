@@ -0,0 +1,168 @@
+/** @file
+ *
+ * @par History
+ * - 2005/09/03 Shinigami: GetSuccessors - added support for non-blocking doors
+ */
+
+
+#include "uopathnode.h"
+
+#include <memory>
+#include <stdlib.h>
+
+#include "../plib/uconst.h"
+#include "globals/settings.h"
+#include "realms/realm.h"
+#include <format/format.h>
+
+namespace Pol
+{
+namespace Core
+{
+bool AStarBlockers::IsBlocking( short x, short y, short z ) const
+{
+  for ( const auto& blockNode : m_List )
+  {
+    if ( ( blockNode.x == x ) && ( blockNode.y == y ) &&
+         ( abs( blockNode.z - z ) < settingsManager.ssopt.default_character_height ) )
+      return true;
+  }
+  return false;
+}
+
+bool UOPathState::IsSameState( const UOPathState& rhs ) const
+{
+  return ( ( rhs.x == x ) && ( rhs.y == y ) && ( rhs.z == z ) && ( rhs.realm == realm ) );
+}
+size_t UOPathState::Hash() const
+{
+  // a search stays inside of one realm
+  return ( static_cast<size_t>( static_cast<u16>( x ) ) << 16 | static_cast<u16>( y ) ) * 257 +
+         static_cast<u8>( z );
+}
+float UOPathState::GoalDistanceEstimate( UOPathState& nodeGoal )
+{
+  return ( (float)( abs( x - nodeGoal.x ) + abs( y - nodeGoal.y ) + abs( z - nodeGoal.z ) ) );
+}
+bool UOPathState::IsGoal( UOPathState& nodeGoal )
+{
+  return ( ( nodeGoal.x == x ) && ( nodeGoal.y == y ) &&
+           ( abs( nodeGoal.z - z ) <= settingsManager.ssopt.default_character_height ) );
+  // return (IsSameState(nodeGoal));
+}
+float UOPathState::GetCost( UOPathState& successor )
+{
+  int xdiff = abs( x - successor.x );
+  int ydiff = abs( y - successor.y );
+  if ( xdiff && ydiff )
+    return 1.414f;
+  else
+    return 1.0f;
+}
+std::string UOPathState::Name()
+{
+  fmt::Writer writer;
+  writer.Format( "({},{},{})" ) << x << y << z;
+  return writer.str();
+}
+bool UOPathState::GetSuccessors( Plib::AStarSearch<UOPathState>* astarsearch,
+                                 UOPathState* /*parent_node*/, bool doors_block )
+{
+  Multi::UMulti* supporting_multi = nullptr;
+  Items::Item* walkon_item = nullptr;
+
+  const UOPathState& SolutionStartNode = *astarsearch->GetSolutionStart();
+  const UOPathState& SolutionEndNode = *astarsearch->GetSolutionEnd();
+  UOPathState NewNode;
+
+  for ( short i = -1; i <= 1; i++ )
+  {
+    for ( short j = -1; j <= 1; j++ )
+    {
+      if ( ( i == 0 ) && ( j == 0 ) )
+        continue;
+
+      short newx = x + i;
+      short newy = y + j;
+      short newz = z;
+
+      if ( ( newx < 0 ) || ( newx < ( theBlockers->xLow ) ) || ( newx > ( theBlockers->xHigh ) ) ||
+           ( newx > ( (int)realm->width() ) ) )
+        continue;
+
+      if ( ( newy < 0 ) || ( newy < ( theBlockers->yLow ) ) || ( ( newy > theBlockers->yHigh ) ) ||
+           ( newy > ( (int)realm->height() ) ) )
+        continue;
+
+      if ( realm->walkheight( newx, newy, z, &newz, &supporting_multi, &walkon_item, doors_block,
+                              Plib::MOVEMODE_LAND ) )
+      {
+        // Forbid diagonal move, if between 2 blockers - OWHorus {2011-04-26)
+        bool blocked = false;
+        if ( ( i != 0 ) && ( j != 0 ) )  // do only for diagonal moves
+        {
+          // If both neighbouring tiles are blocked, the move is illegal (diagonal move)
+          if ( !realm->walkheight( x + i, y, z, &newz, &supporting_multi, &walkon_item, doors_block,
+                                   Plib::MOVEMODE_LAND ) )
+            blocked = !( realm->walkheight( x, y + j, z, &newz, &supporting_multi, &walkon_item,
+                                            doors_block, Plib::MOVEMODE_LAND ) );
+        }
+
+        if ( !blocked )
+        {
+          NewNode.x = newx;
+          NewNode.y = newy;
+          NewNode.z = newz;
+          NewNode.realm = realm;
+          NewNode.theBlockers = theBlockers;
+
+          if ( ( !NewNode.IsSameState( SolutionStartNode ) ) &&
+               ( !NewNode.IsSameState( SolutionEndNode ) ) )
+            blocked = ( theBlockers->IsBlocking( newx, newy, newz ) );
+        }
+
+        if ( !blocked )
+        {
+          if ( !astarsearch->AddSuccessor( NewNode ) )
+            return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+unsigned int find_path( Realms::Realm* realm, const Pos3d& start, const Pos3d& end,
+                        AStarBlockers& blockers, bool doors_block, std::vector<Pos3d>& path )
+{
+  // the node pool is kept per thread, allocating it is more expensive than most searches
+  static thread_local std::unique_ptr<UOSearch> astarsearch;
+  const int max_nodes = static_cast<int>( settingsManager.ssopt.max_pathfind_nodes );
+  if ( !astarsearch || astarsearch->GetMaxNodes() != max_nodes )
+    astarsearch.reset( new UOSearch( max_nodes ) );
+
+  // Create a start state
+  UOPathState nodeStart( start.x(), start.y(), start.z(), realm, &blockers );
+  // Define the goal state
+  UOPathState nodeEnd( end.x(), end.y(), end.z(), realm, &blockers );
+  // Set Start and goal states
+  astarsearch->SetStartAndGoalStates( nodeStart, nodeEnd );
+  unsigned int SearchState;
+  do
+  {
+    SearchState = astarsearch->SearchStep( doors_block );
+  } while ( SearchState == UOSearch::SEARCH_STATE_SEARCHING );
+
+  path.clear();
+  if ( SearchState == UOSearch::SEARCH_STATE_SUCCEEDED )
+  {
+    astarsearch->GetSolutionStart();
+    while ( UOPathState* node = astarsearch->GetSolutionNext() )
+      path.emplace_back( node->x, node->y, static_cast<s8>( node->z ) );
+    astarsearch->FreeSolutionNodes();
+  }
+  return SearchState;
+}
+}  // namespace Core
+}  // namespace Pol
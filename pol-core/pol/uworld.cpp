@@ -32,10 +32,12 @@ void add_item_to_world( Items::Item* item )
 {
   Zone& zone = item->realm()->getzone( item->pos().xy() );
 
-  passert( std::find( zone.items.begin(), zone.items.end(), item ) == zone.items.end() );
+  passert( zone.items.find( item ) == zone.items.end() );
 
   item->realm()->add_toplevel_item( *item );
   zone.items.push_back( item );
+  item->in_zone( true );
+  item->realm()->invalidate_los( item->pos2d() );
 }
 
 void remove_item_from_world( Items::Item* item )
@@ -51,7 +53,7 @@ void remove_item_from_world( Items::Item* item )
 
   Zone& zone = item->realm()->getzone( item->pos().xy() );
 
-  ZoneItems::iterator itr = std::find( zone.items.begin(), zone.items.end(), item );
+  ZoneItems::iterator itr = zone.items.find( item );
   if ( itr == zone.items.end() )
   {
     POLLOG_ERROR.Format(
@@ -64,46 +66,59 @@ void remove_item_from_world( Items::Item* item )
 
   item->realm()->remove_toplevel_item( *item );
   zone.items.erase( itr );
+  item->in_zone( false );
+  item->realm()->invalidate_los( item->pos2d() );
 }
 
 void add_multi_to_world( Multi::UMulti* multi )
 {
   Zone& zone = multi->realm()->getzone( multi->pos().xy() );
   zone.multis.push_back( multi );
+  multi->in_zone( true );
   multi->realm()->add_multi( *multi );
+  multi->realm()->invalidate_los_multis();
 }
 
 void remove_multi_from_world( Multi::UMulti* multi )
 {
   Zone& zone = multi->realm()->getzone( multi->pos().xy() );
-  ZoneMultis::iterator itr = std::find( zone.multis.begin(), zone.multis.end(), multi );
+  ZoneMultis::iterator itr = zone.multis.find( multi );
 
   passert( itr != zone.multis.end() );
 
   multi->realm()->remove_multi( *multi );
   zone.multis.erase( itr );
+  multi->in_zone( false );
+  multi->realm()->invalidate_los_multis();
 }
 
 void move_multi_in_world( unsigned short oldx, unsigned short oldy, unsigned short newx,
                           unsigned short newy, Multi::UMulti* multi, Realms::Realm* oldrealm )
 {
+  Core::Pos2d newpos( newx, newy );
   Zone& oldzone = oldrealm->getzone( Core::Pos2d( oldx, oldy ) );
-  Zone& newzone = multi->realm()->getzone( Core::Pos2d( newx, newy ) );
+  Zone& newzone = multi->realm()->getzone( newpos );
 
+  // the multi is moved before its position is set
+  ZoneMultis::iterator itr = oldzone.multis.find( multi );
   if ( &oldzone != &newzone )
   {
-    ZoneMultis::iterator itr = std::find( oldzone.multis.begin(), oldzone.multis.end(), multi );
     passert( itr != oldzone.multis.end() );
 
     oldzone.multis.erase( itr );
     newzone.multis.push_back( multi );
+    itr = newzone.multis.end() - 1;
   }
+  if ( itr != newzone.multis.end() )
+    newzone.multis.update( itr, newpos );
 
   if ( multi->realm() != oldrealm )
   {
     oldrealm->remove_multi( *multi );
     multi->realm()->add_multi( *multi );
+    oldrealm->invalidate_los_multis();
   }
+  multi->realm()->invalidate_los_multis();
 }
 
 int get_toplevel_item_count()
@@ -131,8 +146,9 @@ void SetCharacterWorldPosition( Mobile::Character* chr, Realms::WorldChangeReaso
 
   auto set_pos = [&]( ZoneCharacters& set )
   {
-    passert( std::find( set.begin(), set.end(), chr ) == set.end() );
+    passert( set.find( chr ) == set.end() );
     set.push_back( chr );
+    chr->in_zone( true );
   };
 
   if ( chr->isa( Core::UOBJ_CLASS::CLASS_NPC ) )
@@ -153,7 +169,7 @@ void ClrCharacterWorldPosition( Mobile::Character* chr, Realms::WorldChangeReaso
 
   auto clear_pos = [&]( ZoneCharacters& set )
   {
-    auto itr = std::find( set.begin(), set.end(), chr );
+    auto itr = set.find( chr );
     if ( itr == set.end() )
     {
       find_missing_char_in_zone(
@@ -162,6 +178,7 @@ void ClrCharacterWorldPosition( Mobile::Character* chr, Realms::WorldChangeReaso
     }
     chr->realm()->remove_mobile( *chr, reason );
     set.erase( itr );
+    chr->in_zone( false );
   };
 
   if ( !chr->isa( Core::UOBJ_CLASS::CLASS_NPC ) )
@@ -178,26 +195,30 @@ void MoveCharacterWorldPosition( const Core::Pos4d& oldpos, Mobile::Character* c
   {
     Zone& oldzone = oldpos.realm()->getzone( oldpos.xy() );
     Zone& newzone = chr->realm()->getzone( chr->pos2d() );
-    if ( &oldzone != &newzone )
+    auto move_pos = [&]( ZoneCharacters& oldset, ZoneCharacters& newset )
     {
-      auto move_pos = [&]( ZoneCharacters& oldset, ZoneCharacters& newset )
+      auto oldset_itr = oldset.find( chr );
+      if ( &oldset == &newset )
       {
-        auto oldset_itr = std::find( oldset.begin(), oldset.end(), chr );
+        // position could have changed more than once since the last move
+        if ( oldset_itr != oldset.end() )
+          oldset.update( oldset_itr, chr->pos2d() );
+        return;
+      }
 
-        // ensure it's found in the old realm
-        passert( oldset_itr != oldset.end() );
-        // and that it's not yet in the new realm
-        passert( std::find( newset.begin(), newset.end(), chr ) == newset.end() );
+      // ensure it's found in the old realm
+      passert( oldset_itr != oldset.end() );
+      // and that it's not yet in the new realm
+      passert( newset.find( chr ) == newset.end() );
 
-        oldset.erase( oldset_itr );
-        newset.push_back( chr );
-      };
+      oldset.erase( oldset_itr );
+      newset.push_back( chr );
+    };
 
-      if ( !chr->isa( Core::UOBJ_CLASS::CLASS_NPC ) )
-        move_pos( oldzone.characters, newzone.characters );
-      else
-        move_pos( oldzone.npcs, newzone.npcs );
-    }
+    if ( !chr->isa( Core::UOBJ_CLASS::CLASS_NPC ) )
+      move_pos( oldzone.characters, newzone.characters );
+    else
+      move_pos( oldzone.npcs, newzone.npcs );
   }
 
   // Regardless of online or not, tell the realms that we've left
@@ -212,10 +233,19 @@ void MoveItemWorldPosition( const Core::Pos4d& oldpos, Items::Item* item )
 {
   Zone& oldzone = oldpos.realm()->getzone( oldpos.xy() );
   Zone& newzone = item->realm()->getzone( item->pos().xy() );
+  oldpos.realm()->invalidate_los( oldpos.xy() );
+  item->realm()->invalidate_los( item->pos2d() );
 
-  if ( &oldzone != &newzone )
+  if ( &oldzone == &newzone )
   {
-    ZoneItems::iterator itr = std::find( oldzone.items.begin(), oldzone.items.end(), item );
+    // position could have changed more than once since the last move
+    ZoneItems::iterator itr = oldzone.items.find( item );
+    if ( itr != oldzone.items.end() )
+      oldzone.items.update( itr, item->pos2d() );
+  }
+  else
+  {
+    ZoneItems::iterator itr = oldzone.items.find( item );
 
     if ( itr == oldzone.items.end() )
     {
@@ -230,7 +260,7 @@ void MoveItemWorldPosition( const Core::Pos4d& oldpos, Items::Item* item )
 
     oldzone.items.erase( itr );
 
-    passert( std::find( newzone.items.begin(), newzone.items.end(), item ) == newzone.items.end() );
+    passert( newzone.items.find( item ) == newzone.items.end() );
     newzone.items.push_back( item );
   }
 
@@ -241,6 +271,41 @@ void MoveItemWorldPosition( const Core::Pos4d& oldpos, Items::Item* item )
   }
 }
 
+void update_zone_position( UObject* obj, const Pos4d& newpos )
+{
+  if ( obj->ismulti() )
+  {
+    obj->realm()->invalidate_los_multis();
+    newpos.realm()->invalidate_los_multis();
+  }
+  else if ( obj->isitem() )
+  {
+    obj->realm()->invalidate_los( obj->pos2d() );
+    newpos.realm()->invalidate_los( newpos.xy() );
+  }
+  if ( newpos.xy() == obj->pos2d() )
+    return;
+
+  // only moves inside of the zone which has the object, changing the zone needs one of the move
+  // functions, which take the current position when moving the object
+  Zone& zone = newpos.realm()->getzone( newpos.xy() );
+  auto update = [&]( auto& list, auto* o )
+  {
+    auto itr = list.find( o );
+    if ( itr != list.end() )
+      list.update( itr, newpos.xy() );
+  };
+
+  if ( obj->ismulti() )
+    update( zone.multis, static_cast<Multi::UMulti*>( obj ) );
+  else if ( obj->isitem() )
+    update( zone.items, static_cast<Items::Item*>( obj ) );
+  else if ( obj->isa( UOBJ_CLASS::CLASS_NPC ) )
+    update( zone.npcs, static_cast<Mobile::Character*>( obj ) );
+  else
+    update( zone.characters, static_cast<Mobile::Character*>( obj ) );
+}
+
 // If the ClrCharacterWorldPosition() fails, this function will find the actual char position and
 // report
 // TODO: check if this is really needed...
@@ -270,13 +335,13 @@ void find_missing_char_in_zone( Mobile::Character* chr, Realms::WorldChangeReaso
     bool found = false;
     if ( is_npc )
     {
-      auto _z = chr->realm()->getzone_grid( p ).npcs;
-      found = std::find( _z.begin(), _z.end(), chr ) != _z.end();
+      const auto& _z = chr->realm()->getzone_grid( p ).npcs;
+      found = _z.find( chr ) != _z.end();
     }
     else
     {
-      auto _z = chr->realm()->getzone_grid( p ).characters;
-      found = std::find( _z.begin(), _z.end(), chr ) != _z.end();
+      const auto& _z = chr->realm()->getzone_grid( p ).characters;
+      found = _z.find( chr ) != _z.end();
     }
     if ( found )
       POLLOG_ERROR.Format( "ClrCharacterWorldPosition: Found mob in zone ({},{})\n" )
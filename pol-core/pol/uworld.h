@@ -52,6 +52,9 @@ void SetCharacterWorldPosition( Mobile::Character* chr, Realms::WorldChangeReaso
 void ClrCharacterWorldPosition( Mobile::Character* chr, Realms::WorldChangeReason reason );
 void MoveCharacterWorldPosition( const Core::Pos4d& oldpos, Mobile::Character* chr );
 
+// keeps the position stored in the zone and the los cache current, called by UObject::setposition
+void update_zone_position( UObject* obj, const Pos4d& newpos );
+
 void SetItemWorldPosition( Items::Item* item );
 void ClrItemWorldPosition( Items::Item* item );
 void MoveItemWorldPosition( const Core::Pos4d& oldpos, Items::Item* item );
@@ -157,13 +160,12 @@ struct CoordsArea
 
   // shifted coords
   Range2d warea;
+  // plain coords
+  Range2d area;
   const Realms::Realm* realm;
 
 private:
   static Pos2d convert( const Pos2d& p );
-
-  // plain coords
-  Range2d area;
 };
 }  // namespace
 ///////////////
@@ -296,79 +298,54 @@ void WorldIterator<Filter>::_forEach( const CoordsArea& coords, F&& f )
 }
 
 // specializations of FilterImp
+// the zones filter on their packed coordinates, only objects in range are dereferenced
 
 template <>
 template <typename F>
 void FilterImp<FilterType::Mobile>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& chr : zone.characters )
-  {
-    if ( coords.inRange( chr ) )
-      f( chr );
-  }
-  for ( auto& npc : zone.npcs )
-  {
-    if ( coords.inRange( npc ) )
-      f( npc );
-  }
+  zone.characters.for_each_in( coords.area, f );
+  zone.npcs.for_each_in( coords.area, f );
 }
 
 template <>
 template <typename F>
 void FilterImp<FilterType::Player>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& chr : zone.characters )
-  {
-    if ( coords.inRange( chr ) )
-      f( chr );
-  }
+  zone.characters.for_each_in( coords.area, f );
 }
 
 template <>
 template <typename F>
 void FilterImp<FilterType::OnlinePlayer>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& chr : zone.characters )
-  {
-    if ( chr->has_active_client() )
-    {
-      if ( coords.inRange( chr ) )
-        f( chr );
-    }
-  }
+  zone.characters.for_each_in( coords.area,
+                               [&]( Mobile::Character* chr )
+                               {
+                                 if ( chr->has_active_client() )
+                                   f( chr );
+                               } );
 }
 
 template <>
 template <typename F>
 void FilterImp<FilterType::NPC>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& npc : zone.npcs )
-  {
-    if ( coords.inRange( npc ) )
-      f( npc );
-  }
+  zone.npcs.for_each_in( coords.area, f );
 }
 
 template <>
 template <typename F>
 void FilterImp<FilterType::Item>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& item : zone.items )
-  {
-    if ( coords.inRange( item ) )
-      f( item );
-  }
+  zone.items.for_each_in( coords.area, f );
 }
 
 template <>
 template <typename F>
 void FilterImp<FilterType::Multi>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& multi : zone.multis )
-  {
-    if ( coords.inRange( multi ) )
-      f( multi );
-  }
+  zone.multis.for_each_in( coords.area, f );
 }
 }  // namespace Core
 }  // namespace Pol
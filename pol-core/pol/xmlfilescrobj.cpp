@@ -109,7 +109,7 @@ Bscript::BObjectImp* BXMLfile::call_method_id( const int id, Executor& ex, bool
                                                   end = attr->contents().end();
                 citr != end; ++citr )
           {
-            const std::string& name = ( *citr ).first;
+            const std::string& name = ( *citr ).first.name();
             Bscript::BObjectImp* ref = ( *citr ).second->impptr();
             if ( ref->isa( Bscript::BObjectImp::OTLong ) )
               elem->SetAttribute( name, static_cast<BLong*>( ref )->value() );
@@ -403,7 +403,7 @@ Bscript::BObjectImp* BXmlNode::call_method_id( const int id, Executor& ex, bool
                                                   end = attr->contents().end();
                 citr != end; ++citr )
           {
-            const std::string& name = ( *citr ).first;
+            const std::string& name = ( *citr ).first.name();
             Bscript::BObjectImp* ref = ( *citr ).second->impptr();
             if ( ref->isa( Bscript::BObjectImp::OTLong ) )
               elem->SetAttribute( name, static_cast<BLong*>( ref )->value() );
@@ -446,7 +446,7 @@ Bscript::BObjectImp* BXmlNode::call_method_id( const int id, Executor& ex, bool
                                               end = attr->contents().end();
             citr != end; ++citr )
       {
-        const std::string& name = ( *citr ).first;
+        const std::string& name = ( *citr ).first.name();
         Bscript::BObjectImp* ref = ( *citr ).second->impptr();
         if ( ref->isa( Bscript::BObjectImp::OTLong ) )
           elem->SetAttribute( name, static_cast<BLong*>( ref )->value() );
@@ -6,9 +6,13 @@
 
 #ifndef ZONE_H
 #define ZONE_H
+#include <algorithm>
+#include <stddef.h>
 #include <vector>
 
+#include "../clib/rawtypes.h"
 #include "base/position.h"
+#include "base/range.h"
 
 namespace Pol
 {
@@ -33,10 +37,51 @@ Pos2d XyToZone( const Pos2d& pos );
 
 typedef unsigned short RegionId;
 
+// Objects of one kind in a world zone.
+// The x/y coordinates are stored packed next to the object pointers (struct of arrays), so a range
+// query only scans the dense coordinates and dereferences just the objects inside the range.
+// Entries keep their insertion order. Each object knows its index (UObject::zone_slot), so find
+// doesn't scan the list; an object is in at most one list at a time. The coordinates are kept
+// current by the world functions (uworld.h) and UObject::setposition.
+template <class T>
+class ZoneObjects
+{
+public:
+  typedef T* value_type;
+  typedef typename std::vector<T*>::size_type size_type;
+  typedef typename std::vector<T*>::const_iterator const_iterator;
+  typedef const_iterator iterator;
+
+  const_iterator begin() const { return _objs.begin(); }
+  const_iterator end() const { return _objs.end(); }
+  size_type size() const { return _objs.size(); }
+  bool empty() const { return _objs.empty(); }
+  T* operator[]( size_type idx ) const { return _objs[idx]; }
+  const_iterator find( const T* obj ) const;
+
+  void push_back( T* obj );
+  void erase( const_iterator itr );
+  void update( const_iterator itr, const Pos2d& pos );
+  void clear();
+  void shrink_to_fit();
+  size_t sizeEstimate() const;
+
+  // calls f for every object whose position is inside of area.
+  // f must not add, remove or move objects of this zone: the hits are collected as indices per
+  // block, which would shift (the plain vector iteration this replaces had the same limit)
+  template <typename F>
+  void for_each_in( const Range2d& area, F&& f ) const;
+
+private:
+  std::vector<u16> _x;
+  std::vector<u16> _y;
+  std::vector<T*> _objs;
+};
+
 // world
-typedef std::vector<Mobile::Character*> ZoneCharacters;
-typedef std::vector<Multi::UMulti*> ZoneMultis;
-typedef std::vector<Items::Item*> ZoneItems;
+typedef ZoneObjects<Mobile::Character> ZoneCharacters;
+typedef ZoneObjects<Multi::UMulti> ZoneMultis;
+typedef ZoneObjects<Items::Item> ZoneItems;
 
 struct Zone
 {
@@ -44,8 +89,98 @@ struct Zone
   ZoneCharacters npcs;
   ZoneItems items;
   ZoneMultis multis;
+  // Realm::_los_generation of the last sight blocking change of the items
+  u64 los_generation = 0;
 };
 
+template <class T>
+typename ZoneObjects<T>::const_iterator ZoneObjects<T>::find( const T* obj ) const
+{
+  size_type idx = obj->zone_slot();
+  if ( idx < _objs.size() && _objs[idx] == obj )
+    return _objs.begin() + idx;
+  return _objs.end();
+}
+
+template <class T>
+void ZoneObjects<T>::push_back( T* obj )
+{
+  obj->zone_slot( static_cast<u32>( _objs.size() ) );
+  _x.push_back( obj->x() );
+  _y.push_back( obj->y() );
+  _objs.push_back( obj );
+}
+
+template <class T>
+void ZoneObjects<T>::erase( const_iterator itr )
+{
+  auto idx = itr - _objs.begin();
+  _x.erase( _x.begin() + idx );
+  _y.erase( _y.begin() + idx );
+  auto next = _objs.erase( itr );
+  for ( ; next != _objs.end(); ++next )
+    ( *next )->zone_slot( ( *next )->zone_slot() - 1 );
+}
+
+template <class T>
+void ZoneObjects<T>::update( const_iterator itr, const Pos2d& pos )
+{
+  auto idx = itr - _objs.begin();
+  _x[idx] = pos.x();
+  _y[idx] = pos.y();
+}
+
+template <class T>
+void ZoneObjects<T>::clear()
+{
+  _x.clear();
+  _y.clear();
+  _objs.clear();
+}
+
+template <class T>
+void ZoneObjects<T>::shrink_to_fit()
+{
+  _x.shrink_to_fit();
+  _y.shrink_to_fit();
+  _objs.shrink_to_fit();
+}
+
+template <class T>
+size_t ZoneObjects<T>::sizeEstimate() const
+{
+  return 3 * 3 * sizeof( void* ) + _x.capacity() * sizeof( u16 ) +
+         _y.capacity() * sizeof( u16 ) + _objs.capacity() * sizeof( T* );
+}
+
+template <class T>
+template <typename F>
+void ZoneObjects<T>::for_each_in( const Range2d& area, F&& f ) const
+{
+  const u16 xl = area.nw().x();
+  const u16 yl = area.nw().y();
+  const u16 xh = area.se().x();
+  const u16 yh = area.se().y();
+  // collect the hits of a block first, the compare loop has no branches and no calls so the
+  // compiler can vectorize it
+  const size_t BLOCK = 64;
+  u8 hits[BLOCK];
+  for ( size_t base = 0; base < _objs.size(); base += BLOCK )
+  {
+    const size_t count = std::min( BLOCK, _objs.size() - base );
+    const u16* xs = _x.data() + base;
+    const u16* ys = _y.data() + base;
+    size_t nhits = 0;
+    for ( size_t i = 0; i < count; ++i )
+    {
+      hits[nhits] = static_cast<u8>( i );
+      nhits += ( xs[i] >= xl ) & ( xs[i] <= xh ) & ( ys[i] >= yl ) & ( ys[i] <= yh );
+    }
+    for ( size_t i = 0; i < nhits; ++i )
+      f( _objs[base + hits[i]] );
+  }
+}
+
 }  // namespace Core
 }  // namespace Pol
 #endif
@@ -4,6 +4,7 @@
 #include <string>
 
 #include "../clib/Program/ProgramMain.h"
+#include "../clib/cfgsnapshot.h"
 #include "../clib/clib_endian.h"
 #include "../clib/fileutil.h"
 #include "../clib/logfacility.h"
@@ -43,6 +44,9 @@ void PolToolMain::showHelp()
               << "  POLTOOL uncompressgump FileName\n"
               << "        unpacks and prints 0xDD gump from given packet log\n"
               << "        file needs to contain a single 0xDD packetlog\n"
+              << "  POLTOOL snapshot2text infile.bin outfile.txt\n"
+              << "  POLTOOL text2snapshot infile.txt outfile.bin\n"
+              << "        converts world data files between text and binary snapshot format\n"
 
               << "  POLTOOL testfiles [options]\n"
               << "        Options:\n"
@@ -254,6 +258,39 @@ int PolToolMain::unpackCompressedGump()
   return 0;
 }
 
+int PolToolMain::convertSnapshot( bool to_text )
+{
+  const std::vector<std::string>& binArgs = programArgs();
+  if ( binArgs.size() < 4 )
+  {
+    showHelp();
+    return 1;
+  }
+  if ( !Clib::FileExists( binArgs[2] ) )
+  {
+    ERROR_PRINT << "File " << binArgs[2] << " not found\n";
+    return 1;
+  }
+  if ( to_text != SnapshotReader::is_snapshot( binArgs[2] ) )
+  {
+    ERROR_PRINT << binArgs[2] << " is " << ( to_text ? "not" : "already" )
+                << " a binary snapshot\n";
+    return 1;
+  }
+  try
+  {
+    size_t count = to_text ? convert_snapshot_to_text( binArgs[2], binArgs[3] )
+                           : convert_text_to_snapshot( binArgs[2], binArgs[3] );
+    INFO_PRINT << "Converted " << count << " elements to " << binArgs[3] << "\n";
+  }
+  catch ( std::exception& ex )
+  {
+    ERROR_PRINT << "Conversion failed: " << ex.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
+
 int PolToolMain::main()
 {
   const std::vector<std::string>& binArgs = programArgs();
@@ -278,6 +315,14 @@ int PolToolMain::main()
   {
     return unpackCompressedGump();
   }
+  else if ( binArgs[1] == "snapshot2text" )
+  {
+    return convertSnapshot( true );
+  }
+  else if ( binArgs[1] == "text2snapshot" )
+  {
+    return convertSnapshot( false );
+  }
   else if ( binArgs[1] == "testfiles" )
   {
     std::string outdir = programArgsFindEquals( "outdir=", "." );
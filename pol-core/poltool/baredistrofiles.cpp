@@ -526,6 +526,14 @@ void BareDistro::distro_files( std::map<fs::path, std::vector<std::string>>& dis
 "#",
 "MaxPathFindRange=50",
 "",
+"#",
+"# MaxPathFindNodes",
+"# This will define the maximum number of nodes a single pathfinding search may use.",
+"# If the search needs more, an error result will be returned with \"Out of memory.\"",
+"# as the errortext. Default value for this is 1000.",
+"#",
+"MaxPathFindNodes=1000",
+"",
 "#UseWinLFH=0|1",
 "# Use Windows XP/2003 low-fragmentation Heap?",
 "# Default is 0",
@@ -1,5 +1,6 @@
 set (runecl_sources  # sorted !
   ../pol/binaryfilescrobj.cpp 
+  ../pol/cfgcache.cpp 
   ../pol/cfgrepos.cpp 
   ../pol/dice.cpp
   ../pol/globals/ucfg.cpp
@@ -64,7 +64,8 @@ void RunEclMain::showHelp()
               << "        Options:\n"
               << "            -q    Quiet\n"
               << "            -d    Debug output\n"
-              << "            -p    Profile\n";
+              << "            -p    Profile\n"
+              << "            -r    Reference interpreter (no superinstructions)\n";
   // TODO: what about "-v" and "-a"?
 }
 
@@ -212,6 +213,8 @@ int RunEclMain::runecl()
       case 'Q':
       case 'p':
       case 'P':
+      case 'r':
+      case 'R':
         break;
       default:
         ERROR_PRINT << "Unknown option: " << binArgs[i] << "\n";
@@ -231,6 +234,7 @@ int RunEclMain::main()
 
   const std::vector<std::string>& binArgs = programArgs();
   Pol::Bscript::escript_config.max_call_depth = 100;
+  Pol::Bscript::escript_config.threaded_code = !programArgsFind( "r" );
   m_quiet = programArgsFind( "q" );
   m_debug = programArgsFind( "d" );
   m_profile = programArgsFind( "p" );
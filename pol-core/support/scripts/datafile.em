@@ -23,6 +23,14 @@ UnloadDataFile( filespec );
 //  datafile.CreateElement( key : string|integer ) : elemref
 //  datafile.DeleteElement( key : string|integer );
 //  datafile.Keys() : array of (string|integer)
+//  datafile.FindElements( keys : array ) : dictionary key -> elemref, missing keys are left out
+//  datafile.ElementsInRange( first, last, limit := 0 ) : dictionary key -> elemref
+//  datafile.ElementsWithPrefix( prefix : string, limit := 0 ) : dictionary key -> elemref
+//  datafile.GetProps( keys : array, propname : string ) : dictionary key -> value
+//  datafile.SetProps( propname : string, values : dictionary key -> value ) : count
+//  datafile.CreateIndex( propname : string );
+//  datafile.DeleteIndex( propname : string );
+//  datafile.FindByIndex( propname : string, value, limit := 0 ) : dictionary key -> elemref
 
 // Object: DataFileElement elem;
 // DataFileElement methods:
@@ -76,6 +76,14 @@ Start_Skill_Script( chr, attr_name, script_name := "", param := 0 );
 Run_Script_To_Completion( script_name, param := 0 );
 Run_Script( script_name, param := 0 );
 
+    //
+    // start_detached_script: runs a script using only the basic, math and util modules
+    //                        on a worker thread, the result is sent as event
+    //                        struct{ type := "detached", id, script, value }
+    //                        returns the id of the event
+    //
+Start_Detached_Script( script_name, param := 0 );
+
 
     //
     // syslog(text): write text to the console, and to the log file
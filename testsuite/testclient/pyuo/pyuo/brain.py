@@ -191,6 +191,7 @@ class Event:
   EVT_NEW_SUBSERVER = 10
   EVT_BOAT_MOVED = 11
   EVT_OWNCREATE = 12
+  EVT_TOOLTIP = 13
 
   EVT_EXIT = 100
   EVT_LIST_OBJS = 101
@@ -245,4 +246,6 @@ class Event:
       return "boat_moved"
     elif self.type==Event.EVT_OWNCREATE:
       return "owncreate"
+    elif self.type==Event.EVT_TOOLTIP:
+      return "tooltip"
 
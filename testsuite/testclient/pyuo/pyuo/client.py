@@ -873,6 +873,9 @@ class Client(threading.Thread):
       self.log.info('Ignoring new subserver packet')
     elif isinstance(pkt, packets.SmoothBoatPacket):
       self.handleSmoothBoatPacket(pkt)
+    elif isinstance(pkt, packets.MegaClilocPacket):
+      self.brain.event(brain.Event(brain.Event.EVT_TOOLTIP, serial=pkt.serial,
+          revision=pkt.revision, entries=pkt.entries))
 
     else:
       self.log.warn("Unhandled packet {}".format(pkt.__class__))
@@ -1115,6 +1118,13 @@ class Client(threading.Thread):
     po.fill(obj if type(obj) == int else obj.serial)
     self.queue(po)
 
+  @logincomplete
+  def requestTooltip(self, obj):
+    ''' Requests the tooltip of the given object (Item/Mobile or serial) '''
+    po = packets.MegaClilocPacket()
+    po.fill(obj if type(obj) == int else obj.serial)
+    self.queue(po)
+
   @logincomplete
   def doubleClick(self, obj):
     ''' Sends a single click for the given object (Item/Mobile or serial) to server '''
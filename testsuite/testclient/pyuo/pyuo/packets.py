@@ -1392,6 +1392,37 @@ class ClilocMsgPacket(Packet):
     self.unicode_string = self.rpb(self.length-48)
 
 
+class MegaClilocPacket(Packet):
+  ''' Requests or receives the tooltip (mega cliloc) of an object '''
+
+  cmd = 0xd6
+
+  def fill(self, serial):
+    '''!
+    @param serial int: The object serial
+    '''
+    self.serial = serial
+    self.length = 1 + 2 + 4
+
+  def encodeChild(self):
+    self.eulen()
+    self.euint(self.serial)
+
+  def decodeChild(self):
+    self.length = self.dushort()
+    self.dushort() # Always 1
+    self.serial = self.duint()
+    self.dushort() # Unknown
+    self.revision = self.duint()
+    self.entries = []
+    while True:
+      cliloc = self.duint()
+      if not cliloc:
+        break
+      tlen = self.dushort()
+      self.entries.append((cliloc, self.rpb(tlen).decode('utf_16_le')))
+
+
 class MegaClilocRevPacket(Packet):
   ''' SE Introduced Revision '''
 
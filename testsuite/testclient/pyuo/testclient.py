@@ -94,6 +94,8 @@ class TestBrain(brain.Brain):
             res = res is not None))
       elif todo=="disable_item_logging":
         self.client.addTodo(brain.Event(brain.Event.EVT_DISABLE_ITEM_LOGGING, value = arg))
+      elif todo=="tooltip":
+        self.client.requestTooltip(arg)
 
     return True
 
@@ -253,6 +255,10 @@ class PolServer:
       res["pos"]=[ev.boat.x, ev.boat.y, ev.boat.z]
     elif ev.type==Event.EVT_OWNCREATE:
       pass
+    elif ev.type==Event.EVT_TOOLTIP:
+      res["serial"]=ev.serial
+      res["revision"]=ev.revision
+      res["text"]=[text for _,text in ev.entries]
     else:
       raise NotImplementedError("Unknown event {}",format(ev.type))
 